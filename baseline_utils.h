@@ -0,0 +1,83 @@
+#ifndef BASELINE_UTILS_H
+#define BASELINE_UTILS_H
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h> // Para gethostname()
+#include "csv_utils.h"
+#include "oetsort.h"
+
+/*
+ * Cache de linha de base serial.
+ *
+ * As versões OpenMP, MPI e híbrida medem a ordenação serial, O(n²), em toda execução só
+ * para calcular o speedup; em uma varredura de threads ou processos a mesma medição é
+ * repetida a cada execução (no MPI, com os demais processos parados no MPI_Bcast). O
+ * tempo medido é guardado em BASELINE_CACHE_PATH e reaproveitado pelas execuções
+ * seguintes com a mesma chave:
+ *   - máquina (hostname) e compilação da biblioteca (oetsort_build_id);
+ *   - kernel de compare-exchange e variante da linha de base ("odd-even",
+ *     "odd-even-adaptativo" ou "qsort");
+ *   - tamanho e todos os parâmetros da entrada gerada (distribuição, semente, ...).
+ * Sem entrada para a chave, ou com --medir-serial, a linha de base é medida e gravada.
+ * Se houver mais de uma linha para a mesma chave, vale a última.
+ */
+
+#define BASELINE_CACHE_PATH "data/linha_de_base.csv"
+
+/**
+ * @brief Monta as colunas da chave, separadas por vírgula e terminadas por vírgula.
+ */
+static inline void baseline_key(char *out, size_t size, const char *variant, int n, const oetsort_input *input) {
+    char host[64] = "desconhecido";
+    gethostname(host, sizeof(host) - 1);
+    host[strcspn(host, ",")] = '\0';
+    snprintf(out, size, "%s,%s,%s,%s,%d,%s,%llu,%d,%lld,%d,%g,", host, oetsort_build_id(), oetsort_kernel_name(), variant, n,
+             oetsort_distribution_name(input->dist), (unsigned long long)input->seed, input->max_val, input->displacements,
+             input->unique, input->zipf_s);
+}
+
+/**
+ * @brief Procura o tempo serial da chave no cache.
+ *
+ * @return int 1 se encontrou (o tempo vai para 't_serial'), 0 caso contrário.
+ */
+static inline int baseline_lookup(const char *variant, int n, const oetsort_input *input, double *t_serial) {
+    FILE *fp = fopen(BASELINE_CACHE_PATH, "r");
+    if (fp == NULL) return 0;
+    char key[512], line[640];
+    baseline_key(key, sizeof(key), variant, n, input);
+    size_t len = strlen(key);
+    int found = 0;
+    while (fgets(line, sizeof(line), fp) != NULL) {
+        double t;
+        if (strncmp(line, key, len) == 0 && sscanf(line + len, "%lf", &t) == 1) {
+            *t_serial = t;
+            found = 1;
+        }
+    }
+    fclose(fp);
+    return found;
+}
+
+/**
+ * @brief Anexa o tempo serial medido ao cache.
+ */
+static inline void baseline_store(const char *variant, int n, const oetsort_input *input, double t_serial) {
+    ensure_dir_exists(BASELINE_CACHE_PATH);
+    int needs_header = !file_exists(BASELINE_CACHE_PATH);
+    FILE *fp = fopen(BASELINE_CACHE_PATH, "a");
+    if (fp == NULL) {
+        perror("Falha ao abrir o cache de linha de base");
+        return;
+    }
+    if (needs_header) {
+        fprintf(fp, "Host,Build,Kernel,Variante,Tamanho,Distribuicao,Semente,MaxValor,Deslocamentos,Unicos,Zipf,Tempo(s)\n");
+    }
+    char key[512];
+    baseline_key(key, sizeof(key), variant, n, input);
+    fprintf(fp, "%s%.6f\n", key, t_serial);
+    fclose(fp);
+}
+
+#endif // BASELINE_UTILS_H
@@ -0,0 +1,283 @@
+#ifndef BENCH_UTILS_H
+#define BENCH_UTILS_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "csv_utils.h" // Para file_exists() e ensure_dir_exists()
+#include "oetsort.h"   // Para oetsort_counters
+
+/*
+ * Estatísticas e saída do benchmark (odd_even_bench).
+ *
+ * Cada configuração é medida várias vezes sobre a mesma entrada; os tempos são
+ * resumidos por estatísticas robustas (mediana, mínimo, percentil 95) e por um
+ * intervalo de confiança de 95% para a mediana. O intervalo usa estatísticas de
+ * ordem (não supõe distribuição normal, o que não vale para tempos de execução):
+ * com m amostras ordenadas, os limites são as amostras de posição
+ * floor((m - 1.96 sqrt(m)) / 2) e ceil(1 + (m + 1.96 sqrt(m)) / 2). Com poucas
+ * amostras o intervalo se reduz a [mínimo, máximo].
+ */
+
+// Resumo de uma série de tempos, em segundos.
+typedef struct {
+    int count;
+    double median;
+    double min;
+    double max;
+    double mean;
+    double stddev;
+    double p95;
+    double ci_low;   // Limite inferior do IC de 95% da mediana.
+    double ci_high;  // Limite superior do IC de 95% da mediana.
+} bench_stats;
+
+// Resultado de uma configuração do benchmark. As colunas de save_bench_csv contêm
+// as de todos os CSVs de csv_utils.h (Versao, Tamanho, Threads, Processos, Workers,
+// Schedule, Tempo(s), tempos de computação e comunicação, Speedup, Eficiencia).
+typedef struct {
+    const char *version;  // "serial", "openmp", "mpi" ou "hibrido".
+    const char *backend;  // Nome do backend na biblioteca (ex: "openmp-static").
+    const char *variant;  // Schedule (OpenMP) ou modo (MPI); "-" quando não se aplica; com chaves
+                          // compactadas, "compactado-8" ou "compactado-16".
+    const char *distribution;  // Distribuição da entrada (ex: "uniforme").
+    unsigned long long seed;   // Semente da entrada.
+    int n;
+    int processes;
+    int threads;          // Threads por processo.
+    int workers;          // processes * threads.
+    int tile;             // Tamanho do tile (0 se o backend não usa ladrilhamento).
+    bench_stats stats;
+    double comm_time_sum;         // Mediana da soma do tempo de comunicação dos processos.
+    double computation_time_sum;  // Mediana da soma do tempo de computação dos processos.
+    double speedup;               // Mediana serial / mediana desta configuração.
+    double efficiency;            // speedup / workers.
+    int sorted;                   // Todas as repetições medidas terminaram ordenadas.
+    int same_keys;                // E com a impressão digital da entrada (oetsort_verify).
+    double *samples;              // Tempos de cada repetição, em ordem crescente.
+    oetsort_counters *counters;   // Média por repetição dos contadores de cada worker, na ordem
+                                  // (processo, thread); NULL se a biblioteca não tem contadores.
+    int num_counters;             // processes * threads quando 'counters' não é NULL.
+} bench_result;
+
+/**
+ * @brief Função de comparação de doubles no formato exigido pelo qsort.
+ */
+static inline int compare_doubles(const void *a, const void *b) {
+    double x = *(const double *)a;
+    double y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Percentil 'p' (entre 0 e 1) de amostras já ordenadas, com interpolação linear.
+ */
+static inline double sorted_percentile(const double sorted[], int count, double p) {
+    double pos = p * (count - 1);
+    int lo = (int)pos;
+    if (lo >= count - 1) return sorted[count - 1];
+    return sorted[lo] + (pos - lo) * (sorted[lo + 1] - sorted[lo]);
+}
+
+/**
+ * @brief Calcula o resumo de uma série de tempos. As amostras são ordenadas no lugar.
+ *
+ * @param samples Os tempos medidos (count >= 1).
+ * @param count O número de amostras.
+ * @param s O resumo calculado.
+ */
+static inline void compute_bench_stats(double samples[], int count, bench_stats *s) {
+    qsort(samples, count, sizeof(double), compare_doubles);
+
+    double sum = 0.0;
+    for (int i = 0; i < count; i++) sum += samples[i];
+    double mean = sum / count;
+    double sq = 0.0;
+    for (int i = 0; i < count; i++) sq += (samples[i] - mean) * (samples[i] - mean);
+
+    s->count = count;
+    s->min = samples[0];
+    s->max = samples[count - 1];
+    s->mean = mean;
+    s->stddev = (count > 1) ? sqrt(sq / (count - 1)) : 0.0;
+    s->median = sorted_percentile(samples, count, 0.5);
+    s->p95 = sorted_percentile(samples, count, 0.95);
+
+    // Posições (a partir de 1) das estatísticas de ordem que limitam o IC da mediana.
+    double half_width = 1.96 * sqrt((double)count);
+    int lo = (int)floor((count - half_width) / 2.0);
+    int hi = (int)ceil(1.0 + (count + half_width) / 2.0);
+    if (lo < 1) lo = 1;
+    if (hi > count) hi = count;
+    s->ci_low = samples[lo - 1];
+    s->ci_high = samples[hi - 1];
+}
+
+/**
+ * @brief Soma os contadores de uma repetição em 'acc'. Um evento de hardware indisponível
+ * (-1) em qualquer repetição fica indisponível no acumulado.
+ */
+static inline void accumulate_counters(oetsort_counters acc[], const oetsort_counters c[], int count) {
+    for (int i = 0; i < count; i++) {
+        long long *a[] = {&acc[i].cycles, &acc[i].instructions, &acc[i].llc_misses, &acc[i].branch_misses};
+        const long long v[] = {c[i].cycles, c[i].instructions, c[i].llc_misses, c[i].branch_misses};
+        acc[i].swaps += c[i].swaps;
+        acc[i].wait_time += c[i].wait_time;
+        for (int e = 0; e < 4; e++) {
+            *a[e] = (*a[e] < 0 || v[e] < 0) ? -1 : *a[e] + v[e];
+        }
+    }
+}
+
+/**
+ * @brief Divide os contadores acumulados pelo número de repetições.
+ */
+static inline void average_counters(oetsort_counters acc[], int count, int reps) {
+    for (int i = 0; i < count; i++) {
+        acc[i].swaps /= reps;
+        acc[i].wait_time /= reps;
+        if (acc[i].cycles >= 0) acc[i].cycles /= reps;
+        if (acc[i].instructions >= 0) acc[i].instructions /= reps;
+        if (acc[i].llc_misses >= 0) acc[i].llc_misses /= reps;
+        if (acc[i].branch_misses >= 0) acc[i].branch_misses /= reps;
+    }
+}
+
+/**
+ * @brief Resumo dos contadores de todos os workers: trocas somadas, maior espera e IPC
+ * (instruções / ciclos somados, -1 se indisponível).
+ */
+static inline void summarize_counters(const bench_result *r, long long *swaps, double *max_wait, double *ipc) {
+    long long cycles = 0, instructions = 0;
+    *swaps = 0;
+    *max_wait = 0.0;
+    for (int i = 0; i < r->num_counters; i++) {
+        const oetsort_counters *c = &r->counters[i];
+        *swaps += c->swaps;
+        if (c->wait_time > *max_wait) *max_wait = c->wait_time;
+        cycles = (cycles < 0 || c->cycles < 0) ? -1 : cycles + c->cycles;
+        instructions = (instructions < 0 || c->instructions < 0) ? -1 : instructions + c->instructions;
+    }
+    *ipc = (cycles > 0 && instructions >= 0) ? (double)instructions / cycles : -1.0;
+}
+
+/**
+ * @brief Anexa os contadores de uma configuração a um arquivo CSV, uma linha por worker
+ * (processo e thread). Eventos de hardware indisponíveis aparecem como -1.
+ *
+ * @param filepath Caminho para o arquivo CSV (ex: "data/contadores.csv").
+ * @param r O resultado da configuração, com 'counters' preenchido.
+ * @param kernel Kernel de compare-exchange em uso.
+ */
+static inline void save_counters_csv(const char *filepath, const bench_result *r, const char *kernel) {
+    ensure_dir_exists(filepath);
+    int needs_header = !file_exists(filepath);
+    FILE *fp = fopen(filepath, "a");
+    if (fp == NULL) {
+        perror("Falha ao abrir CSV para anexar dados");
+        return;
+    }
+    if (needs_header) {
+        fprintf(fp, "Versao,Backend,Schedule,Distribuicao,Semente,Tamanho,Processos,Threads,Kernel,Processo,Thread,"
+                    "Trocas,Espera(s),Ciclos,Instrucoes,FalhasLLC,FalhasDesvio\n");
+    }
+    for (int i = 0; i < r->num_counters; i++) {
+        const oetsort_counters *c = &r->counters[i];
+        fprintf(fp, "%s,%s,%s,%s,%llu,%d,%d,%d,%s,%d,%d,%lld,%.6f,%lld,%lld,%lld,%lld\n",
+                r->version, r->backend, r->variant, r->distribution, r->seed, r->n, r->processes, r->threads, kernel,
+                i / r->threads, i % r->threads, c->swaps, c->wait_time, c->cycles, c->instructions, c->llc_misses, c->branch_misses);
+    }
+    fclose(fp);
+}
+
+/**
+ * @brief Anexa o resultado de uma configuração do benchmark a um arquivo CSV.
+ * Tempo(s) é a mediana das repetições, para que o arquivo possa substituir os
+ * CSVs de médias nos gráficos.
+ *
+ * @param filepath Caminho para o arquivo CSV (ex: "data/bench.csv").
+ * @param r O resultado da configuração.
+ * @param kernel Kernel de compare-exchange em uso.
+ * @param warmups Número de execuções de aquecimento descartadas.
+ */
+static inline void save_bench_csv(const char *filepath, const bench_result *r, const char *kernel, int warmups) {
+    ensure_dir_exists(filepath);
+    FILE *fp;
+    int needs_header = !file_exists(filepath);
+
+    fp = fopen(filepath, "a");
+    if (fp == NULL) {
+        perror("Falha ao abrir CSV para anexar dados");
+        return;
+    }
+
+    if (needs_header) {
+        fprintf(fp, "Versao,Backend,Schedule,Distribuicao,Semente,Tamanho,Processos,Threads,Workers,Tile,Kernel,Aquecimento,Repeticoes,"
+                    "Tempo(s),Minimo(s),Maximo(s),Media(s),Desvio(s),P95(s),IC95Inf(s),IC95Sup(s),"
+                    "TempoComputacao(soma),TempoComunicacao(soma),Speedup,Eficiencia,Ordenado,Permutacao\n");
+    }
+
+    const bench_stats *s = &r->stats;
+    fprintf(fp, "%s,%s,%s,%s,%llu,%d,%d,%d,%d,%d,%s,%d,%d,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f,%.4f,%.4f,%d,%d\n",
+            r->version, r->backend, r->variant, r->distribution, r->seed, r->n, r->processes, r->threads, r->workers, r->tile, kernel, warmups, s->count,
+            s->median, s->min, s->max, s->mean, s->stddev, s->p95, s->ci_low, s->ci_high,
+            r->computation_time_sum, r->comm_time_sum, r->speedup, r->efficiency, r->sorted, r->same_keys);
+    fclose(fp);
+}
+
+/**
+ * @brief Grava todos os resultados de uma execução do benchmark em um arquivo JSON
+ * (sobrescrito a cada execução), incluindo os tempos de cada repetição e, se a
+ * biblioteca tiver contadores, os de cada worker.
+ *
+ * @param filepath Caminho para o arquivo JSON (ex: "data/bench.json").
+ * @param results Os resultados, na ordem em que foram medidos.
+ * @param count O número de resultados.
+ * @param kernel Kernel de compare-exchange em uso.
+ * @param warmups Número de execuções de aquecimento descartadas.
+ */
+static inline void save_bench_json(const char *filepath, const bench_result results[], int count, const char *kernel, int warmups) {
+    ensure_dir_exists(filepath);
+    FILE *fp = fopen(filepath, "w");
+    if (fp == NULL) {
+        perror("Falha ao abrir o arquivo JSON");
+        return;
+    }
+
+    fprintf(fp, "{\n  \"kernel\": \"%s\",\n  \"aquecimento\": %d,\n  \"resultados\": [", kernel, warmups);
+    for (int i = 0; i < count; i++) {
+        const bench_result *r = &results[i];
+        const bench_stats *s = &r->stats;
+        fprintf(fp, "%s\n    {\"versao\": \"%s\", \"backend\": \"%s\", \"schedule\": \"%s\", "
+                    "\"distribuicao\": \"%s\", \"semente\": %llu, \"tamanho\": %d, \"processos\": %d, \"threads\": %d, \"workers\": %d, \"tile\": %d, \"repeticoes\": %d,\n",
+                i > 0 ? "," : "", r->version, r->backend, r->variant, r->distribution, r->seed, r->n, r->processes, r->threads, r->workers, r->tile, s->count);
+        fprintf(fp, "     \"tempo\": {\"mediana\": %.9f, \"minimo\": %.9f, \"maximo\": %.9f, \"media\": %.9f, "
+                    "\"desvio\": %.9f, \"p95\": %.9f, \"ic95\": [%.9f, %.9f]},\n",
+                s->median, s->min, s->max, s->mean, s->stddev, s->p95, s->ci_low, s->ci_high);
+        fprintf(fp, "     \"tempo_computacao_soma\": %.9f, \"tempo_comunicacao_soma\": %.9f, "
+                    "\"speedup\": %.6f, \"eficiencia\": %.6f, \"ordenado\": %s, \"permutacao\": %s,\n",
+                r->computation_time_sum, r->comm_time_sum, r->speedup, r->efficiency, r->sorted ? "true" : "false",
+                r->same_keys ? "true" : "false");
+        fprintf(fp, "     \"amostras\": [");
+        for (int j = 0; j < s->count; j++) {
+            fprintf(fp, "%s%.9f", j > 0 ? ", " : "", r->samples[j]);
+        }
+        fprintf(fp, "]");
+        if (r->counters != NULL) {
+            fprintf(fp, ",\n     \"contadores\": [");
+            for (int j = 0; j < r->num_counters; j++) {
+                const oetsort_counters *c = &r->counters[j];
+                fprintf(fp, "%s\n       {\"processo\": %d, \"thread\": %d, \"trocas\": %lld, \"espera\": %.9f, \"ciclos\": %lld, "
+                            "\"instrucoes\": %lld, \"falhas_llc\": %lld, \"falhas_desvio\": %lld}",
+                        j > 0 ? "," : "", j / r->threads, j % r->threads, c->swaps, c->wait_time, c->cycles, c->instructions,
+                        c->llc_misses, c->branch_misses);
+            }
+            fprintf(fp, "]");
+        }
+        fprintf(fp, "}");
+    }
+    fprintf(fp, "\n  ]\n}\n");
+    fclose(fp);
+}
+
+#endif // BENCH_UTILS_H
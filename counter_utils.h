@@ -0,0 +1,148 @@
+#ifndef COUNTER_UTILS_H
+#define COUNTER_UTILS_H
+
+/*
+ * Contadores de caminho quente por thread e por processo (make CONTADORES=1).
+ *
+ * Com OETSORT_WITH_COUNTERS definido, cada ordenação de oetsort_sort registra, para
+ * cada thread (backends OpenMP, pool de pthreads e híbrido) ou para o processo (seriais e MPI):
+ *   - trocas: pares trocados nos compare-exchange das fases (os kernels passam a
+ *     contar as lanes alteradas, ver simd_utils.h) e nas trocas de fronteira do MPI;
+ *   - espera: tempo parado nas barreiras de fase (ou esperando as vizinhas, no
+ *     backend neighbor) e, no processo MPI, na comunicação (o mesmo comm_time);
+ *   - eventos de hardware de perf_event_open, contados apenas na própria thread:
+ *     ciclos, instruções, falhas de cache de último nível e erros de previsão de
+ *     desvio. Se o kernel não permitir (perf_event_paranoid, máquina virtual sem
+ *     PMU), ficam em -1.
+ * Cada thread escreve apenas no seu slot, alinhado à linha de cache.
+ *
+ * Sem a flag, todas as macros abaixo se reduzem a nada (COUNTERS_BARRIER, à barreira
+ * do OpenMP) e a biblioteca é idêntica à compilada sem a instrumentação.
+ */
+
+#ifdef OETSORT_WITH_COUNTERS
+// Requer _GNU_SOURCE definido antes dos includes (syscall, pool_utils.h).
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#include "pool_utils.h"
+#include "oetsort.h"
+
+// Threads registradas por ordenação (as demais dividem o último slot).
+#define COUNTERS_MAX_THREADS 256
+#define COUNTERS_NUM_EVENTS 4
+
+typedef struct {
+    oetsort_counters c;
+    int fds[COUNTERS_NUM_EVENTS]; // Grupo de perf_event_open; fds[0] é o líder.
+    int used;
+} __attribute__((aligned(64))) counters_slot;
+
+static counters_slot counters_slots[COUNTERS_MAX_THREADS];
+
+static inline double counters_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static inline counters_slot *counters_self(void) {
+    int t = pool_thread_num();
+    return &counters_slots[t < COUNTERS_MAX_THREADS ? t : COUNTERS_MAX_THREADS - 1];
+}
+
+// Zera todos os slots antes de uma ordenação.
+static inline void counters_reset(void) {
+    memset(counters_slots, 0, sizeof(counters_slots));
+}
+
+// Abre um evento de hardware da thread chamadora, em qualquer CPU, no grupo de 'group'.
+static inline int counters_open_event(unsigned long long config, int group) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = config;
+    attr.disabled = (group == -1); // O grupo é ligado de uma vez pelo líder.
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP;
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, group, 0);
+}
+
+// Início da participação da thread chamadora: marca o slot como usado e liga os eventos.
+static inline void counters_thread_begin(void) {
+    static const unsigned long long events[COUNTERS_NUM_EVENTS] = {
+        PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES
+    };
+    counters_slot *s = counters_self();
+    s->used = 1;
+    s->fds[0] = counters_open_event(events[0], -1);
+    for (int e = 1; e < COUNTERS_NUM_EVENTS; e++) {
+        s->fds[e] = (s->fds[0] >= 0) ? counters_open_event(events[e], s->fds[0]) : -1;
+    }
+    if (s->fds[0] >= 0) {
+        ioctl(s->fds[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(s->fds[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+}
+
+// Fim da participação: desliga e lê o grupo (eventos que não abriram ficam em -1).
+static inline void counters_thread_end(void) {
+    counters_slot *s = counters_self();
+    long long *out[COUNTERS_NUM_EVENTS] = {&s->c.cycles, &s->c.instructions, &s->c.llc_misses, &s->c.branch_misses};
+    unsigned long long values[1 + COUNTERS_NUM_EVENTS] = {0};
+    int ok = 0;
+    if (s->fds[0] >= 0) {
+        ioctl(s->fds[0], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+        ok = read(s->fds[0], values, sizeof(values)) > 0;
+    }
+    // Com PERF_FORMAT_GROUP: values[0] é o número de eventos, seguido dos valores na
+    // ordem de abertura (apenas os que abriram).
+    int k = 1;
+    for (int e = 0; e < COUNTERS_NUM_EVENTS; e++) {
+        if (ok && s->fds[e] >= 0 && k <= (int)values[0]) {
+            *out[e] += (long long)values[k++];
+        } else {
+            *out[e] = -1;
+        }
+        if (s->fds[e] >= 0) close(s->fds[e]);
+        s->fds[e] = -1;
+    }
+}
+
+#define COUNTERS_RESET() counters_reset()
+#define COUNTERS_THREAD_BEGIN() counters_thread_begin()
+#define COUNTERS_THREAD_END() counters_thread_end()
+#define COUNTERS_ADD_SWAPS(k) (counters_self()->c.swaps += (k))
+#define COUNTERS_ADD_WAIT(t) (counters_self()->c.wait_time += (t))
+// Executa 'stmt' contando o tempo como espera.
+#define COUNTERS_WAIT(stmt) do { \
+    double w_ = counters_now(); \
+    stmt; \
+    COUNTERS_ADD_WAIT(counters_now() - w_); \
+} while (0)
+// Barreira OpenMP com o tempo parado nela contado como espera.
+#define COUNTERS_BARRIER() do { \
+    double w_ = counters_now(); \
+    _Pragma("omp barrier") \
+    COUNTERS_ADD_WAIT(counters_now() - w_); \
+} while (0)
+
+#else
+
+#define COUNTERS_RESET() ((void)0)
+#define COUNTERS_THREAD_BEGIN() ((void)0)
+#define COUNTERS_THREAD_END() ((void)0)
+#define COUNTERS_ADD_SWAPS(k) ((void)0)
+#define COUNTERS_ADD_WAIT(t) ((void)0)
+#define COUNTERS_WAIT(stmt) do { stmt; } while (0)
+#define COUNTERS_BARRIER() _Pragma("omp barrier")
+
+#endif // OETSORT_WITH_COUNTERS
+
+#endif // COUNTER_UTILS_H
@@ -139,4 +139,234 @@ static inline void save_mpi_result(const char *filepath, int n, int size, double
     fclose(fp);
 }
 
-#endif // CSV_UTILS_H
\ No newline at end of file
+/**
+ * @brief Anexa o resultado de uma execução híbrida (MPI + OpenMP) a um arquivo CSV.
+ * Combina as colunas de save_openmp_result e save_mpi_result, para que a versão
+ * híbrida possa ser comparada com as duas versões puras.
+ * 
+ * @param filepath Caminho para o arquivo CSV.
+ * @param n Tamanho da entrada global.
+ * @param size Número de processos.
+ * @param threads_spec Threads por processo, como informado na linha de comando (ex: "4" ou "4:4:2:2").
+ * @param total_threads Total de threads somando todos os processos.
+ * @param schedule Política de escalonamento (schedule) das fases locais.
+ * @param t_parallel Tempo de execução paralelo (máximo entre os processos).
+ * @param computation_time_sum Soma do tempo de computação de todos os processos.
+ * @param comm_time_sum Soma do tempo de comunicação de todos os processos.
+ * @param overhead_abs Overhead absoluto.
+ * @param overhead_rel Overhead relativo (percentual).
+ * @param comm_efficiency Eficiência da comunicação.
+ * @param speedup Speedup calculado.
+ * @param efficiency Eficiência calculada (em relação ao total de threads).
+ */
+static inline void save_hybrid_result(const char *filepath, int n, int size, const char *threads_spec, int total_threads, const char *schedule, double t_parallel, double computation_time_sum, double comm_time_sum, double overhead_abs, double overhead_rel, double comm_efficiency, double speedup, double efficiency) {
+    ensure_dir_exists(filepath);
+    FILE *fp;
+    int needs_header = !file_exists(filepath);
+
+    fp = fopen(filepath, "a");
+    if (fp == NULL) {
+        perror("Falha ao abrir CSV para anexar dados");
+        return;
+    }
+
+    if (needs_header) {
+        fprintf(fp, "Tamanho,Processos,Threads,ThreadsTotal,Schedule,TempoTotal(max),TempoComputacao(soma),TempoComunicacao(soma),OverheadAbsoluto,OverheadRelativo,EficienciaComunicacao,Speedup,Eficiencia\n");
+    }
+
+    fprintf(fp, "%d,%d,%s,%d,%s,%.6f,%.6f,%.6f,%.6f,%.2f,%.4f,%.4f,%.4f\n", n, size, threads_spec, total_threads, schedule, t_parallel, computation_time_sum, comm_time_sum, overhead_abs, overhead_rel, comm_efficiency, speedup, efficiency);
+    fclose(fp);
+}
+
+/**
+ * @brief Anexa o resultado de uma execução com parada antecipada (--adaptativo) a um arquivo CSV.
+ * O mesmo arquivo é compartilhado pelas três versões, identificadas pela coluna 'Versao'.
+ * 
+ * @param filepath Caminho para o arquivo CSV.
+ * @param version Versão do programa ("serial", "openmp" ou "mpi").
+ * @param n Tamanho da entrada.
+ * @param workers Número de threads (OpenMP) ou processos (MPI); 1 na versão serial.
+ * @param variant Schedule (OpenMP) ou modo (MPI) usado.
+ * @param time_taken Tempo de execução.
+ * @param phases_run Número de fases efetivamente executadas (no máximo n).
+ */
+static inline void save_adaptive_result(const char *filepath, const char *version, int n, int workers, const char *variant, double time_taken, int phases_run) {
+    ensure_dir_exists(filepath);
+    FILE *fp;
+    int needs_header = !file_exists(filepath);
+
+    fp = fopen(filepath, "a");
+    if (fp == NULL) {
+        perror("Falha ao abrir CSV para anexar dados");
+        return;
+    }
+
+    if (needs_header) {
+        fprintf(fp, "Versao,Tamanho,Workers,Variante,Tempo(s),Fases\n");
+    }
+
+    fprintf(fp, "%s,%d,%d,%s,%.6f,%d\n", version, n, workers, variant, time_taken, phases_run);
+    fclose(fp);
+}
+
+/**
+ * @brief Salva o resultado de uma execução com tipo de chave genérico (opção --tipo)
+ * ou com registros (opção --payload) em um arquivo CSV.
+ *
+ * @param filepath O caminho para o arquivo CSV (ex: "data/tipos.csv").
+ * @param version A versão do executável ("serial", "openmp" ou "mpi").
+ * @param key_type O tipo da chave ("int32", "int64", "float" ou "double").
+ * @param payload_bytes Bytes de payload por registro (0 para apenas chaves).
+ * @param n O tamanho do array.
+ * @param workers Número de threads ou processos (1 para a versão serial).
+ * @param time_taken O tempo de execução em segundos.
+ * @param speedup O speedup em relação à versão serial do mesmo tipo.
+ * @param efficiency A eficiência (speedup / workers).
+ */
+static inline void save_typed_result(const char *filepath, const char *version, const char *key_type, int payload_bytes, int n, int workers, double time_taken, double speedup, double efficiency) {
+    ensure_dir_exists(filepath);
+    FILE *fp;
+    int needs_header = !file_exists(filepath);
+
+    fp = fopen(filepath, "a");
+    if (fp == NULL) {
+        perror("Falha ao abrir CSV para anexar dados");
+        return;
+    }
+
+    if (needs_header) {
+        fprintf(fp, "Versao,Tipo,Payload,Tamanho,Workers,Tempo(s),Speedup,Eficiencia\n");
+    }
+
+    fprintf(fp, "%s,%s,%d,%d,%d,%.6f,%.4f,%.4f\n", version, key_type, payload_bytes, n, workers, time_taken, speedup, efficiency);
+    fclose(fp);
+}
+
+/**
+ * @brief Anexa o resultado de uma ordenação em lote de segmentos independentes
+ * (--segmentos) a um arquivo CSV. A vazão é dada em segmentos por segundo e o speedup
+ * é relativo ao laço serial que ordena um segmento por vez.
+ */
+static inline void save_segments_result(const char *filepath, int n, int num_segments, int min_len, int max_len, int num_threads, const char *method, double time_taken, double speedup) {
+    ensure_dir_exists(filepath);
+    FILE *fp;
+    int needs_header = !file_exists(filepath);
+
+    fp = fopen(filepath, "a");
+    if (fp == NULL) {
+        perror("Falha ao abrir CSV para anexar dados");
+        return;
+    }
+
+    if (needs_header) {
+        fprintf(fp, "Tamanho,Segmentos,MinSegmento,MaxSegmento,Threads,Metodo,Tempo(s),SegmentosPorSegundo,Speedup\n");
+    }
+
+    fprintf(fp, "%d,%d,%d,%d,%d,%s,%.6f,%.1f,%.4f\n", n, num_segments, min_len, max_len, num_threads, method, time_taken, num_segments / time_taken, speedup);
+    fclose(fp);
+}
+
+/**
+ * @brief Anexa o resultado de uma execução MPI no modo distribuído (--distribuido) a um
+ * arquivo CSV. Não há speedup: a execução serial de referência exigiria o array inteiro
+ * em um único processo.
+ *
+ * @param filepath Caminho para o arquivo CSV (ex: "data/mpi_distribuido.csv").
+ * @param n Tamanho da entrada global.
+ * @param size Número de processos.
+ * @param mode Modo MPI usado ("fases", "sobreposto" ou "blocos").
+ * @param t_parallel Tempo de execução paralelo (máximo entre os processos).
+ * @param computation_time_sum Soma do tempo de computação de todos os processos.
+ * @param comm_time_sum Soma do tempo de comunicação de todos os processos.
+ * @param bytes_per_rank Maior bloco local em bytes (memória de dados de cada processo).
+ * @param phases_run Número de fases executadas.
+ */
+static inline void save_distributed_result(const char *filepath, int n, int size, const char *mode, double t_parallel, double computation_time_sum, double comm_time_sum, long long bytes_per_rank, int phases_run) {
+    ensure_dir_exists(filepath);
+    FILE *fp;
+    int needs_header = !file_exists(filepath);
+
+    fp = fopen(filepath, "a");
+    if (fp == NULL) {
+        perror("Falha ao abrir CSV para anexar dados");
+        return;
+    }
+
+    if (needs_header) {
+        fprintf(fp, "Tamanho,Processos,Modo,TempoTotal(max),TempoComputacao(soma),TempoComunicacao(soma),BytesPorProcesso,Fases\n");
+    }
+
+    fprintf(fp, "%d,%d,%s,%.6f,%.6f,%.6f,%lld,%d\n", n, size, mode, t_parallel, computation_time_sum, comm_time_sum, bytes_per_rank, phases_run);
+    fclose(fp);
+}
+
+/**
+ * @brief Anexa o resultado de uma execução MPI com relatório de partição (--particao ou
+ * --pesos) a um arquivo CSV.
+ *
+ * @param filepath Caminho para o arquivo CSV (ex: "data/mpi_particao.csv").
+ * @param n Tamanho da entrada global.
+ * @param size Número de processos.
+ * @param mode Modo MPI usado ("fases", "sobreposto" ou "blocos").
+ * @param partition Partição usada ("uniforme", "calibrada" ou "pesos").
+ * @param uniform_predicted Desbalanceamento previsto da partição uniforme (0 sem pesos).
+ * @param predicted Desbalanceamento previsto da partição usada (0 sem pesos).
+ * @param measured Desbalanceamento medido (tempo de computação máximo / médio).
+ * @param t_parallel Tempo de execução paralelo (máximo entre os processos).
+ * @param comm_time_max Maior tempo de comunicação (com a espera pelos vizinhos) de um processo.
+ * @param comm_time_sum Soma do tempo de comunicação de todos os processos.
+ */
+static inline void save_partition_result(const char *filepath, int n, int size, const char *mode, const char *partition, double uniform_predicted, double predicted, double measured, double t_parallel, double comm_time_max, double comm_time_sum) {
+    ensure_dir_exists(filepath);
+    FILE *fp;
+    int needs_header = !file_exists(filepath);
+
+    fp = fopen(filepath, "a");
+    if (fp == NULL) {
+        perror("Falha ao abrir CSV para anexar dados");
+        return;
+    }
+
+    if (needs_header) {
+        fprintf(fp, "Tamanho,Processos,Modo,Particao,DesbalanceamentoUniformePrevisto,DesbalanceamentoPrevisto,DesbalanceamentoMedido,TempoTotal(max),TempoComunicacao(max),TempoComunicacao(soma)\n");
+    }
+
+    fprintf(fp, "%d,%d,%s,%s,%.4f,%.4f,%.4f,%.6f,%.6f,%.6f\n", n, size, mode, partition, uniform_predicted, predicted, measured, t_parallel, comm_time_max, comm_time_sum);
+    fclose(fp);
+}
+
+/**
+ * @brief Anexa o resultado de uma execução MPI com o motor de troca escolhido (--troca)
+ * a um arquivo CSV.
+ *
+ * @param filepath Caminho para o arquivo CSV (ex: "data/mpi_troca.csv").
+ * @param n Tamanho da entrada global.
+ * @param size Número de processos.
+ * @param mode Modo MPI usado ("fases" ou "sobreposto") ou "hibrido".
+ * @param exchange Motor de troca ("sendrecv", "persistente", "rma" ou "rma-pscw").
+ * @param shared_window 1 se a troca 'rma' usou a janela de memória compartilhada.
+ * @param t_parallel Tempo de execução paralelo (máximo entre os processos).
+ * @param computation_time_sum Soma do tempo de computação de todos os processos.
+ * @param comm_time_sum Soma do tempo de comunicação de todos os processos.
+ * @param speedup Speedup em relação à versão serial.
+ */
+static inline void save_exchange_result(const char *filepath, int n, int size, const char *mode, const char *exchange, int shared_window, double t_parallel, double computation_time_sum, double comm_time_sum, double speedup) {
+    ensure_dir_exists(filepath);
+    FILE *fp;
+    int needs_header = !file_exists(filepath);
+
+    fp = fopen(filepath, "a");
+    if (fp == NULL) {
+        perror("Falha ao abrir CSV para anexar dados");
+        return;
+    }
+
+    if (needs_header) {
+        fprintf(fp, "Tamanho,Processos,Modo,Troca,JanelaCompartilhada,TempoTotal(max),TempoComputacao(soma),TempoComunicacao(soma),Speedup\n");
+    }
+
+    fprintf(fp, "%d,%d,%s,%s,%d,%.6f,%.6f,%.6f,%.4f\n", n, size, mode, exchange, shared_window, t_parallel, computation_time_sum, comm_time_sum, speedup);
+    fclose(fp);
+}
+
+#endif // CSV_UTILS_H
@@ -0,0 +1,272 @@
+#ifndef EXCHANGE_UTILS_H
+#define EXCHANGE_UTILS_H
+
+// Requer _GNU_SOURCE definido antes dos includes (pool_utils.h).
+#include <stdatomic.h>
+#include <string.h>
+#include <mpi.h>
+#include "pool_utils.h"
+#include "oetsort.h"
+
+/*
+ * Motores de troca do elemento de fronteira dos backends MPI 'fases', 'sobreposto' e
+ * híbrido (opção 'exchange' de oetsort_options).
+ *
+ * A cada fase, cada processo troca um único inteiro com o vizinho da esquerda ou da
+ * direita; com uma mensagem tão pequena, o custo é o de montar a comunicação, não o de
+ * transferir o dado. Os motores são criados uma vez por ordenação (coletivamente) e
+ * reaproveitados em todas as fases:
+ *   - sendrecv: MPI_Sendrecv a cada fase (MPI_Isend/MPI_Irecv no modo 'sobreposto'),
+ *     o comportamento original;
+ *   - persistente: um par MPI_Send_init/MPI_Recv_init por vizinho, reiniciado a cada
+ *     fase com MPI_Startall;
+ *   - rma: com o vizinho no mesmo nó, janela de memória compartilhada do nó
+ *     (MPI_Win_allocate_shared): o valor é gravado diretamente na janela do vizinho e
+ *     sinalizado por um contador de sequência atômico, sem nenhuma chamada MPI na fase.
+ *     A escolha é feita por par de vizinhos: com o vizinho em outro nó, o mesmo que
+ *     rma-pscw;
+ *   - rma-pscw: MPI_Put na janela do vizinho, sincronizado por épocas PSCW
+ *     (MPI_Win_post/start/complete/wait) restritas ao par de vizinhos.
+ *
+ * Cada troca é dividida em exchange_start (envia) e exchange_finish (espera o valor do
+ * vizinho), para que o modo 'sobreposto' processe os pares internos entre as duas.
+ */
+
+// Índice do vizinho: o da esquerda (rank - 1) e o da direita (rank + 1).
+#define EXCHANGE_LEFT 0
+#define EXCHANGE_RIGHT 1
+
+// Caixa de entrada de um vizinho na janela compartilhada. O vizinho pode estar uma troca
+// à frente (já gravou a troca k + 1 quando este processo ainda lê a k), mas não duas: só
+// inicia a troca k + 2 depois de receber a k + 1, que este processo só envia depois de
+// ler a k. Por isso o valor tem duas posições, alternadas pela sequência.
+typedef struct {
+    atomic_uint seq __attribute__((aligned(64)));  // Última troca entregue.
+    int vals[2];
+} exchange_mailbox;
+
+typedef struct {
+    oetsort_exchange kind;
+    int rank;
+    int neighbors[2];            // Ranks vizinhos, ou -1 nas pontas.
+    int send_val[2];             // Buffers de envio (persistente e rma-pscw).
+    int recv_val[2];             // Buffers de recepção (sendrecv e persistente).
+    MPI_Request reqs[2][2];      // Recepção e envio de cada vizinho.
+    // rma e rma-pscw.
+    int shared[2];               // rma: vizinho no mesmo nó, trocado pela janela compartilhada.
+    MPI_Comm node;               // rma: processos do nó.
+    MPI_Win shared_win;          // rma: janela de memória compartilhada do nó.
+    exchange_mailbox *inbox;     // rma: caixas de entrada deste processo (uma por vizinho).
+    exchange_mailbox *outbox[2]; // rma: caixa deste processo na janela de cada vizinho.
+    unsigned seq[2];             // rma: trocas já feitas com cada vizinho.
+    int spin_limit;              // rma: voltas de espera antes de ceder o processador.
+    MPI_Win win;                 // PSCW: janela de todos os processos, se algum par está entre nós.
+    int *slots;                  // PSCW: valor recebido de cada vizinho.
+    MPI_Group groups[2];         // PSCW: grupo de cada vizinho em outro nó.
+} exchange_engine;
+
+// Determina o processo parceiro de 'rank' na fase informada.
+// Nas fases pares os pares são (0,1), (2,3), ...; nas ímpares, (1,2), (3,4), ...
+// O resultado pode ficar fora do intervalo [0, size), indicando que não há parceiro.
+static inline int phase_partner(int rank, int phase) {
+    if ((phase % 2) == 0) { // Fase par
+        return (rank % 2 == 0) ? rank + 1 : rank - 1;
+    } else { // Fase ímpar
+        return (rank % 2 != 0) ? rank + 1 : rank - 1;
+    }
+}
+
+static inline int exchange_side(const exchange_engine *ex, int partner) {
+    return (partner < ex->rank) ? EXCHANGE_LEFT : EXCHANGE_RIGHT;
+}
+
+/**
+ * @brief Cria o motor de troca 'kind' entre os processos de MPI_COMM_WORLD. Coletiva.
+ */
+static inline void exchange_init(exchange_engine *ex, oetsort_exchange kind, int rank, int size) {
+    memset(ex, 0, sizeof(*ex));
+    ex->kind = kind;
+    ex->rank = rank;
+    ex->neighbors[EXCHANGE_LEFT] = (rank > 0) ? rank - 1 : -1;
+    ex->neighbors[EXCHANGE_RIGHT] = (rank < size - 1) ? rank + 1 : -1;
+    ex->node = MPI_COMM_NULL;
+    ex->shared_win = MPI_WIN_NULL;
+    ex->win = MPI_WIN_NULL;
+    for (int s = 0; s < 2; s++) ex->groups[s] = MPI_GROUP_NULL;
+
+    if (kind == OETSORT_EXCHANGE_PERSISTENT) {
+        for (int s = 0; s < 2; s++) {
+            int p = ex->neighbors[s];
+            if (p < 0) continue;
+            MPI_Recv_init(&ex->recv_val[s], 1, MPI_INT, p, 0, MPI_COMM_WORLD, &ex->reqs[s][0]);
+            MPI_Send_init(&ex->send_val[s], 1, MPI_INT, p, 0, MPI_COMM_WORLD, &ex->reqs[s][1]);
+        }
+    }
+    if (kind != OETSORT_EXCHANGE_RMA && kind != OETSORT_EXCHANGE_RMA_PSCW) return;
+
+    // rma: os vizinhos que estão no comunicador do nó são trocados pela janela
+    // compartilhada, os demais por PSCW. 'node_ranks' é o rank de cada vizinho no nó.
+    int node_ranks[2] = {MPI_UNDEFINED, MPI_UNDEFINED};
+    int node_size = 1;
+    if (kind == OETSORT_EXCHANGE_RMA) {
+        MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, rank, MPI_INFO_NULL, &ex->node);
+        MPI_Comm_size(ex->node, &node_size);
+        MPI_Group world, node;
+        MPI_Comm_group(MPI_COMM_WORLD, &world);
+        MPI_Comm_group(ex->node, &node);
+        for (int s = 0; s < 2; s++) {
+            if (ex->neighbors[s] >= 0) MPI_Group_translate_ranks(world, 1, &ex->neighbors[s], node, &node_ranks[s]);
+            ex->shared[s] = node_ranks[s] != MPI_UNDEFINED;
+        }
+        MPI_Group_free(&node);
+        MPI_Group_free(&world);
+    }
+
+    // A criação de cada janela é coletiva: a compartilhada no nó, se ele tem mais de um
+    // processo (mesma decisão em todos do nó), e a PSCW em todos, se algum par de
+    // vizinhos (em qualquer processo) não compartilha o nó.
+    if (node_size > 1) {
+        // Cada processo aloca as suas caixas de entrada perto de si (não contíguas).
+        MPI_Info info;
+        MPI_Info_create(&info);
+        MPI_Info_set(info, "alloc_shared_noncontig", "true");
+        MPI_Win_allocate_shared(2 * sizeof(exchange_mailbox), sizeof(exchange_mailbox), info, ex->node,
+                                &ex->inbox, &ex->shared_win);
+        MPI_Info_free(&info);
+        for (int s = 0; s < 2; s++) {
+            atomic_init(&ex->inbox[s].seq, 0);
+            if (!ex->shared[s]) continue;
+            MPI_Aint bytes;
+            int disp_unit;
+            exchange_mailbox *base;
+            MPI_Win_shared_query(ex->shared_win, node_ranks[s], &bytes, &disp_unit, &base);
+            // Este processo é o vizinho da direita do vizinho da esquerda, e vice-versa.
+            ex->outbox[s] = &base[1 - s];
+        }
+        // Época passiva durante toda a ordenação: as fases usam apenas loads e stores.
+        MPI_Win_lock_all(MPI_MODE_NOCHECK, ex->shared_win);
+        MPI_Win_sync(ex->shared_win);
+        MPI_Barrier(ex->node);
+        MPI_Win_sync(ex->shared_win);
+        // Com mais processos no nó que CPUs no processo, o vizinho esperado pode estar
+        // fora do processador: cede a vez a cada volta.
+        ex->spin_limit = (node_size > pool_default_threads()) ? 1 : POOL_SPIN_LIMIT;
+    }
+
+    int remote = 0, any_remote;
+    for (int s = 0; s < 2; s++) remote |= ex->neighbors[s] >= 0 && !ex->shared[s];
+    MPI_Allreduce(&remote, &any_remote, 1, MPI_INT, MPI_LOR, MPI_COMM_WORLD);
+    if (any_remote) {
+        MPI_Win_allocate(2 * sizeof(int), sizeof(int), MPI_INFO_NULL, MPI_COMM_WORLD, &ex->slots, &ex->win);
+        MPI_Group world;
+        MPI_Comm_group(MPI_COMM_WORLD, &world);
+        for (int s = 0; s < 2; s++) {
+            if (ex->neighbors[s] >= 0 && !ex->shared[s]) MPI_Group_incl(world, 1, &ex->neighbors[s], &ex->groups[s]);
+        }
+        MPI_Group_free(&world);
+    }
+}
+
+/**
+ * @brief Envia 'send_val' ao parceiro da fase (um dos vizinhos). Deve ser seguida de
+ * exchange_finish com o mesmo parceiro, antes de qualquer outra troca.
+ */
+static inline void exchange_start(exchange_engine *ex, int partner, int send_val) {
+    int s = exchange_side(ex, partner);
+    switch (ex->kind) {
+    case OETSORT_EXCHANGE_PERSISTENT:
+        ex->send_val[s] = send_val;
+        MPI_Startall(2, ex->reqs[s]);
+        break;
+    case OETSORT_EXCHANGE_RMA:
+    case OETSORT_EXCHANGE_RMA_PSCW:
+        if (ex->shared[s]) {
+            unsigned k = ++ex->seq[s];
+            exchange_mailbox *box = ex->outbox[s];
+            box->vals[k & 1] = send_val;
+            atomic_store_explicit(&box->seq, k, memory_order_release);
+        } else {
+            // Expõe a própria janela ao parceiro e grava na dele.
+            ex->send_val[s] = send_val;
+            MPI_Win_post(ex->groups[s], 0, ex->win);
+            MPI_Win_start(ex->groups[s], 0, ex->win);
+            MPI_Put(&ex->send_val[s], 1, MPI_INT, partner, 1 - s, 1, MPI_INT, ex->win);
+        }
+        break;
+    default:
+        ex->send_val[s] = send_val;
+        MPI_Irecv(&ex->recv_val[s], 1, MPI_INT, partner, 0, MPI_COMM_WORLD, &ex->reqs[s][0]);
+        MPI_Isend(&ex->send_val[s], 1, MPI_INT, partner, 0, MPI_COMM_WORLD, &ex->reqs[s][1]);
+        break;
+    }
+}
+
+/**
+ * @brief Conclui a troca iniciada por exchange_start e retorna o valor do parceiro.
+ */
+static inline int exchange_finish(exchange_engine *ex, int partner) {
+    int s = exchange_side(ex, partner);
+    if ((ex->kind == OETSORT_EXCHANGE_RMA || ex->kind == OETSORT_EXCHANGE_RMA_PSCW) && ex->shared[s]) {
+        unsigned k = ex->seq[s];
+        exchange_mailbox *box = &ex->inbox[s];
+        int spins = 0;
+        while ((int)(atomic_load_explicit(&box->seq, memory_order_acquire) - k) < 0) {
+            pool_pause();
+            if (++spins >= ex->spin_limit) {
+                sched_yield();
+                spins = 0;
+            }
+        }
+        return box->vals[k & 1];
+    }
+    if (ex->kind == OETSORT_EXCHANGE_RMA || ex->kind == OETSORT_EXCHANGE_RMA_PSCW) {
+        MPI_Win_complete(ex->win);
+        MPI_Win_wait(ex->win);
+        return ex->slots[s];
+    }
+    MPI_Waitall(2, ex->reqs[s], MPI_STATUSES_IGNORE);
+    return ex->recv_val[s];
+}
+
+/**
+ * @brief Troca completa com o parceiro da fase: envia 'send_val' e retorna o valor dele.
+ */
+static inline int exchange_value(exchange_engine *ex, int partner, int send_val) {
+    if (ex->kind == OETSORT_EXCHANGE_SENDRECV) {
+        // MPI_Sendrecv envia e recebe mensagens simultaneamente, evitando deadlocks.
+        int recv_val;
+        MPI_Sendrecv(&send_val, 1, MPI_INT, partner, 0,
+                     &recv_val, 1, MPI_INT, partner, 0,
+                     MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+        return recv_val;
+    }
+    exchange_start(ex, partner, send_val);
+    return exchange_finish(ex, partner);
+}
+
+/**
+ * @brief Libera o motor de troca. Coletiva.
+ */
+static inline void exchange_free(exchange_engine *ex) {
+    if (ex->kind == OETSORT_EXCHANGE_PERSISTENT) {
+        for (int s = 0; s < 2; s++) {
+            if (ex->neighbors[s] < 0) continue;
+            MPI_Request_free(&ex->reqs[s][0]);
+            MPI_Request_free(&ex->reqs[s][1]);
+        }
+        return;
+    }
+    if (ex->shared_win != MPI_WIN_NULL) {
+        MPI_Win_unlock_all(ex->shared_win);
+        MPI_Win_free(&ex->shared_win);
+    }
+    if (ex->win != MPI_WIN_NULL) {
+        for (int s = 0; s < 2; s++) {
+            if (ex->groups[s] != MPI_GROUP_NULL) MPI_Group_free(&ex->groups[s]);
+        }
+        MPI_Win_free(&ex->win);
+    }
+    if (ex->node != MPI_COMM_NULL) MPI_Comm_free(&ex->node);
+}
+
+#endif // EXCHANGE_UTILS_H
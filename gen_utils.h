@@ -0,0 +1,88 @@
+#ifndef GEN_UTILS_H
+#define GEN_UTILS_H
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <math.h>
+
+/*
+ * Geração de entradas reprodutíveis (usada por oetsort_generate).
+ *
+ * O gerador é baseado em contador: o valor da posição global i é uma função pura de
+ * (semente, i), calculada com o finalizador do SplitMix64. Não há estado sequencial
+ * como em rand(), então qualquer fatia do array pode ser gerada de forma independente:
+ * threads OpenMP e processos MPI produzem exatamente o mesmo array global, qualquer
+ * que seja o número de threads ou de processos.
+ *
+ * Cada uso do gerador tem o seu fluxo ('stream'), para que, por exemplo, as posições
+ * deslocadas da entrada quase ordenada não se correlacionem com os valores.
+ */
+
+// Fluxos independentes do gerador.
+enum {
+    GEN_STREAM_VALUE,     // Valor de cada posição.
+    GEN_STREAM_FRACTION,  // Parte fracionária das chaves float/double.
+    GEN_STREAM_POSITION,  // Posições deslocadas da entrada quase ordenada.
+    GEN_STREAM_DISPLACED, // Valores das posições deslocadas.
+    GEN_STREAM_FINGERPRINT_A, // Primeiro hash das chaves na impressão digital (oetsort_fingerprint_keys).
+    GEN_STREAM_FINGERPRINT_B, // Segundo hash, independente do primeiro.
+    GEN_STREAM_SEGMENT        // Tamanhos dos segmentos do modo em lote (--segmentos).
+};
+
+// Finalizador do SplitMix64: mistura os bits de 'z' (bijeção em 64 bits).
+static inline uint64_t gen_mix64(uint64_t z) {
+    z ^= z >> 30;
+    z *= 0xbf58476d1ce4e5b9ULL;
+    z ^= z >> 27;
+    z *= 0x94d049bb133111ebULL;
+    z ^= z >> 31;
+    return z;
+}
+
+// Número pseudoaleatório de 64 bits da posição 'i' do fluxo 'stream'.
+static inline uint64_t gen_random(uint64_t seed, uint64_t stream, uint64_t i) {
+    uint64_t key = gen_mix64(seed + stream * 0x9e3779b97f4a7c15ULL);
+    return gen_mix64(key + (i + 1) * 0x9e3779b97f4a7c15ULL);
+}
+
+// Inteiro em [0, bound), com bound < 2^32 (multiplicação em vez de '%', sem o viés do resto).
+static inline uint32_t gen_bounded(uint64_t r, uint32_t bound) {
+    return (uint32_t)(((r >> 32) * (uint64_t)bound) >> 32);
+}
+
+// Número real em [0, 1), com 53 bits de precisão.
+static inline double gen_unit(uint64_t r) {
+    return (double)(r >> 11) * (1.0 / 9007199254740992.0);
+}
+
+/**
+ * @brief Monta a função de distribuição acumulada de Zipf com expoente 's' sobre os
+ * valores 1..count: cdf[k - 1] = P(X <= k), com P(X = k) proporcional a 1 / k^s.
+ *
+ * @return double* A tabela (liberada pelo chamador), ou NULL se faltar memória.
+ */
+static inline double *gen_zipf_table(int count, double s) {
+    double *cdf = malloc((size_t)count * sizeof(double));
+    if (cdf == NULL) return NULL;
+    double sum = 0.0;
+    for (int k = 1; k <= count; k++) {
+        sum += 1.0 / pow((double)k, s);
+        cdf[k - 1] = sum;
+    }
+    for (int k = 0; k < count; k++) cdf[k] /= sum;
+    cdf[count - 1] = 1.0;
+    return cdf;
+}
+
+// Menor k em [0, count) com u <= cdf[k] (busca binária na tabela de gen_zipf_table).
+static inline int gen_zipf_sample(const double cdf[], int count, double u) {
+    int lo = 0, hi = count - 1;
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (u <= cdf[mid]) hi = mid;
+        else lo = mid + 1;
+    }
+    return lo;
+}
+
+#endif // GEN_UTILS_H
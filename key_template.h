@@ -0,0 +1,271 @@
+/*
+ * Modelo (template) das funções especializadas por tipo de chave.
+ *
+ * Este arquivo NÃO tem guarda de inclusão: ele é incluído uma vez por tipo por
+ * key_types.h, com as macros abaixo definidas, e gera funções com o sufixo do tipo
+ * (ex: odd_even_sort_serial_i64). Cada instância é compilada para o seu tipo, sem
+ * nenhum despacho em tempo de execução dentro dos laços de fases.
+ *
+ *   KEY_T         Tipo da chave (ex: int64_t).
+ *   KEY_NAME      Sufixo dos nomes gerados (ex: i64).
+ *   KEY_LABEL     Nome do tipo na linha de comando e nos CSVs (ex: "int64").
+ *   KEY_MPI       Datatype MPI correspondente (usado apenas quando mpi.h foi incluído).
+ *   KEY_FMT       Formato de impressão, aplicado a KEY_CAST(x).
+ *   KEY_CAST      Conversão usada na impressão.
+ *   KEY_CE        (opcional) Kernel de compare-exchange já existente para o tipo.
+ *
+ * Registros (chave + payload) usam layout de estrutura de arrays: as chaves ficam
+ * em um array e, em outro paralelo ('idx'), o índice original de cada registro.
+ * Apenas chaves e índices passam pelo compare-exchange; o payload é movido uma
+ * única vez no final, em lote, por apply_payload_permutation(). Quando 'idx' é
+ * NULL, só as chaves são ordenadas.
+ */
+
+#define KT_CAT_(a, b) a##_##b
+#define KT_CAT(a, b) KT_CAT_(a, b)
+#define KT(name) KT_CAT(name, KEY_NAME)
+
+#ifndef KEY_CE
+/**
+ * @brief Compare-exchange escalar sem desvios de 'num_pairs' pares consecutivos de chaves.
+ *
+ * @return int Retorna 1 se houve alguma troca, 0 caso contrário.
+ */
+static inline int KT(compare_exchange_pairs)(KEY_T *a, int num_pairs) {
+    int changed = 0;
+    for (int k = 0; k < num_pairs; k++) {
+        KEY_T x = a[2 * k];
+        KEY_T y = a[2 * k + 1];
+        int s = x > y;
+        a[2 * k] = s ? y : x;
+        a[2 * k + 1] = s ? x : y;
+        changed |= s;
+    }
+    return changed;
+}
+#define KT_CE KT(compare_exchange_pairs)
+#else
+#define KT_CE KEY_CE
+#endif
+
+/**
+ * @brief Compare-exchange de registros: as chaves decidem a troca e os índices acompanham.
+ * A troca só ocorre com chave estritamente maior, o que mantém a ordenação estável.
+ *
+ * @return int Retorna 1 se houve alguma troca, 0 caso contrário.
+ */
+static inline int KT(compare_exchange_records)(KEY_T *keys, uint32_t *idx, int num_pairs) {
+    int changed = 0;
+    for (int k = 0; k < num_pairs; k++) {
+        KEY_T x = keys[2 * k];
+        KEY_T y = keys[2 * k + 1];
+        uint32_t a = idx[2 * k];
+        uint32_t b = idx[2 * k + 1];
+        int s = x > y;
+        keys[2 * k] = s ? y : x;
+        keys[2 * k + 1] = s ? x : y;
+        idx[2 * k] = s ? b : a;
+        idx[2 * k + 1] = s ? a : b;
+        changed |= s;
+    }
+    return changed;
+}
+
+/**
+ * @brief Executa os pares (j, j+1) de uma fase com j em [from, to), como phase_range_odd_even.
+ * Com 'idx' não nulo, os índices dos registros acompanham as chaves.
+ *
+ * @return int Retorna 1 se houve alguma troca, 0 caso contrário.
+ */
+static inline int KT(phase_range_odd_even)(KEY_T keys[], uint32_t idx[], int n, int phase, int from, int to) {
+    if (from < 0) from = 0;
+    if (to > n - 1) to = n - 1; // O último par válido começa em n-2.
+    if ((from % 2) != (phase % 2)) from++;
+    if (from >= to) return 0;
+    int num_pairs = (to - from + 1) / 2;
+    if (idx != NULL) {
+        return KT(compare_exchange_records)(keys + from, idx + from, num_pairs);
+    }
+    return KT_CE(keys + from, num_pairs);
+}
+
+/**
+ * @brief Versão serial do Odd-Even Transposition Sort para o tipo.
+ *
+ * @param keys_v Array de chaves (KEY_T).
+ * @param idx Índices dos registros, ou NULL para ordenar apenas as chaves.
+ * @param n Número de elementos.
+ */
+static inline void KT(odd_even_sort_serial)(void *keys_v, uint32_t idx[], int n) {
+    KEY_T *keys = (KEY_T *)keys_v;
+    for (int phase = 0; phase < n; phase++) {
+        KT(phase_range_odd_even)(keys, idx, n, phase, 0, n);
+    }
+}
+
+/**
+ * @brief Imprime as chaves do array.
+ */
+static inline void KT(print_array)(const void *arr_v, int n) {
+    const KEY_T *arr = (const KEY_T *)arr_v;
+    for (int i = 0; i < n; i++) {
+        printf(KEY_FMT " ", KEY_CAST(arr[i]));
+    }
+    printf("\n");
+}
+
+/**
+ * @brief Verifica se as chaves estão em ordem crescente.
+ *
+ * @return int Retorna 1 se o array estiver ordenado, 0 caso contrário.
+ */
+static inline int KT(is_sorted)(const void *arr_v, int n) {
+    const KEY_T *arr = (const KEY_T *)arr_v;
+    for (int i = 0; i < n - 1; i++) {
+        if (arr[i] > arr[i + 1]) return 0;
+    }
+    return 1;
+}
+
+#ifdef _OPENMP
+/**
+ * @brief Versão OpenMP (schedule static, blocos de PHASE_BLOCK_PAIRS pares) para o tipo.
+ */
+static inline void KT(odd_even_sort_openmp_static)(void *keys_v, uint32_t idx[], int n, int num_threads) {
+    KEY_T *keys = (KEY_T *)keys_v;
+    int num_blocks = phase_num_blocks(n);
+    #pragma omp parallel num_threads(num_threads) default(none) shared(keys, idx, n, num_blocks)
+    {
+        COUNTERS_THREAD_BEGIN();
+        for (int phase = 0; phase < n; phase++) {
+            #pragma omp for schedule(static) nowait
+            for (int b = 0; b < num_blocks; b++) {
+                int from = (phase % 2) + 2 * b * PHASE_BLOCK_PAIRS;
+                KT(phase_range_odd_even)(keys, idx, n, phase, from, from + 2 * PHASE_BLOCK_PAIRS);
+            }
+            COUNTERS_BARRIER();
+        }
+        COUNTERS_THREAD_END();
+    }
+}
+#endif
+
+#ifdef MPI_VERSION
+// Registro trocado na fronteira entre processos: a chave e o índice original.
+typedef struct {
+    KEY_T key;
+    uint32_t idx;
+} KT(boundary_record);
+
+/**
+ * @brief Datatype MPI das chaves do tipo.
+ */
+static inline MPI_Datatype KT(key_mpi_type)(void) {
+    return KEY_MPI;
+}
+
+/**
+ * @brief Cria (e confirma) o datatype MPI derivado de KT(boundary_record).
+ * Deve ser liberado com MPI_Type_free.
+ */
+static inline MPI_Datatype KT(record_mpi_type)(void) {
+    int blocklens[2] = {1, 1};
+    MPI_Aint displs[2] = {offsetof(KT(boundary_record), key), offsetof(KT(boundary_record), idx)};
+    MPI_Datatype types[2] = {KEY_MPI, MPI_UINT32_T};
+    MPI_Datatype tmp, record_type;
+    MPI_Type_create_struct(2, blocklens, displs, types, &tmp);
+    // Ajusta a extensão ao tamanho real da struct (inclui o preenchimento).
+    MPI_Type_create_resized(tmp, 0, sizeof(KT(boundary_record)), &record_type);
+    MPI_Type_commit(&record_type);
+    MPI_Type_free(&tmp);
+    return record_type;
+}
+
+/**
+ * @brief Modo 'fases' da versão MPI para o tipo: n fases globais com troca do elemento
+ * de fronteira. Com 'idx' não nulo, a fronteira é trocada como registro (chave + índice)
+ * usando o datatype derivado. Com 'until_converged' (blocos de tamanhos diferentes ou
+ * ímpares), as fases continuam depois das n até um par de fases sem trocas em nenhum
+ * processo. Retorna o número de fases executadas.
+ */
+static inline int KT(odd_even_sort_mpi_phases)(void *keys_v, uint32_t idx[], int local_n, int n, int rank, int size,
+                                               int until_converged, double *comm_time) {
+    KEY_T *keys = (KEY_T *)keys_v;
+    MPI_Datatype type = (idx != NULL) ? KT(record_mpi_type)() : KEY_MPI;
+    int swapped = 0; // Trocas no par de fases atual.
+    int phase;
+
+    for (phase = 0; phase < n || until_converged; phase++) {
+        if (phase % 2 == 0) swapped = 0;
+
+        // 1. Ordenação local.
+        swapped |= KT(phase_range_odd_even)(keys, idx, local_n, phase, 0, local_n);
+
+        // 2. Comunicação de fronteiras (mesmos parceiros da versão int).
+        int partner = phase_partner(rank, phase);
+        if (partner >= 0 && partner < size) {
+            int pos = (rank < partner) ? local_n - 1 : 0;
+            KT(boundary_record) send_rec, recv_rec;
+            send_rec.key = keys[pos];
+            send_rec.idx = (idx != NULL) ? idx[pos] : 0;
+
+            double comm_start = MPI_Wtime();
+            // Sem registros, apenas o campo 'key' é enviado, com o datatype da chave.
+            MPI_Sendrecv(&send_rec, 1, type, partner, 0,
+                         &recv_rec, 1, type, partner, 0,
+                         MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+            *comm_time += (MPI_Wtime() - comm_start);
+
+            int take = (rank < partner) ? (send_rec.key > recv_rec.key) : (recv_rec.key > send_rec.key);
+            if (take) {
+                keys[pos] = recv_rec.key;
+                if (idx != NULL) idx[pos] = recv_rec.idx;
+                swapped = 1;
+            }
+        }
+
+        // 3. Depois das n fases, verificação global a cada par de fases (par + ímpar).
+        if (until_converged && phase % 2 != 0 && phase + 1 >= n) {
+            int global_swapped;
+            double comm_start = MPI_Wtime();
+            MPI_Allreduce(&swapped, &global_swapped, 1, MPI_INT, MPI_LOR, MPI_COMM_WORLD);
+            *comm_time += (MPI_Wtime() - comm_start);
+            if (!global_swapped) {
+                phase++;
+                break;
+            }
+        }
+    }
+
+    if (idx != NULL) MPI_Type_free(&type);
+    return phase;
+}
+#endif
+
+// Tabela de operações do tipo, usada apenas pelos drivers (fora dos laços de fases).
+static const key_ops KT(key_ops) = {
+    KEY_LABEL,
+    sizeof(KEY_T),
+    KT(print_array),
+    KT(is_sorted),
+    KT(odd_even_sort_serial),
+#ifdef _OPENMP
+    KT(odd_even_sort_openmp_static),
+#endif
+#ifdef MPI_VERSION
+    KT(key_mpi_type),
+    KT(odd_even_sort_mpi_phases),
+#endif
+};
+
+#undef KT_CE
+#undef KT
+#undef KT_CAT
+#undef KT_CAT_
+#undef KEY_T
+#undef KEY_NAME
+#undef KEY_LABEL
+#undef KEY_MPI
+#undef KEY_FMT
+#undef KEY_CAST
+#undef KEY_CE
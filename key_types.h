@@ -0,0 +1,111 @@
+#ifndef KEY_TYPES_H
+#define KEY_TYPES_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include "simd_utils.h"
+
+/*
+ * Tipos de chave genéricos e ordenação de registros (chave + payload).
+ *
+ * As funções de cada tipo (int32, int64, float e double) são geradas em tempo de
+ * compilação a partir de key_template.h, com o sufixo do tipo (i32, i64, f32, f64).
+ * A instância int32 reaproveita o kernel SIMD de simd_utils.h; os demais tipos usam
+ * o compare-exchange escalar sem desvios. O caminho int (oetsort_sort) não passa
+ * por aqui, exceto no modo de chaves compactadas: as instâncias internas uint8 e uint16
+ * (sufixos u8 e u16, com os kernels de chaves estreitas de simd_utils.h) ordenam as
+ * chaves deslocadas pelo mínimo quando o intervalo delas cabe em 8 ou 16 bits.
+ *
+ * A biblioteca (oetsort.c) acessa as funções de cada tipo por uma tabela key_ops:
+ * o despacho acontece uma vez por ordenação, não a cada par comparado.
+ *
+ * Para as versões OpenMP e MPI, as entradas correspondentes da tabela só existem
+ * quando omp.h / mpi.h foram incluídos antes deste arquivo; a versão MPI usa também
+ * phase_partner, de exchange_utils.h.
+ */
+
+// Operações de um tipo de chave. 'keys' aponta para um array do tipo e 'idx',
+// quando não nulo, para os índices originais dos registros (um por chave).
+typedef struct {
+    const char *name;  // Nome do tipo na linha de comando e nos CSVs.
+    size_t size;       // sizeof da chave.
+    void (*print)(const void *arr, int n);
+    int (*is_sorted)(const void *arr, int n);
+    void (*sort_serial)(void *keys, uint32_t idx[], int n);
+#ifdef _OPENMP
+    void (*sort_openmp)(void *keys, uint32_t idx[], int n, int num_threads);
+#endif
+#ifdef MPI_VERSION
+    MPI_Datatype (*mpi_type)(void);
+    int (*sort_mpi)(void *keys, uint32_t idx[], int local_n, int n, int rank, int size, int until_converged,
+                    double *comm_time);
+#endif
+} key_ops;
+
+#define KEY_T int32_t
+#define KEY_NAME i32
+#define KEY_LABEL "int32"
+#define KEY_MPI MPI_INT32_T
+#define KEY_FMT "%d"
+#define KEY_CAST(x) (int)(x)
+#define KEY_CE compare_exchange_pairs
+#include "key_template.h"
+
+#define KEY_T int64_t
+#define KEY_NAME i64
+#define KEY_LABEL "int64"
+#define KEY_MPI MPI_INT64_T
+#define KEY_FMT "%lld"
+#define KEY_CAST(x) (long long)(x)
+#include "key_template.h"
+
+#define KEY_T float
+#define KEY_NAME f32
+#define KEY_LABEL "float"
+#define KEY_MPI MPI_FLOAT
+#define KEY_FMT "%.3f"
+#define KEY_CAST(x) (double)(x)
+#include "key_template.h"
+
+#define KEY_T double
+#define KEY_NAME f64
+#define KEY_LABEL "double"
+#define KEY_MPI MPI_DOUBLE
+#define KEY_FMT "%.3f"
+#define KEY_CAST(x) (double)(x)
+#include "key_template.h"
+
+// Tipos internos do modo de chaves compactadas (fora de oetsort_key_type).
+#define KEY_T uint8_t
+#define KEY_NAME u8
+#define KEY_LABEL "uint8"
+#define KEY_MPI MPI_UINT8_T
+#define KEY_FMT "%u"
+#define KEY_CAST(x) (unsigned)(x)
+#define KEY_CE compare_exchange_pairs_u8
+#include "key_template.h"
+
+#define KEY_T uint16_t
+#define KEY_NAME u16
+#define KEY_LABEL "uint16"
+#define KEY_MPI MPI_UINT16_T
+#define KEY_FMT "%u"
+#define KEY_CAST(x) (unsigned)(x)
+#define KEY_CE compare_exchange_pairs_u16
+#include "key_template.h"
+
+/**
+ * @brief Move os payloads para a ordem final, em um único passo: out[i] = in[idx[i]].
+ */
+static inline void apply_payload_permutation(void *out, const void *in, const uint32_t idx[], int n, size_t payload_bytes) {
+    for (int i = 0; i < n; i++) {
+        memcpy((unsigned char *)out + (size_t)i * payload_bytes,
+               (const unsigned char *)in + (size_t)idx[i] * payload_bytes,
+               payload_bytes);
+    }
+}
+
+#endif // KEY_TYPES_H
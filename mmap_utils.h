@@ -0,0 +1,179 @@
+#ifndef MMAP_UTILS_H
+#define MMAP_UTILS_H
+
+// Este arquivo usa extensões do Linux (MAP_POPULATE e copy_file_range): o arquivo
+// que o inclui deve definir _GNU_SOURCE antes do primeiro #include.
+#include <stdio.h>
+#include <stddef.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/*
+ * Entrada e saída por mapeamento de memória (mmap).
+ *
+ * Em vez de gerar dados aleatórios, os executáveis podem ordenar um arquivo binário
+ * bruto de chaves (opção --entrada). O arquivo é mapeado com MAP_SHARED e ordenado
+ * no próprio lugar: não há read() nem cópia para um buffer, e carregar a entrada
+ * custa apenas as faltas de página (antecipadas com MAP_POPULATE e MADV_WILLNEED).
+ * Com --saida, o bloco é primeiro copiado para o arquivo de saída dentro do kernel
+ * (copy_file_range) e a ordenação é feita sobre o mapeamento da saída.
+ *
+ * Cada processo MPI mapeia apenas o seu intervalo de bytes. Como os mapeamentos
+ * começam em múltiplos do tamanho da página, processos vizinhos podem mapear a mesma
+ * página de fronteira; em um único nó o page cache a mantém coerente.
+ */
+
+// Região mapeada: 'base'/'length' descrevem o mapeamento (alinhado à página) e
+// 'data'/'bytes' o intervalo pedido pelo chamador.
+typedef struct {
+    void *base;
+    size_t length;
+    void *data;
+    size_t bytes;
+} mapped_file;
+
+/**
+ * @brief Tamanho de um arquivo em bytes.
+ *
+ * @return long long O tamanho, ou -1 se o arquivo não puder ser consultado.
+ */
+static inline long long file_size_bytes(const char *path) {
+    struct stat st;
+    if (stat(path, &st) != 0) {
+        perror("Falha ao consultar o arquivo de entrada");
+        return -1;
+    }
+    return (long long)st.st_size;
+}
+
+/**
+ * @brief Cria (ou trunca) o arquivo de saída com o tamanho informado.
+ *
+ * @return int Retorna 1 em caso de sucesso, 0 caso contrário.
+ */
+static inline int create_output_file(const char *path, size_t bytes) {
+    int fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        perror("Falha ao criar o arquivo de saída");
+        return 0;
+    }
+    int ok = ftruncate(fd, (off_t)bytes) == 0;
+    if (!ok) perror("Falha ao dimensionar o arquivo de saída");
+    close(fd);
+    return ok;
+}
+
+/**
+ * @brief Copia o intervalo [offset, offset + bytes) de 'input' para a mesma posição
+ * de 'output' sem passar pelo espaço de usuário (copy_file_range). Se o sistema de
+ * arquivos não suportar a chamada, recorre a pread/pwrite.
+ *
+ * @return int Retorna 1 em caso de sucesso, 0 caso contrário.
+ */
+static inline int copy_range(const char *input, const char *output, size_t offset, size_t bytes) {
+    int in_fd = open(input, O_RDONLY);
+    int out_fd = open(output, O_WRONLY);
+    if (in_fd < 0 || out_fd < 0) {
+        perror("Falha ao abrir os arquivos para cópia");
+        if (in_fd >= 0) close(in_fd);
+        if (out_fd >= 0) close(out_fd);
+        return 0;
+    }
+
+    loff_t in_off = (loff_t)offset, out_off = (loff_t)offset;
+    size_t left = bytes;
+    while (left > 0) {
+        ssize_t copied = copy_file_range(in_fd, &in_off, out_fd, &out_off, left, 0);
+        if (copied <= 0) break;
+        left -= (size_t)copied;
+    }
+
+    // Alternativa para sistemas de arquivos sem copy_file_range.
+    char buf[1 << 16];
+    while (left > 0) {
+        size_t chunk = left < sizeof(buf) ? left : sizeof(buf);
+        ssize_t r = pread(in_fd, buf, chunk, in_off);
+        if (r <= 0 || pwrite(out_fd, buf, (size_t)r, out_off) != r) break;
+        in_off += r;
+        out_off += r;
+        left -= (size_t)r;
+    }
+
+    if (left > 0) perror("Falha ao copiar a entrada para o arquivo de saída");
+    close(in_fd);
+    close(out_fd);
+    return left == 0;
+}
+
+/**
+ * @brief Mapeia o intervalo [offset, offset + bytes) de um arquivo para leitura e
+ * escrita compartilhadas: as alterações vão para o próprio arquivo.
+ *
+ * @param path O arquivo a mapear.
+ * @param offset Deslocamento, em bytes, do início do intervalo.
+ * @param bytes Tamanho do intervalo (0 produz uma região vazia).
+ * @param m Região mapeada; 'm->data' aponta para o byte 'offset' do arquivo.
+ * @return int Retorna 1 em caso de sucesso, 0 caso contrário.
+ */
+static inline int map_file_range(const char *path, size_t offset, size_t bytes, mapped_file *m) {
+    memset(m, 0, sizeof(*m));
+    if (bytes == 0) return 1;
+
+    int fd = open(path, O_RDWR);
+    if (fd < 0) {
+        perror("Falha ao abrir o arquivo para mapeamento");
+        return 0;
+    }
+
+    // O deslocamento do mmap precisa ser múltiplo do tamanho da página.
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    size_t aligned = offset - offset % page;
+    size_t delta = offset - aligned;
+
+    int flags = MAP_SHARED;
+#ifdef MAP_POPULATE
+    flags |= MAP_POPULATE; // Antecipa as faltas de página na própria chamada.
+#endif
+    void *base = mmap(NULL, bytes + delta, PROT_READ | PROT_WRITE, flags, fd, (off_t)aligned);
+    close(fd); // O mapeamento continua válido depois do close.
+    if (base == MAP_FAILED) {
+        perror("Falha ao mapear o arquivo");
+        return 0;
+    }
+    // Todas as fases percorrem o bloco inteiro: pede a leitura antecipada de tudo.
+    madvise(base, bytes + delta, MADV_WILLNEED);
+
+    m->base = base;
+    m->length = bytes + delta;
+    m->data = (char *)base + delta;
+    m->bytes = bytes;
+    return 1;
+}
+
+/**
+ * @brief Prepara o intervalo [offset, offset + bytes) para ser ordenado no lugar.
+ * Sem 'output', mapeia o próprio arquivo de entrada; com 'output' (já criado com o
+ * tamanho total por create_output_file), copia o intervalo para ele e mapeia a saída.
+ *
+ * @return int Retorna 1 em caso de sucesso, 0 caso contrário.
+ */
+static inline int map_sort_range(const char *input, const char *output, size_t offset, size_t bytes, mapped_file *m) {
+    if (output != NULL) {
+        if (!copy_range(input, output, offset, bytes)) return 0;
+        return map_file_range(output, offset, bytes, m);
+    }
+    return map_file_range(input, offset, bytes, m);
+}
+
+/**
+ * @brief Desfaz o mapeamento. As alterações já estão no page cache do arquivo.
+ */
+static inline void unmap_file(mapped_file *m) {
+    if (m->base != NULL) munmap(m->base, m->length);
+    memset(m, 0, sizeof(*m));
+}
+
+#endif // MMAP_UTILS_H
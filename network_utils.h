@@ -0,0 +1,100 @@
+#ifndef NETWORK_UTILS_H
+#define NETWORK_UTILS_H
+
+#include <stddef.h>
+
+/*
+ * Redes de ordenação especializadas para arrays pequenos (n <= SORT_NETWORK_MAX).
+ *
+ * O Odd-Even Transposition Sort de n elementos é uma rede de ordenação fixa: n estágios
+ * que alternam os pares (0,1), (2,3), ... e (1,2), (3,4), ... Para n pequeno, o controle
+ * dos laços de phase_odd_even (limites de cada fase, bordas e a chamada indireta do
+ * kernel) custa mais que as próprias comparações. Aqui SORT_NETWORK_DEFINE gera uma
+ * função por tamanho, com todos os limites constantes: o compilador desenrola cada fase
+ * por inteiro, mantém os valores em registradores (todos os índices são constantes) e
+ * faz cada compare-exchange com min/max sem desvios. O resultado é o mesmo das n fases
+ * de odd_even_sort_serial.
+ *
+ * Só os pares de cada fase são desenrolados, não as N/2 iterações do laço de fases:
+ * desenrolar também as fases multiplica o código por N (cerca de 1 MB para os 63
+ * tamanhos) e, com os valores excedentes dos registradores na pilha, não fica mais rápido.
+ *
+ * A função de cada tamanho é escolhida em sort_network_table, indexada por n; o limite
+ * de uso fica com o chamador (ver use_sort_network em oetsort.c).
+ */
+
+// Maior tamanho com rede especializada.
+#define SORT_NETWORK_MAX 64
+
+// Compare-exchange sem desvios do par (i, i+1) de 'v'.
+#define SORT_NETWORK_CE(v, i) do { \
+    int x_ = (v)[i], y_ = (v)[(i) + 1]; \
+    (v)[i] = (x_ < y_) ? x_ : y_; \
+    (v)[(i) + 1] = (x_ < y_) ? y_ : x_; \
+} while (0)
+
+// Gera sort_network_N: as N fases da rede, uma fase par e uma ímpar por iteração para
+// que os dois laços internos comecem em constantes e possam ser desenrolados.
+#define SORT_NETWORK_DEFINE(N) \
+static void sort_network_##N(int arr[]) { \
+    int v[N]; \
+    _Pragma("GCC unroll 64") \
+    for (int i = 0; i < (N); i++) v[i] = arr[i]; \
+    for (int phase = 0; phase < (N); phase += 2) { \
+        _Pragma("GCC unroll 32") \
+        for (int i = 0; i + 1 < (N); i += 2) SORT_NETWORK_CE(v, i); \
+        if (phase + 1 < (N)) { \
+            _Pragma("GCC unroll 32") \
+            for (int i = 1; i + 1 < (N); i += 2) SORT_NETWORK_CE(v, i); \
+        } \
+    } \
+    _Pragma("GCC unroll 64") \
+    for (int i = 0; i < (N); i++) arr[i] = v[i]; \
+}
+
+SORT_NETWORK_DEFINE(2)  SORT_NETWORK_DEFINE(3)  SORT_NETWORK_DEFINE(4)  SORT_NETWORK_DEFINE(5)
+SORT_NETWORK_DEFINE(6)  SORT_NETWORK_DEFINE(7)  SORT_NETWORK_DEFINE(8)  SORT_NETWORK_DEFINE(9)
+SORT_NETWORK_DEFINE(10) SORT_NETWORK_DEFINE(11) SORT_NETWORK_DEFINE(12) SORT_NETWORK_DEFINE(13)
+SORT_NETWORK_DEFINE(14) SORT_NETWORK_DEFINE(15) SORT_NETWORK_DEFINE(16) SORT_NETWORK_DEFINE(17)
+SORT_NETWORK_DEFINE(18) SORT_NETWORK_DEFINE(19) SORT_NETWORK_DEFINE(20) SORT_NETWORK_DEFINE(21)
+SORT_NETWORK_DEFINE(22) SORT_NETWORK_DEFINE(23) SORT_NETWORK_DEFINE(24) SORT_NETWORK_DEFINE(25)
+SORT_NETWORK_DEFINE(26) SORT_NETWORK_DEFINE(27) SORT_NETWORK_DEFINE(28) SORT_NETWORK_DEFINE(29)
+SORT_NETWORK_DEFINE(30) SORT_NETWORK_DEFINE(31) SORT_NETWORK_DEFINE(32) SORT_NETWORK_DEFINE(33)
+SORT_NETWORK_DEFINE(34) SORT_NETWORK_DEFINE(35) SORT_NETWORK_DEFINE(36) SORT_NETWORK_DEFINE(37)
+SORT_NETWORK_DEFINE(38) SORT_NETWORK_DEFINE(39) SORT_NETWORK_DEFINE(40) SORT_NETWORK_DEFINE(41)
+SORT_NETWORK_DEFINE(42) SORT_NETWORK_DEFINE(43) SORT_NETWORK_DEFINE(44) SORT_NETWORK_DEFINE(45)
+SORT_NETWORK_DEFINE(46) SORT_NETWORK_DEFINE(47) SORT_NETWORK_DEFINE(48) SORT_NETWORK_DEFINE(49)
+SORT_NETWORK_DEFINE(50) SORT_NETWORK_DEFINE(51) SORT_NETWORK_DEFINE(52) SORT_NETWORK_DEFINE(53)
+SORT_NETWORK_DEFINE(54) SORT_NETWORK_DEFINE(55) SORT_NETWORK_DEFINE(56) SORT_NETWORK_DEFINE(57)
+SORT_NETWORK_DEFINE(58) SORT_NETWORK_DEFINE(59) SORT_NETWORK_DEFINE(60) SORT_NETWORK_DEFINE(61)
+SORT_NETWORK_DEFINE(62) SORT_NETWORK_DEFINE(63) SORT_NETWORK_DEFINE(64)
+
+// Rede de cada tamanho; NULL para n < 2, que já está ordenado.
+static void (*const sort_network_table[SORT_NETWORK_MAX + 1])(int arr[]) = {
+    NULL, NULL, sort_network_2, sort_network_3, sort_network_4, sort_network_5,
+    sort_network_6, sort_network_7, sort_network_8, sort_network_9, sort_network_10,
+    sort_network_11, sort_network_12, sort_network_13, sort_network_14, sort_network_15,
+    sort_network_16, sort_network_17, sort_network_18, sort_network_19, sort_network_20,
+    sort_network_21, sort_network_22, sort_network_23, sort_network_24, sort_network_25,
+    sort_network_26, sort_network_27, sort_network_28, sort_network_29, sort_network_30,
+    sort_network_31, sort_network_32, sort_network_33, sort_network_34, sort_network_35,
+    sort_network_36, sort_network_37, sort_network_38, sort_network_39, sort_network_40,
+    sort_network_41, sort_network_42, sort_network_43, sort_network_44, sort_network_45,
+    sort_network_46, sort_network_47, sort_network_48, sort_network_49, sort_network_50,
+    sort_network_51, sort_network_52, sort_network_53, sort_network_54, sort_network_55,
+    sort_network_56, sort_network_57, sort_network_58, sort_network_59, sort_network_60,
+    sort_network_61, sort_network_62, sort_network_63, sort_network_64
+};
+
+/**
+ * @brief Ordena 'arr' com a rede especializada do seu tamanho, se houver.
+ *
+ * @return int 1 se o array foi ordenado (n <= SORT_NETWORK_MAX), 0 caso contrário.
+ */
+static inline int sort_network(int arr[], int n) {
+    if (n > SORT_NETWORK_MAX) return 0;
+    if (n >= 2) sort_network_table[n](arr);
+    return 1;
+}
+
+#endif // NETWORK_UTILS_H
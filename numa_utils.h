@@ -0,0 +1,230 @@
+#ifndef NUMA_UTILS_H
+#define NUMA_UTILS_H
+
+// Requer _GNU_SOURCE definido antes dos includes (sched_setaffinity, CPU_SET, sched_getcpu).
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <omp.h>
+
+/*
+ * Posicionamento NUMA da versão OpenMP (--posicionamento=numa).
+ *
+ * Com a política de primeiro toque do Linux, cada página é alocada no nó NUMA da
+ * thread que a escreve primeiro. Se o array é copiado pela thread mestre, todas as
+ * páginas ficam no nó dela e, em uma máquina com dois soquetes, metade das threads
+ * lê memória remota em todas as n fases. Aqui o buffer é alocado sem ser tocado
+ * (mmap) e preenchido por uma cópia paralela com schedule(static): cada thread toca
+ * primeiro o trecho que ela mesma ordena nos backends com schedule estático.
+ *
+ * As threads são fixadas em CPUs distribuídas entre os soquetes em blocos contíguos
+ * (como OMP_PROC_BIND=spread): as threads 0..T/S-1 no primeiro soquete, as seguintes
+ * no segundo, e assim por diante, uma por núcleo físico antes de usar os irmãos SMT.
+ * Assim apenas as fronteiras entre blocos de soquetes diferentes cruzam o soquete.
+ *
+ * A topologia vem do sysfs (/sys/devices/system/cpu), sem depender da libnuma.
+ */
+
+#define NUMA_MAX_NODES 64
+#define NUMA_QUERY_PAGES 4096 // Páginas consultadas por chamada de move_pages.
+
+typedef struct {
+    int cpu;
+    int package;   // Soquete (physical_package_id).
+    int core;      // Núcleo físico dentro do soquete (core_id).
+    int sibling;   // Ordem entre as CPUs do mesmo núcleo (0 = primeira thread SMT).
+    int node;      // Nó NUMA.
+} cpu_info;
+
+// Lê um inteiro de um arquivo do sysfs, ou 'fallback' se ele não existir.
+static inline int read_sysfs_int(const char *path, int fallback) {
+    FILE *fp = fopen(path, "r");
+    if (fp == NULL) return fallback;
+    int value;
+    if (fscanf(fp, "%d", &value) != 1) value = fallback;
+    fclose(fp);
+    return value;
+}
+
+// Nó NUMA da CPU (o diretório da CPU no sysfs contém um link 'nodeX').
+static inline int cpu_node(int cpu) {
+    char path[128];
+    for (int node = 0; node < NUMA_MAX_NODES; node++) {
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/node%d", cpu, node);
+        if (access(path, F_OK) == 0) return node;
+    }
+    return 0;
+}
+
+// Ordem do posicionamento: por soquete, primeiro uma CPU por núcleo físico.
+static inline int compare_cpu_info(const void *a, const void *b) {
+    const cpu_info *x = (const cpu_info *)a;
+    const cpu_info *y = (const cpu_info *)b;
+    if (x->package != y->package) return x->package - y->package;
+    if (x->sibling != y->sibling) return x->sibling - y->sibling;
+    if (x->core != y->core) return x->core - y->core;
+    return x->cpu - y->cpu;
+}
+
+/**
+ * @brief Lista as CPUs que o processo pode usar, na ordem do posicionamento.
+ *
+ * @param out Recebe o array (liberado pelo chamador).
+ * @return int O número de CPUs.
+ */
+static inline int numa_list_cpus(cpu_info **out) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    sched_getaffinity(0, sizeof(set), &set);
+    cpu_info *cpus = malloc((size_t)CPU_COUNT(&set) * sizeof(cpu_info));
+    int count = 0;
+    char path[128];
+    for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+        if (!CPU_ISSET(cpu, &set)) continue;
+        cpu_info *c = &cpus[count++];
+        c->cpu = cpu;
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/topology/physical_package_id", cpu);
+        c->package = read_sysfs_int(path, 0);
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/topology/core_id", cpu);
+        c->core = read_sysfs_int(path, cpu);
+        c->node = cpu_node(cpu);
+        c->sibling = 0;
+        for (int k = 0; k < count - 1; k++) {
+            if (cpus[k].package == c->package && cpus[k].core == c->core) c->sibling++;
+        }
+    }
+    qsort(cpus, count, sizeof(cpu_info), compare_cpu_info);
+    *out = cpus;
+    return count;
+}
+
+/**
+ * @brief Escolhe a CPU de cada thread: a thread t vai para o soquete t * S / T (blocos
+ * contíguos) e, dentro dele, para a próxima CPU na ordem de numa_list_cpus (voltando ao
+ * início se houver mais threads que CPUs no soquete).
+ *
+ * @param plan Recebe o índice em 'cpus' de cada uma das 'num_threads' threads.
+ */
+static inline void numa_plan(const cpu_info cpus[], int count, int num_threads, int plan[]) {
+    // Início e tamanho de cada soquete na lista ordenada.
+    int num_packages = 0;
+    int *first = malloc((size_t)count * sizeof(int));
+    int *size = malloc((size_t)count * sizeof(int));
+    for (int i = 0; i < count; i++) {
+        if (i == 0 || cpus[i].package != cpus[i - 1].package) {
+            first[num_packages] = i;
+            size[num_packages++] = 0;
+        }
+        size[num_packages - 1]++;
+    }
+    int *used = calloc((size_t)num_packages, sizeof(int));
+    for (int t = 0; t < num_threads; t++) {
+        int p = (int)((long long)t * num_packages / num_threads);
+        plan[t] = first[p] + used[p]++ % size[p];
+    }
+    free(first);
+    free(size);
+    free(used);
+}
+
+/**
+ * @brief Fixa cada thread de uma equipe de 'num_threads' na CPU escolhida por numa_plan.
+ * O runtime OpenMP reaproveita as mesmas threads (com os mesmos números) nas regiões
+ * paralelas seguintes com o mesmo número de threads, então a fixação vale também para
+ * as ordenações da biblioteca.
+ */
+static inline void numa_pin_threads(const cpu_info cpus[], const int plan[], int num_threads) {
+    #pragma omp parallel num_threads(num_threads)
+    {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpus[plan[omp_get_thread_num()]].cpu, &set);
+        sched_setaffinity(0, sizeof(set), &set);
+    }
+}
+
+/**
+ * @brief Aloca um buffer de 'n' inteiros sem tocar as páginas (elas só são alocadas
+ * fisicamente no primeiro toque). Liberado com numa_free_ints.
+ *
+ * @return int* O buffer, ou NULL se faltar memória.
+ */
+static inline int *numa_alloc_ints(int n) {
+    void *p = mmap(NULL, (size_t)n * sizeof(int), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    return (p == MAP_FAILED) ? NULL : (int *)p;
+}
+
+static inline void numa_free_ints(int *p, int n) {
+    if (p != NULL) munmap(p, (size_t)n * sizeof(int));
+}
+
+/**
+ * @brief Copia 'src' para 'dst' com schedule(static). Na primeira cópia para um buffer de
+ * numa_alloc_ints, cada página é tocada primeiro pela thread dona daquele trecho.
+ */
+static inline void parallel_copy_ints(int dst[], const int src[], int n, int num_threads) {
+    #pragma omp parallel for schedule(static) num_threads(num_threads)
+    for (int i = 0; i < n; i++) {
+        dst[i] = src[i];
+    }
+}
+
+/**
+ * @brief Imprime, para cada thread, a CPU e o nó em que ela executa e a fração das
+ * páginas do seu trecho de 'arr' (divisão de schedule(static)) que está nesse nó,
+ * consultada com move_pages. Deve ser chamada com as threads já posicionadas.
+ */
+static inline void numa_report(const int arr[], int n, int num_threads) {
+    int *cpu = malloc((size_t)num_threads * sizeof(int));
+    int *node = malloc((size_t)num_threads * sizeof(int));
+    double *local = malloc((size_t)num_threads * sizeof(double));
+    long page = sysconf(_SC_PAGESIZE);
+
+    #pragma omp parallel num_threads(num_threads)
+    {
+        int t = omp_get_thread_num();
+        cpu[t] = sched_getcpu();
+        node[t] = cpu_node(cpu[t]);
+
+        // Trecho da thread na divisão de schedule(static) sem tamanho de bloco.
+        int q = n / num_threads, r = n % num_threads;
+        int from = t * q + (t < r ? t : r);
+        int to = from + q + (t < r ? 1 : 0);
+        uintptr_t begin = ((uintptr_t)(arr + from)) & ~(uintptr_t)(page - 1);
+        uintptr_t end = (uintptr_t)(arr + to);
+
+        void **pages = malloc(NUMA_QUERY_PAGES * sizeof(void *));
+        int *status = malloc(NUMA_QUERY_PAGES * sizeof(int));
+        long total = 0, on_node = 0;
+        int ok = 1;
+        for (uintptr_t a = begin; a < end && ok; ) {
+            int count = 0;
+            for (; count < NUMA_QUERY_PAGES && a < end; count++, a += page) pages[count] = (void *)a;
+            // Com 'nodes' NULL, move_pages apenas informa o nó de cada página.
+            ok = syscall(SYS_move_pages, 0, (unsigned long)count, pages, NULL, status, 0) == 0;
+            for (int k = 0; k < count && ok; k++) {
+                total++;
+                on_node += status[k] == node[t];
+            }
+        }
+        local[t] = (ok && total > 0) ? (double)on_node / total : -1.0;
+        free(pages);
+        free(status);
+    }
+
+    for (int t = 0; t < num_threads; t++) {
+        printf("  Thread %d: CPU %d, nó %d, páginas locais: ", t, cpu[t], node[t]);
+        if (local[t] < 0) printf("indisponível\n");
+        else printf("%.1f%%\n", 100.0 * local[t]);
+    }
+    free(cpu);
+    free(node);
+    free(local);
+}
+
+#endif // NUMA_UTILS_H
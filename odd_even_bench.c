@@ -0,0 +1,392 @@
+#define _GNU_SOURCE // Para strdup (csv_utils.h)
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <mpi.h>
+#include "utils.h"
+#include "bench_utils.h"
+#include "oetsort.h" // Biblioteca com os algoritmos de ordenação
+
+// Máximo de itens nas listas de tamanhos e de threads.
+#define MAX_LIST 32
+
+// Lê uma lista de inteiros positivos separados por vírgula ("1000,5000,10000").
+// Retorna a quantidade lida, ou 0 se a lista for inválida.
+int parse_int_list(const char *spec, int out[], int max) {
+    int count = 0;
+    const char *p = spec;
+    while (*p) {
+        char *end;
+        long value = strtol(p, &end, 10);
+        if (end == p || value < 1 || value > 2147483647L || count == max || (*end != ',' && *end != '\0')) return 0;
+        out[count++] = (int)value;
+        p = (*end == ',') ? end + 1 : end;
+    }
+    return count;
+}
+
+// Marca em 'selected' os backends de uma lista separada por vírgula, com os nomes de
+// oetsort_backend_name() ("serial,openmp-static,mpi-fases"), ou todos os backends
+// disponíveis com "todos". Retorna 0 se algum nome for desconhecido.
+int parse_backend_list(const char *spec, int selected[]) {
+    for (int b = 0; b < OETSORT_NUM_BACKENDS; b++) {
+        selected[b] = strcmp(spec, "todos") == 0 && oetsort_backend_available((oetsort_backend)b);
+    }
+    if (strcmp(spec, "todos") == 0) return 1;
+
+    const char *p = spec;
+    while (*p) {
+        size_t len = strcspn(p, ",");
+        int found = 0;
+        for (int b = 0; b < OETSORT_NUM_BACKENDS; b++) {
+            const char *name = oetsort_backend_name((oetsort_backend)b);
+            if (strlen(name) == len && strncmp(p, name, len) == 0 && oetsort_backend_available((oetsort_backend)b)) {
+                selected[b] = 1;
+                found = 1;
+            }
+        }
+        if (!found) return 0;
+        p += len;
+        if (*p == ',') p++;
+    }
+    return 1;
+}
+
+// Lê uma lista de distribuições separadas por vírgula ("uniforme,invertido").
+// Retorna a quantidade lida, ou 0 se algum nome for desconhecido.
+int parse_distribution_list(const char *spec, oetsort_distribution out[], int max) {
+    int count = 0;
+    const char *p = spec;
+    while (*p) {
+        size_t len = strcspn(p, ",");
+        int found = 0;
+        for (int d = 0; d < OETSORT_NUM_DISTRIBUTIONS && count < max; d++) {
+            const char *name = oetsort_distribution_name((oetsort_distribution)d);
+            if (strlen(name) == len && strncmp(p, name, len) == 0) {
+                out[count++] = (oetsort_distribution)d;
+                found = 1;
+                break;
+            }
+        }
+        if (!found) return 0;
+        p += len;
+        if (*p == ',') p++;
+    }
+    return count;
+}
+
+// Backends em que todos os processos participam, cada um com o seu bloco.
+int is_distributed(oetsort_backend b) {
+    return b == OETSORT_MPI_PHASES || b == OETSORT_MPI_OVERLAP || b == OETSORT_MPI_BLOCKS || b == OETSORT_HYBRID;
+}
+
+// Backends que usam a lista de threads da linha de comando.
+int uses_threads(oetsort_backend b) {
+    return (b >= OETSORT_OPENMP_STATIC && b <= OETSORT_PTHREAD_POOL) || b == OETSORT_HYBRID;
+}
+
+// Backends com modo de chaves compactadas (pack_keys).
+int is_packable(oetsort_backend b) {
+    return b == OETSORT_SERIAL || b == OETSORT_OPENMP_STATIC || b == OETSORT_MPI_PHASES;
+}
+
+// Preenche as colunas Versao e Schedule a partir do nome do backend:
+// "openmp-guided" -> ("openmp", "guided"), "serial" -> ("serial", "-").
+void describe_backend(bench_result *r, oetsort_backend b) {
+    static const char *versions[] = {"serial", "openmp", "pthreads", "mpi"};
+    const char *name = oetsort_backend_name(b);
+    const char *dash = strchr(name, '-');
+    r->backend = name;
+    r->variant = (b == OETSORT_HYBRID) ? "static" : (dash != NULL ? dash + 1 : "-");
+    r->version = (b == OETSORT_HYBRID) ? "hibrido" : name;
+    for (int i = 0; i < 4; i++) {
+        if (strncmp(name, versions[i], strlen(versions[i])) == 0) r->version = versions[i];
+    }
+}
+
+// Mede uma configuração: 'warmups' execuções descartadas seguidas de 'reps' execuções
+// medidas, todas a partir da mesma entrada 'base' (copiada antes de cada execução, fora
+// da medição). Nos backends distribuídos todos os processos ordenam o seu bloco e o tempo
+// de cada repetição é o do processo mais lento; nos demais apenas o rank 0 executa.
+// Cada repetição medida é verificada fora da medição com oetsort_verify: ordem e
+// impressão digital 'expected' da entrada, sem ordenação de referência.
+// Com a biblioteca compilada com contadores, os de cada thread de cada processo são
+// somados nas repetições medidas e reunidos no rank 0 como média por repetição.
+// Preenche os tempos, as estatísticas, a verificação e os contadores de 'r' (no rank 0).
+// Retorna os bytes por chave do modo de chaves compactadas (0 se não compactou).
+int measure(bench_result *r, const int base[], int n, const oetsort_options *opts, const oetsort_fingerprint *expected,
+             int warmups, int reps, int rank, int size) {
+    int distributed = is_distributed(opts->backend);
+    if (!distributed && rank != 0) return 0;
+
+    int local_n = n, displ = 0;
+    if (distributed) {
+        int base_chunk = n / size;
+        int remainder = n % size;
+        local_n = (rank < remainder) ? base_chunk + 1 : base_chunk;
+        displ = rank * base_chunk + (rank < remainder ? rank : remainder);
+    }
+
+    int *work = malloc(local_n * sizeof(int));
+    double *comm = malloc(reps * sizeof(double));
+    double *computation = malloc(reps * sizeof(double));
+    r->samples = malloc(reps * sizeof(double));
+    int sorted = 1, same_keys = 1, packed_bytes = 0;
+    // Contadores das threads deste processo (uma, nos backends sem threads).
+    int local_workers = uses_threads(opts->backend) ? opts->num_threads : 1;
+    oetsort_counters *local_counters = NULL, *rep_counters = NULL;
+    if (oetsort_counters_enabled()) {
+        local_counters = calloc(local_workers, sizeof(oetsort_counters));
+        rep_counters = malloc(local_workers * sizeof(oetsort_counters));
+    }
+
+    for (int it = 0; it < warmups + reps; it++) {
+        memcpy(work, base + displ, local_n * sizeof(int));
+        if (distributed) MPI_Barrier(MPI_COMM_WORLD);
+        double start = MPI_Wtime();
+        oetsort_stats stats;
+        oetsort_sort(work, local_n, opts, &stats);
+        double elapsed = MPI_Wtime() - start;
+        packed_bytes = stats.packed_bytes;
+
+        double t_max = elapsed, comm_sum = stats.comm_time, computation_sum = elapsed - stats.comm_time;
+        if (distributed) {
+            double computation_time = elapsed - stats.comm_time;
+            MPI_Reduce(&elapsed, &t_max, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+            MPI_Reduce(&stats.comm_time, &comm_sum, 1, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+            MPI_Reduce(&computation_time, &computation_sum, 1, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+        }
+        if (it >= warmups) {
+            r->samples[it - warmups] = t_max;
+            comm[it - warmups] = comm_sum;
+            computation[it - warmups] = computation_sum;
+
+            // Nos backends distribuídos a verificação vale para o array global.
+            oetsort_verification v;
+            oetsort_verify(work, local_n, OETSORT_INT32, 0, distributed, expected, &v);
+            sorted = sorted && v.sorted;
+            same_keys = same_keys && v.same_keys;
+
+            if (local_counters != NULL) {
+                // Threads que a biblioteca não usou (rede especializada, neighbor com
+                // menos threads) ficam zeradas.
+                memset(rep_counters, 0, local_workers * sizeof(oetsort_counters));
+                oetsort_last_counters(rep_counters, local_workers);
+                accumulate_counters(local_counters, rep_counters, local_workers);
+            }
+        }
+    }
+
+    if (local_counters != NULL) {
+        average_counters(local_counters, local_workers, reps);
+        int procs = distributed ? size : 1;
+        if (rank == 0) {
+            r->num_counters = procs * local_workers;
+            r->counters = malloc(r->num_counters * sizeof(oetsort_counters));
+        }
+        if (distributed) {
+            MPI_Gather(local_counters, local_workers * (int)sizeof(oetsort_counters), MPI_BYTE,
+                       r->counters, local_workers * (int)sizeof(oetsort_counters), MPI_BYTE, 0, MPI_COMM_WORLD);
+        } else {
+            memcpy(r->counters, local_counters, local_workers * sizeof(oetsort_counters));
+        }
+        free(local_counters);
+        free(rep_counters);
+    }
+
+    if (rank == 0) {
+        compute_bench_stats(r->samples, reps, &r->stats);
+        qsort(comm, reps, sizeof(double), compare_doubles);
+        qsort(computation, reps, sizeof(double), compare_doubles);
+        r->comm_time_sum = sorted_percentile(comm, reps, 0.5);
+        r->computation_time_sum = sorted_percentile(computation, reps, 0.5);
+        r->sorted = sorted;
+        r->same_keys = same_keys;
+    } else {
+        free(r->samples);
+        r->samples = NULL;
+    }
+
+    free(work);
+    free(comm);
+    free(computation);
+    return packed_bytes;
+}
+
+int main(int argc, char *argv[]) {
+    // O backend híbrido exige MPI_THREAD_FUNNELED; os demais funcionam com qualquer nível.
+    int provided;
+    MPI_Init_thread(&argc, &argv, MPI_THREAD_FUNNELED, &provided);
+    int rank, size;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+    // --tamanhos=a,b,c: tamanhos dos arrays.
+    // --threads=a,b,c: threads dos backends OpenMP (e por processo no backend híbrido).
+    // --backends=lista|todos: backends medidos, com os nomes de oetsort_backend_name().
+    //   O backend serial é sempre medido, pois é a referência do speedup.
+    // --dist=a,b,c: distribuições das entradas; --semente, --deslocamentos, --unicos e
+    //   --zipf como nos demais executáveis (ver read_input_options).
+    // --aquecimento=W: execuções descartadas antes das medições de cada configuração.
+    // --repeticoes=N: execuções medidas de cada configuração, sobre a mesma entrada.
+    // --tile=K: tamanho do tile dos backends com ladrilhamento.
+    // --csv=arquivo e --json=arquivo: destino dos resultados.
+    // --contadores=arquivo: destino dos contadores por worker (biblioteca compilada com
+    //   make CONTADORES=1); os mesmos contadores vão também para o JSON.
+    // --compactar: mede também os backends com modo de chaves compactadas com pack_keys
+    //   (coluna Schedule "compactado-8" ou "compactado-16"), quando o intervalo cabe.
+    // --kernel: força o kernel de compare-exchange (auto, avx512, avx2 ou escalar).
+    int sizes[MAX_LIST], threads[MAX_LIST];
+    int num_sizes = parse_int_list(get_option(argc, argv, "tamanhos", "1000,5000,10000"), sizes, MAX_LIST);
+    int num_threads = parse_int_list(get_option(argc, argv, "threads", "1,2,4"), threads, MAX_LIST);
+    oetsort_distribution dists[OETSORT_NUM_DISTRIBUTIONS];
+    int num_dists = parse_distribution_list(get_option(argc, argv, "dist", "uniforme"), dists, OETSORT_NUM_DISTRIBUTIONS);
+    oetsort_input input;
+    oetsort_default_input(&input);
+    input.seed = strtoull(get_option(argc, argv, "semente", "1"), NULL, 10);
+    input.displacements = atoll(get_option(argc, argv, "deslocamentos", "0"));
+    input.unique = atoi(get_option(argc, argv, "unicos", "16"));
+    input.zipf_s = atof(get_option(argc, argv, "zipf", "1.0"));
+    int input_ok = num_dists > 0 && input.displacements >= 0 && input.unique >= 1 && input.zipf_s > 0.0;
+    int selected[OETSORT_NUM_BACKENDS];
+    int backends_ok = parse_backend_list(get_option(argc, argv, "backends", "todos"), selected);
+    int warmups = atoi(get_option(argc, argv, "aquecimento", "1"));
+    int reps = atoi(get_option(argc, argv, "repeticoes", "10"));
+    int tile = atoi(get_option(argc, argv, "tile", "1024"));
+    const char *csv_path = get_option(argc, argv, "csv", "data/bench.csv");
+    const char *json_path = get_option(argc, argv, "json", "data/bench.json");
+    const char *counters_path = get_option(argc, argv, "contadores", "data/contadores.csv");
+    int compact = has_flag(argc, argv, "compactar");
+    int kernel_ok = oetsort_set_kernel(get_option(argc, argv, "kernel", "auto")) == OETSORT_OK;
+
+    int sizes_ok = num_sizes > 0;
+    for (int i = 0; i < num_sizes; i++) {
+        if (sizes[i] < size) sizes_ok = 0; // Cada processo precisa de pelo menos um elemento.
+    }
+    if (count_positional_args(argc, argv) != 1 || !sizes_ok || num_threads == 0 || !backends_ok || !input_ok ||
+        warmups < 0 || reps < 1 || tile < 2 || !kernel_ok) {
+        if (rank == 0) {
+            printf("Uso: [mpirun -np <num_procs>] %s [--tamanhos=1000,5000,10000] [--threads=1,2,4] [--backends=todos|serial,openmp-static,...]\n", argv[0]);
+            printf("       [--dist=uniforme,ordenado,invertido,quase-ordenado,poucos-unicos,zipf,tubos-de-orgao] [--semente=S]\n");
+            printf("       [--deslocamentos=K] [--unicos=U] [--zipf=s]\n");
+            printf("       [--aquecimento=W] [--repeticoes=N] [--tile=K] [--csv=arquivo] [--json=arquivo] [--kernel=auto|avx512|avx2|escalar]\n");
+            printf("       [--contadores=arquivo] [--compactar]\n");
+        }
+        MPI_Finalize();
+        return 1;
+    }
+
+    // Os backends de memória compartilhada rodam apenas no rank 0; com mais processos,
+    // os demais ficariam disputando os núcleos com as threads OpenMP.
+    int skip_shared = 0;
+    for (int b = 0; b < OETSORT_NUM_BACKENDS; b++) {
+        if (selected[b] && uses_threads((oetsort_backend)b) && !is_distributed((oetsort_backend)b) && size > 1) {
+            selected[b] = 0;
+            skip_shared = 1;
+        }
+    }
+
+    if (rank == 0) {
+        printf("--- Configuração ---\n");
+        printf("Processos: %d\n", size);
+        printf("Kernel: %s\n", oetsort_kernel_name());
+        printf("Chaves compactadas: %s\n", compact ? "Sim (serial, openmp-static e mpi-fases)" : "Não");
+        printf("Contadores: %s\n", oetsort_counters_enabled() ? "Sim" : "Não (compile com make CONTADORES=1)");
+        printf("Semente: %llu\n", (unsigned long long)input.seed);
+        printf("Aquecimento: %d, repetições: %d\n", warmups, reps);
+        if (skip_shared) printf("Aviso: backends OpenMP ignorados com mais de um processo (execute sem mpirun para medi-los).\n");
+        printf("\n");
+    }
+
+    bench_result *results = calloc((size_t)num_sizes * num_dists * OETSORT_NUM_BACKENDS * num_threads * (compact ? 2 : 1), sizeof(bench_result));
+    int count = 0;
+    int all_sorted = 1;
+
+    for (int s = 0; s < num_sizes * num_dists; s++) {
+        int n = sizes[s / num_dists];
+        input.dist = dists[s % num_dists];
+        // A mesma entrada é usada por todas as configurações deste tamanho e distribuição.
+        // O gerador é determinístico: cada processo gera o mesmo array, sem MPI_Bcast.
+        int *base = malloc(n * sizeof(int));
+        oetsort_generate(base, n, 0, n, OETSORT_INT32, &input);
+        oetsort_fingerprint expected;
+        oetsort_fingerprint_keys(base, n, OETSORT_INT32, 0, 0, &expected);
+
+        double serial_median = 0.0;
+        for (int b = 0; b < OETSORT_NUM_BACKENDS; b++) {
+            oetsort_backend backend = (oetsort_backend)b;
+            if (backend != OETSORT_SERIAL && !selected[b]) continue;
+            int tiled = backend == OETSORT_SERIAL_TILED || backend == OETSORT_OPENMP_TILED;
+
+            for (int t = 0; t < (uses_threads(backend) ? num_threads : 1); t++) {
+                // Com --compactar, a segunda passagem mede o backend com pack_keys.
+                for (int pack = 0; pack <= (compact && is_packable(backend)); pack++) {
+                    oetsort_options opts;
+                    oetsort_default_options(&opts);
+                    opts.backend = backend;
+                    opts.num_threads = uses_threads(backend) ? threads[t] : 1;
+                    opts.tile = tiled ? tile : 0;
+                    opts.pack_keys = pack;
+
+                    bench_result *r = &results[count++];
+                    int packed = measure(r, base, n, &opts, &expected, warmups, reps, rank, size);
+                    if (rank != 0) continue;
+                    if (pack && packed == 0) {
+                        // Intervalo largo demais: seria a mesma medição da primeira passagem.
+                        free(r->samples);
+                        free(r->counters);
+                        memset(r, 0, sizeof(*r));
+                        count--;
+                        continue;
+                    }
+
+                    describe_backend(r, backend);
+                    if (pack) r->variant = (packed == 1) ? "compactado-8" : "compactado-16";
+                    r->distribution = oetsort_distribution_name(input.dist);
+                    r->seed = (unsigned long long)input.seed;
+                    r->n = n;
+                    r->processes = is_distributed(backend) ? size : 1;
+                    r->threads = opts.num_threads;
+                    r->workers = r->processes * r->threads;
+                    r->tile = opts.tile;
+                    if (backend == OETSORT_SERIAL && !pack) serial_median = r->stats.median;
+                    r->speedup = serial_median / r->stats.median;
+                    r->efficiency = r->speedup / r->workers;
+                    all_sorted = all_sorted && r->sorted && r->same_keys;
+
+                    printf("%-15s %-14s n=%-8d p=%-3d t=%-3d mediana=%.6f s  min=%.6f s  p95=%.6f s  IC95=[%.6f, %.6f]  speedup=%.3f%s%s\n",
+                           r->backend, r->distribution, n, r->processes, r->threads, r->stats.median, r->stats.min, r->stats.p95,
+                           r->stats.ci_low, r->stats.ci_high, r->speedup,
+                           !pack ? "" : (packed == 1 ? "  (chaves em 8 bits)" : "  (chaves em 16 bits)"),
+                           !r->sorted ? "  (NÃO ORDENADO)" : (!r->same_keys ? "  (ELEMENTOS ALTERADOS)" : ""));
+                    save_bench_csv(csv_path, r, oetsort_kernel_name(), warmups);
+                    if (r->counters != NULL) {
+                        long long swaps;
+                        double max_wait, ipc;
+                        summarize_counters(r, &swaps, &max_wait, &ipc);
+                        printf("%-15s contadores: trocas=%lld  espera máx=%.6f s  IPC=", "", swaps, max_wait);
+                        if (ipc < 0) printf("indisponível\n");
+                        else printf("%.3f\n", ipc);
+                        save_counters_csv(counters_path, r, oetsort_kernel_name());
+                    }
+                }
+            }
+        }
+        free(base);
+    }
+
+    if (rank == 0) {
+        save_bench_json(json_path, results, count, oetsort_kernel_name(), warmups);
+        printf("\nResultados salvos em '%s' e '%s'.\n", csv_path, json_path);
+        if (oetsort_counters_enabled()) printf("Contadores salvos em '%s'.\n", counters_path);
+        printf("Todos os resultados ordenados: %s\n", all_sorted ? "Sim" : "Não");
+        for (int i = 0; i < count; i++) {
+            free(results[i].samples);
+            free(results[i].counters);
+        }
+    }
+    free(results);
+
+    MPI_Finalize();
+    return all_sorted ? 0 : 1;
+}
@@ -0,0 +1,316 @@
+#define _GNU_SOURCE // Para MAP_POPULATE e copy_file_range (mmap_utils.h)
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <mpi.h>
+#include "utils.h"
+#include "csv_utils.h"
+#include "mmap_utils.h"
+#include "baseline_utils.h"
+#include "oetsort.h" // Biblioteca com os algoritmos de ordenação
+
+// Lê a quantidade de threads do processo 'rank' a partir da especificação da linha
+// de comando: um único número ("4") vale para todos os processos; uma lista separada
+// por ':' ("4:4:2:2") dá a quantidade de cada processo, repetindo-se ciclicamente.
+// Retorna 0 se a especificação for inválida.
+int threads_for_rank(const char *spec, int rank) {
+    int count = 1;
+    for (const char *c = spec; *c; c++) {
+        if (*c == ':') count++;
+    }
+    int index = rank % count;
+    const char *p = spec;
+    for (int i = 0; i < index; i++) {
+        p = strchr(p, ':') + 1;
+    }
+    return atoi(p);
+}
+
+// Ordena um arquivo binário bruto de inteiros (--entrada) como em odd_even_mpi: cada
+// processo mapeia apenas o intervalo de bytes do seu bloco e o ordena no lugar com o
+// backend híbrido, sem MPI_Scatterv nem MPI_Allgatherv. Não há execução serial nem
+// escrita no CSV. Retorna 1 se o arquivo resultante estiver ordenado e for uma
+// permutação da entrada.
+int run_file_hybrid(const char *input, const char *output, int num_threads, const char *spec, oetsort_exchange exchange, int rank, int size) {
+    long long bytes = file_size_bytes(input);
+    if (bytes < 0 || bytes % sizeof(int) != 0 || bytes / sizeof(int) > 2147483647LL || bytes / (long long)sizeof(int) < size) {
+        if (rank == 0 && bytes >= 0) printf("O arquivo '%s' deve conter um array de pelo menos %d inteiros de 32 bits.\n", input, size);
+        return 0;
+    }
+    int n = (int)(bytes / sizeof(int));
+    int base_chunk = n / size;
+    int remainder = n % size;
+    int local_n = (rank < remainder) ? base_chunk + 1 : base_chunk;
+    long long first = (long long)rank * base_chunk + (rank < remainder ? rank : remainder);
+
+    int ok = 1;
+    if (rank == 0 && output != NULL) ok = create_output_file(output, (size_t)bytes);
+    MPI_Bcast(&ok, 1, MPI_INT, 0, MPI_COMM_WORLD);
+    if (!ok) return 0;
+
+    mapped_file m;
+    ok = map_sort_range(input, output, (size_t)first * sizeof(int), (size_t)local_n * sizeof(int), &m);
+    int all_ok;
+    MPI_Allreduce(&ok, &all_ok, 1, MPI_INT, MPI_LAND, MPI_COMM_WORLD);
+    if (!all_ok) {
+        if (ok) unmap_file(&m);
+        return 0;
+    }
+    int *local_arr = (int *)m.data;
+
+    // Impressão digital global da entrada, calculada pelas threads de cada processo.
+    oetsort_fingerprint expected;
+    oetsort_fingerprint_keys(local_arr, local_n, OETSORT_INT32, num_threads, 1, &expected);
+
+    MPI_Barrier(MPI_COMM_WORLD);
+    double total_start = MPI_Wtime();
+    oetsort_options opts;
+    oetsort_default_options(&opts);
+    opts.backend = OETSORT_HYBRID;
+    opts.num_threads = num_threads;
+    opts.exchange = exchange;
+    oetsort_stats stats;
+    oetsort_sort(local_arr, local_n, &opts, &stats);
+    MPI_Barrier(MPI_COMM_WORLD);
+    double total_time = MPI_Wtime() - total_start;
+
+    // Verificação distribuída: ordem global e impressão digital da entrada.
+    oetsort_verification v;
+    oetsort_verify(local_arr, local_n, OETSORT_INT32, num_threads, 1, &expected, &v);
+
+    double t_parallel, comm_time_sum;
+    MPI_Reduce(&total_time, &t_parallel, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+    MPI_Reduce(&stats.comm_time, &comm_time_sum, 1, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+
+    if (rank == 0) {
+        printf("--- Configuração ---\n");
+        printf("Entrada: %s (%d elementos)\n", input, n);
+        printf("Saída: %s\n", output != NULL ? output : "no próprio arquivo de entrada");
+        printf("Processos: %d\n", size);
+        printf("Threads por processo: %s\n", spec);
+        printf("Troca: %s\n", oetsort_exchange_name(exchange));
+        printf("Kernel: %s\n\n", oetsort_kernel_name());
+
+        printf("--- Resultados ---\n");
+        printf("Tempo Total (max): %.6f s\n", t_parallel);
+        printf("Tempo de Comunicação (soma): %.6f s\n", comm_time_sum);
+        printf("Array está ordenado: %s\n", v.sorted ? "Sim" : "Não");
+        printf("Mesmos elementos da entrada: %s\n", v.same_keys ? "Sim" : "Não");
+    }
+
+    unmap_file(&m);
+    return v.sorted && v.same_keys;
+}
+
+int main(int argc, char *argv[]) {
+    // Inicializa o ambiente MPI. Apenas a thread mestre de cada processo faz chamadas MPI.
+    int provided;
+    MPI_Init_thread(&argc, &argv, MPI_THREAD_FUNNELED, &provided);
+    int rank, size;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank); // Obtém o rank (ID) do processo atual.
+    MPI_Comm_size(MPI_COMM_WORLD, &size); // Obtém o número total de processos.
+
+    // Validação dos argumentos de linha de comando.
+    // <threads_por_processo>: um número para todos os processos ou uma lista "4:4:2:2".
+    // --kernel: força o kernel de compare-exchange (auto, avx512, avx2 ou escalar).
+    int kernel_ok = oetsort_set_kernel(get_option(argc, argv, "kernel", "auto")) == OETSORT_OK;
+    // --dist, --semente, --deslocamentos, --unicos e --zipf: distribuição da entrada gerada.
+    oetsort_input input;
+    int input_ok = read_input_options(argc, argv, &input);
+    // --entrada=arquivo [--saida=arquivo]: ordena um arquivo binário de inteiros de 32 bits
+    // mapeado em memória (cada processo mapeia apenas o seu intervalo); sem <tamanho_array>.
+    const char *input_path = get_option(argc, argv, "entrada", NULL);
+    const char *output_path = get_option(argc, argv, "saida", NULL);
+    int file_mode = input_path != NULL;
+    // --medir-serial: mede a linha de base serial mesmo que ela esteja no cache (baseline_utils.h).
+    int measure_serial = has_flag(argc, argv, "medir-serial");
+    // --rastro=arquivo.json: grava o rastro por fase, com um processo por rank e uma linha
+    // por thread (trace_utils.h); --rastro-cada=K: registra uma fase a cada K (0 = automático).
+    const char *trace_path = get_option(argc, argv, "rastro", NULL);
+    int trace_every = atoi(get_option(argc, argv, "rastro-cada", "0"));
+    // --troca=sendrecv|persistente|rma|rma-pscw: motor de troca do elemento de fronteira
+    // (exchange_utils.h). Com a opção, os tempos vão também para 'mpi_troca.csv'.
+    const char *exchange_opt = get_option(argc, argv, "troca", NULL);
+    oetsort_exchange exchange = OETSORT_EXCHANGE_SENDRECV;
+    int exchange_ok = exchange_opt == NULL || oetsort_exchange_from_name(exchange_opt, &exchange) == OETSORT_OK;
+    const char *spec = file_mode ? argv[1] : argv[2];
+    int num_threads = (count_positional_args(argc, argv) == (file_mode ? 2 : 3)) ? threads_for_rank(spec, rank) : 0;
+    if ((output_path != NULL && !file_mode) || (trace_path != NULL && file_mode) || trace_every < 0) num_threads = 0;
+    int min_threads;
+    MPI_Allreduce(&num_threads, &min_threads, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+    if (min_threads < 1 || !kernel_ok || !input_ok || !exchange_ok) {
+        if (rank == 0) {
+            printf("Uso: mpirun -np <num_procs> %s <tamanho_array> <threads_por_processo> [--kernel=auto|avx512|avx2|escalar]\n", argv[0]);
+            printf("       mpirun -np <num_procs> %s <threads_por_processo> --entrada=arquivo.bin [--saida=arquivo.bin]\n", argv[0]);
+            printf("Entrada gerada: [--dist=uniforme|ordenado|invertido|quase-ordenado|poucos-unicos|zipf|tubos-de-orgao] [--semente=S]\n");
+            printf("                [--deslocamentos=K] [--unicos=U] [--zipf=s]\n");
+            printf("Linha de base: [--medir-serial] (ignora o cache de linha de base)\n");
+            printf("Rastro por fase: [--rastro=arquivo.json] [--rastro-cada=K] (sem --entrada)\n");
+            printf("Troca de fronteira: [--troca=sendrecv|persistente|rma|rma-pscw]\n");
+        }
+        MPI_Finalize();
+        return 1;
+    }
+    if (provided < MPI_THREAD_FUNNELED && rank == 0) {
+        printf("Aviso: a implementação MPI não garante MPI_THREAD_FUNNELED.\n");
+    }
+
+    // Entrada por arquivo mapeado em memória, sem distribuição pelo rank 0.
+    if (file_mode) {
+        int ok = run_file_hybrid(input_path, output_path, num_threads, spec, exchange, rank, size);
+        MPI_Finalize();
+        return ok ? 0 : 1;
+    }
+
+    int n = atoi(argv[1]);
+    // Todo processo precisa de ao menos um elemento (a biblioteca recusa blocos vazios).
+    if (n < size) {
+        if (rank == 0) printf("O tamanho do array deve ser pelo menos o número de processos (%d).\n", size);
+        MPI_Finalize();
+        return 1;
+    }
+
+    // --- Lógica para Distribuição Desigual de Dados ---
+    int base_chunk = n / size;
+    int remainder = n % size;
+    int local_n = (rank < remainder) ? base_chunk + 1 : base_chunk;
+
+    int *local_arr = (int*)malloc(local_n * sizeof(int));
+    // O array completo existe apenas no rank 0, que gera a entrada e recebe o resultado.
+    int *arr = (rank == 0) ? (int*)malloc(n * sizeof(int)) : NULL;
+    double t_serial = 0.0;
+    // Impressão digital da entrada (no rank 0), para verificar o resultado reunido.
+    oetsort_fingerprint expected;
+
+    int *sendcounts = malloc(size * sizeof(int));
+    int *displs = malloc(size * sizeof(int));
+    int current_displ = 0;
+    for (int i = 0; i < size; i++) {
+        sendcounts[i] = (i < remainder) ? base_chunk + 1 : base_chunk;
+        displs[i] = current_displ;
+        current_displ += sendcounts[i];
+    }
+
+    // Total de threads de todos os processos, usado no cálculo da eficiência.
+    int total_threads;
+    MPI_Reduce(&num_threads, &total_threads, 1, MPI_INT, MPI_SUM, 0, MPI_COMM_WORLD);
+
+    // O processo raiz (rank 0) inicializa o array e calcula o tempo serial.
+    if (rank == 0) {
+        oetsort_generate(arr, n, 0, n, OETSORT_INT32, &input);
+        oetsort_fingerprint_keys(arr, n, OETSORT_INT32, num_threads, 0, &expected);
+
+        printf("--- Configuração ---\n");
+        printf("Tamanho do array: %d\n", n);
+        printf("Entrada: %s (semente %llu)\n", oetsort_distribution_name(input.dist), (unsigned long long)input.seed);
+        printf("Processos: %d\n", size);
+        printf("Threads por processo: %s (total: %d)\n", argv[2], total_threads);
+        printf("Troca: %s\n", oetsort_exchange_name(exchange));
+        printf("Kernel: %s\n\n", oetsort_kernel_name());
+
+        printf("--- Array Original ---\n");
+        print_array(arr, n > 20 ? 20 : n);
+        if (n > 20) printf("(exibindo apenas os 20 primeiros elementos)\n");
+        printf("\n");
+
+        // Tempo serial: do cache de linha de base (baseline_utils.h) ou medido aqui.
+        printf("--- Serial ---\n");
+        if (!measure_serial && baseline_lookup("odd-even", n, &input, &t_serial)) {
+            printf("Tempo de execução: %.6f segundos (cache de linha de base)\n", t_serial);
+        } else {
+            int *arr_serial_copy = (int*)malloc(n * sizeof(int));
+            memcpy(arr_serial_copy, arr, n * sizeof(int));
+            double start_serial = MPI_Wtime();
+            oetsort_sort(arr_serial_copy, n, NULL, NULL);
+            double end_serial = MPI_Wtime();
+            t_serial = end_serial - start_serial;
+
+            printf("Tempo de execução: %.6f segundos\n", t_serial);
+            if (report_verification("", arr_serial_copy, n, &expected)) baseline_store("odd-even", n, &input, t_serial);
+            free(arr_serial_copy);
+        }
+        printf("\n");
+    }
+
+    MPI_Bcast(&t_serial, 1, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+
+    MPI_Scatterv(arr, sendcounts, displs, MPI_INT,
+                 local_arr, local_n, MPI_INT,
+                 0, MPI_COMM_WORLD);
+
+    // Sincroniza todos os processos antes de iniciar a medição do tempo paralelo.
+    if (trace_path != NULL) oetsort_trace_start(trace_every, 0);
+    MPI_Barrier(MPI_COMM_WORLD);
+    double total_start = MPI_Wtime();
+
+    // Fases globais do modo 'fases' do MPI com a fase local de cada processo dividida
+    // entre as threads OpenMP; a troca de fronteira é feita pela thread mestre.
+    oetsort_options opts;
+    oetsort_default_options(&opts);
+    opts.backend = OETSORT_HYBRID;
+    opts.num_threads = num_threads;
+    opts.exchange = exchange;
+    oetsort_stats stats;
+    oetsort_sort(local_arr, local_n, &opts, &stats);
+    double comm_time = stats.comm_time; // Tempo de comunicação da thread mestre.
+
+    MPI_Barrier(MPI_COMM_WORLD);
+    double total_end = MPI_Wtime();
+    double total_time = total_end - total_start;
+    double computation_time = total_time - comm_time;
+
+    MPI_Gatherv(local_arr, local_n, MPI_INT,
+                arr, sendcounts, displs, MPI_INT,
+                0, MPI_COMM_WORLD);
+
+    double t_parallel, comm_time_sum, computation_time_sum;
+    MPI_Reduce(&total_time, &t_parallel, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+    MPI_Reduce(&comm_time, &comm_time_sum, 1, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+    MPI_Reduce(&computation_time, &computation_time_sum, 1, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+    if (trace_path != NULL) {
+        int err = oetsort_trace_stop(trace_path, 1);
+        if (rank == 0 && err == OETSORT_OK) printf("Rastro por fase salvo em '%s'\n\n", trace_path);
+        if (rank == 0 && err != OETSORT_OK) fprintf(stderr, "Falha ao gravar o rastro em '%s'\n", trace_path);
+    }
+
+    if (rank == 0) {
+        printf("--- Análise de Performance Híbrida (MPI + OpenMP) ---\n");
+        printf("Array ordenado: ");
+        print_array(arr, n > 20 ? 20 : n);
+        if (n > 20) printf("(exibindo apenas os 20 primeiros elementos)\n");
+        report_verification("", arr, n, &expected);
+        printf("\n");
+
+        // Mesmas métricas da versão MPI; a eficiência é dividida pelo total de threads.
+        double t_computation_avg = computation_time_sum / size;
+        double overhead_abs = t_parallel - t_computation_avg;
+        double overhead_rel = (comm_time_sum / (computation_time_sum + comm_time_sum)) * 100;
+        double comm_efficiency = computation_time_sum / (computation_time_sum + comm_time_sum);
+        double speedup = t_serial / t_parallel;
+        double efficiency = speedup / total_threads;
+
+        printf("Tempo Total (max): %.6f s\n", t_parallel);
+        printf("Tempo de Computação (soma): %.6f s\n", computation_time_sum);
+        printf("Tempo de Comunicação (soma): %.6f s\n", comm_time_sum);
+        if (exchange == OETSORT_EXCHANGE_RMA) printf("Janela de memória compartilhada: %s\n", stats.shared_window ? "Sim" : "Não");
+        printf("Overhead Absoluto: %.6f s\n", overhead_abs);
+        printf("Overhead Relativo: %.2f%%\n", overhead_rel);
+        printf("Eficiência de Comunicação: %.4f\n", comm_efficiency);
+        printf("Speedup: %.4f\n", speedup);
+        printf("Eficiência: %.4f\n", efficiency);
+
+        save_hybrid_result(results_path("hybrid.csv", &input), n, size, argv[2], total_threads, "static", t_parallel, computation_time_sum, comm_time_sum, overhead_abs, overhead_rel, comm_efficiency, speedup, efficiency);
+        if (exchange_opt != NULL) {
+            save_exchange_result(results_path("mpi_troca.csv", &input), n, size, "hibrido", oetsort_exchange_name(exchange), stats.shared_window,
+                                 t_parallel, computation_time_sum, comm_time_sum, speedup);
+        }
+    }
+
+    free(arr);
+    free(local_arr);
+    free(sendcounts);
+    free(displs);
+
+    MPI_Finalize();
+    return 0;
+}
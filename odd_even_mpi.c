@@ -1,55 +1,332 @@
+#define _GNU_SOURCE // Para MAP_POPULATE e copy_file_range (mmap_utils.h)
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <mpi.h> 
 #include "utils.h" 
 #include "csv_utils.h" 
+#include "mmap_utils.h"
+#include "baseline_utils.h"
+#include "partition_utils.h"
+#include "oetsort.h" // Biblioteca com os algoritmos de ordenação
 
-// Função para trocar dois elementos de posição.
-void swap(int *a, int *b) {
-    int temp = *a;
-    *a = *b;
-    *b = temp;
+// Executa o modo 'fases' com um tipo de chave genérico (--tipo) e, se payload_bytes > 0,
+// com registros chave + payload (--payload). Chaves e índices dos registros são
+// distribuídos com o datatype MPI do tipo e com MPI_UINT32_T; o payload nunca sai do
+// processo raiz, que o move uma única vez depois de reunir os índices ordenados.
+// Retorna 1 se os resultados estiverem corretos (significativo apenas no rank 0).
+int run_typed_mpi(oetsort_key_type type, int n, int rank, int size, int payload_bytes, const oetsort_input *input) {
+    size_t key_size = oetsort_key_size(type);
+    // Partição uniforme, a mesma do caminho int sem --particao/--pesos.
+    partition_plan plan;
+    partition_plan_init(&plan, NULL, NULL, NULL, n, input, rank, size);
+    int *sendcounts = plan.counts;
+    int *displs = plan.displs;
+    int local_n = sendcounts[rank];
+
+    void *local_keys = malloc((size_t)local_n * key_size);
+    uint32_t *local_idx = (payload_bytes > 0) ? malloc((size_t)local_n * sizeof(uint32_t)) : NULL;
+    void *keys = NULL, *keys_base = NULL, *payload = NULL, *sorted_payload = NULL;
+    uint32_t *idx = NULL;
+    double t_serial = 0.0;
+    int ok = 1;
+    oetsort_fingerprint expected; // Impressão digital da entrada (no rank 0).
+
+    if (rank == 0) {
+        keys = malloc((size_t)n * key_size);
+        keys_base = malloc((size_t)n * key_size);
+        oetsort_generate(keys_base, n, 0, n, type, input);
+        oetsort_fingerprint_keys(keys_base, n, type, 0, 0, &expected);
+        memcpy(keys, keys_base, (size_t)n * key_size);
+        if (payload_bytes > 0) {
+            idx = malloc((size_t)n * sizeof(uint32_t));
+            payload = malloc((size_t)n * payload_bytes);
+            sorted_payload = malloc((size_t)n * payload_bytes);
+            fill_payload(payload, n, payload_bytes);
+            init_record_indices(idx, n);
+        }
+
+        printf("--- Configuração ---\n");
+        printf("Tamanho do array: %d\n", n);
+        printf("Processos: %d\n", size);
+        printf("Modo: fases\n");
+        printf("Entrada: %s (semente %llu)\n", oetsort_distribution_name(input->dist), (unsigned long long)input->seed);
+        printf("Tipo da chave: %s\n", oetsort_key_type_name(type));
+        printf("Payload: %d bytes por registro\n\n", payload_bytes);
+
+        // Linha de base serial do mesmo tipo, incluindo a movimentação do payload.
+        double start_serial = MPI_Wtime();
+        oetsort_sort_keys(keys, idx, n, type, NULL, NULL);
+        if (payload_bytes > 0) oetsort_apply_permutation(sorted_payload, payload, idx, n, payload_bytes);
+        t_serial = MPI_Wtime() - start_serial;
+
+        int serial_ok = verify_keys(keys, n, type, &expected);
+        if (payload_bytes > 0) {
+            serial_ok = serial_ok && verify_records(keys, keys_base, key_size, sorted_payload, idx, n, payload_bytes);
+        }
+        printf("--- Serial ---\n");
+        printf("Tempo de execução: %.6f segundos\n", t_serial);
+        printf("Array está ordenado: %s\n\n", serial_ok ? "Sim" : "Não");
+        ok = serial_ok;
+
+        // Restaura a entrada original para a versão paralela.
+        memcpy(keys, keys_base, (size_t)n * key_size);
+        if (payload_bytes > 0) init_record_indices(idx, n);
+    }
+
+    MPI_Datatype key_type = oetsort_key_mpi_type(type);
+    MPI_Scatterv(keys, sendcounts, displs, key_type, local_keys, local_n, key_type, 0, MPI_COMM_WORLD);
+    if (payload_bytes > 0) {
+        MPI_Scatterv(idx, sendcounts, displs, MPI_UINT32_T, local_idx, local_n, MPI_UINT32_T, 0, MPI_COMM_WORLD);
+    }
+
+    MPI_Barrier(MPI_COMM_WORLD);
+    double total_start = MPI_Wtime();
+    oetsort_options opts;
+    oetsort_default_options(&opts);
+    opts.backend = OETSORT_MPI_PHASES;
+    oetsort_stats stats;
+    oetsort_sort_keys(local_keys, local_idx, local_n, type, &opts, &stats);
+    double comm_time = stats.comm_time;
+
+    MPI_Barrier(MPI_COMM_WORLD);
+    double total_time = MPI_Wtime() - total_start;
+
+    MPI_Gatherv(local_keys, local_n, key_type, keys, sendcounts, displs, key_type, 0, MPI_COMM_WORLD);
+    if (payload_bytes > 0) {
+        MPI_Gatherv(local_idx, local_n, MPI_UINT32_T, idx, sendcounts, displs, MPI_UINT32_T, 0, MPI_COMM_WORLD);
+    }
+
+    double t_parallel, comm_time_sum;
+    MPI_Reduce(&total_time, &t_parallel, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+    MPI_Reduce(&comm_time, &comm_time_sum, 1, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+
+    if (rank == 0) {
+        // A movimentação do payload no raiz faz parte do tempo paralelo.
+        double start_payload = MPI_Wtime();
+        if (payload_bytes > 0) oetsort_apply_permutation(sorted_payload, payload, idx, n, payload_bytes);
+        t_parallel += MPI_Wtime() - start_payload;
+
+        int parallel_ok = verify_keys(keys, n, type, &expected);
+        if (payload_bytes > 0) {
+            parallel_ok = parallel_ok && verify_records(keys, keys_base, key_size, sorted_payload, idx, n, payload_bytes);
+        }
+        ok = ok && parallel_ok;
+
+        double speedup = t_serial / t_parallel;
+        double efficiency = speedup / size;
+        printf("--- Análise de Performance MPI ---\n");
+        printf("Array ordenado: ");
+        oetsort_print_keys(keys, n > 20 ? 20 : n, type);
+        if (n > 20) printf("(exibindo apenas os 20 primeiros elementos)\n");
+        printf("Array está ordenado%s: %s\n\n", payload_bytes > 0 ? " (e registros íntegros)" : " (e permutação da entrada)", parallel_ok ? "Sim" : "Não");
+        printf("Tempo Total (max): %.6f s\n", t_parallel);
+        printf("Tempo de Comunicação (soma): %.6f s\n", comm_time_sum);
+        printf("Speedup: %.4f\n", speedup);
+        printf("Eficiência: %.4f\n", efficiency);
+
+        save_typed_result(results_path("tipos.csv", input), "mpi", oetsort_key_type_name(type), payload_bytes, n, size, t_parallel, speedup, efficiency);
+    }
+
+    free(local_keys);
+    free(local_idx);
+    free(keys);
+    free(keys_base);
+    free(idx);
+    free(payload);
+    free(sorted_payload);
+    partition_plan_free(&plan);
+    return ok;
 }
 
-// Versão serial do algoritmo para cálculo de speedup no processo raiz.
-void odd_even_sort_serial(int arr[], int n) {
-    int phase, i;
-    for (phase = 0; phase < n; phase++) {
-        if (phase % 2 == 0) {
-            for (i = 1; i < n; i += 2) {
-                if (arr[i - 1] > arr[i]) {
-                    swap(&arr[i - 1], &arr[i]);
-                }
-            }
+// Ordena um arquivo binário bruto de inteiros (--entrada) sem que nenhum processo
+// leia o arquivo inteiro: cada processo mapeia em memória apenas o intervalo de bytes
+// do seu bloco (mesma divisão do caminho com dados gerados) e o ordena no lugar, sem
+// MPI_Scatterv nem MPI_Allgatherv. Com --saida, o rank 0 cria o arquivo de saída e cada
+// processo copia e ordena o seu intervalo nele. Não há execução serial nem escrita no CSV.
+// Retorna 1 se o arquivo resultante estiver ordenado e for uma permutação da entrada (o
+// mesmo valor em todos os processos).
+int run_file_mpi(const char *input, const char *output, const oetsort_options *opts, const char *mode, int rank, int size) {
+    long long bytes = file_size_bytes(input);
+    if (bytes < 0 || bytes % sizeof(int) != 0 || bytes / sizeof(int) > 2147483647LL || bytes / (long long)sizeof(int) < size) {
+        if (rank == 0 && bytes >= 0) printf("O arquivo '%s' deve conter um array de pelo menos %d inteiros de 32 bits.\n", input, size);
+        return 0;
+    }
+    int n = (int)(bytes / sizeof(int));
+    int base_chunk = n / size;
+    int remainder = n % size;
+    int local_n = (rank < remainder) ? base_chunk + 1 : base_chunk;
+    // Índice global do primeiro elemento do bloco deste processo.
+    long long first = (long long)rank * base_chunk + (rank < remainder ? rank : remainder);
+
+    double start_map = MPI_Wtime();
+    int ok = 1;
+    if (rank == 0 && output != NULL) ok = create_output_file(output, (size_t)bytes);
+    MPI_Bcast(&ok, 1, MPI_INT, 0, MPI_COMM_WORLD);
+    if (!ok) return 0;
+
+    mapped_file m;
+    ok = map_sort_range(input, output, (size_t)first * sizeof(int), (size_t)local_n * sizeof(int), &m);
+    int all_ok;
+    MPI_Allreduce(&ok, &all_ok, 1, MPI_INT, MPI_LAND, MPI_COMM_WORLD);
+    if (!all_ok) {
+        if (ok) unmap_file(&m);
+        return 0;
+    }
+    int *local_arr = (int *)m.data;
+    double map_time = MPI_Wtime() - start_map;
+
+    // Impressão digital global da entrada, para verificar o resultado sem reunir o array.
+    oetsort_fingerprint expected;
+    oetsort_fingerprint_keys(local_arr, local_n, OETSORT_INT32, 0, 1, &expected);
+
+    MPI_Barrier(MPI_COMM_WORLD);
+    double total_start = MPI_Wtime();
+    oetsort_stats stats;
+    oetsort_sort(local_arr, local_n, opts, &stats);
+    MPI_Barrier(MPI_COMM_WORLD);
+    double total_time = MPI_Wtime() - total_start;
+
+    oetsort_verification v;
+    oetsort_verify(local_arr, local_n, OETSORT_INT32, 0, 1, &expected, &v);
+
+    double t_parallel, comm_time_sum, map_time_max;
+    MPI_Reduce(&total_time, &t_parallel, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+    MPI_Reduce(&stats.comm_time, &comm_time_sum, 1, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+    MPI_Reduce(&map_time, &map_time_max, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+
+    if (rank == 0) {
+        printf("--- Configuração ---\n");
+        printf("Entrada: %s (%d elementos)\n", input, n);
+        printf("Saída: %s\n", output != NULL ? output : "no próprio arquivo de entrada");
+        printf("Processos: %d\n", size);
+        printf("Modo: %s\n", mode);
+        printf("Troca: %s\n", oetsort_exchange_name(opts->exchange));
+        printf("Kernel: %s\n\n", oetsort_kernel_name());
+
+        printf("--- Resultados ---\n");
+        printf("Tempo de Mapeamento (max): %.6f s\n", map_time_max);
+        printf("Tempo Total (max): %.6f s\n", t_parallel);
+        printf("Tempo de Comunicação (soma): %.6f s\n", comm_time_sum);
+        if (opts->adaptive) printf("Fases executadas: %d de %d\n", stats.phases_run, n);
+        printf("Array está ordenado: %s\n", v.sorted ? "Sim" : "Não");
+        printf("Mesmos elementos da entrada: %s\n", v.same_keys ? "Sim" : "Não");
+    }
+
+    unmap_file(&m);
+    return v.sorted && v.same_keys;
+}
+
+// Reúne o rastro por fase de todos os processos e o grava no rank 0 (coletiva).
+void save_trace(const char *path, int rank) {
+    int err = oetsort_trace_stop(path, 1);
+    if (rank == 0) {
+        if (err == OETSORT_OK) {
+            printf("Rastro por fase salvo em '%s'\n\n", path);
         } else {
-            for (i = 1; i < n - 1; i += 2) {
-                if (arr[i] > arr[i + 1]) {
-                    swap(&arr[i], &arr[i + 1]);
-                }
-            }
+            fprintf(stderr, "Falha ao gravar o rastro em '%s'\n", path);
         }
     }
 }
 
-// Executa uma única fase (par ou ímpar) do algoritmo no array local.
-void single_phase_odd_even(int arr[], int n, int phase) {
-    if (phase % 2 == 0) { // Fase Par
-        for (int i = 1; i < n; i += 2) {
-            if (arr[i - 1] > arr[i]) {
-                swap(&arr[i - 1], &arr[i]);
-            }
+// Modo distribuído (--distribuido): nenhum processo aloca o array inteiro. Cada processo
+// gera apenas o seu bloco (oetsort_generate com o deslocamento global do bloco), ordena e
+// verifica o resultado de forma distribuída, usando O(n/p) de memória. Não há execução
+// serial de referência (ela exigiria o array inteiro em um processo), então o speedup não
+// é calculado. A coleta do resultado é opcional: 'gather' reúne o array ordenado apenas no
+// rank 0 (MPI_Gatherv) e 'output' o grava em um arquivo binário com MPI-IO, cada processo
+// escrevendo o seu bloco na posição correspondente.
+// Retorna 1 se o resultado estiver ordenado e for uma permutação da entrada (o mesmo valor
+// em todos os processos).
+int run_distributed_mpi(int n, const oetsort_options *opts, const char *mode, const oetsort_input *input,
+                        int gather, const char *output, const partition_plan *plan, int rank, int size) {
+    int local_n = plan->counts[rank];
+    int first = plan->displs[rank];
+    int max_chunk = 0;
+    for (int i = 0; i < size; i++) {
+        if (plan->counts[i] > max_chunk) max_chunk = plan->counts[i];
+    }
+
+    int *local_arr = malloc(local_n * sizeof(int));
+    oetsort_generate(local_arr, local_n, first, n, OETSORT_INT32, input);
+    oetsort_fingerprint expected;
+    oetsort_fingerprint_keys(local_arr, local_n, OETSORT_INT32, 0, 1, &expected);
+
+    if (rank == 0) {
+        printf("--- Configuração ---\n");
+        printf("Tamanho do array: %d (distribuído, até %d elementos por processo)\n", n, max_chunk);
+        printf("Processos: %d\n", size);
+        printf("Modo: %s\n", mode);
+        printf("Troca: %s\n", oetsort_exchange_name(opts->exchange));
+        printf("Partição: %s\n", plan->name);
+        printf("Entrada: %s (semente %llu)\n", oetsort_distribution_name(input->dist), (unsigned long long)input->seed);
+        printf("Parada antecipada: %s\n", opts->adaptive ? "Sim" : "Não");
+        printf("Kernel: %s\n\n", oetsort_kernel_name());
+    }
+
+    MPI_Barrier(MPI_COMM_WORLD);
+    double total_start = MPI_Wtime();
+    oetsort_stats stats;
+    oetsort_sort(local_arr, local_n, opts, &stats);
+    MPI_Barrier(MPI_COMM_WORLD);
+    double total_time = MPI_Wtime() - total_start;
+    double computation_time = total_time - stats.comm_time;
+
+    oetsort_verification v;
+    oetsort_verify(local_arr, local_n, OETSORT_INT32, 0, 1, &expected, &v);
+
+    double t_parallel, comm_time_sum, computation_time_sum;
+    MPI_Reduce(&total_time, &t_parallel, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+    MPI_Reduce(&stats.comm_time, &comm_time_sum, 1, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+    MPI_Reduce(&computation_time, &computation_time_sum, 1, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+
+    // Coleta opcional no rank 0: apenas ele passa a ter O(n) de memória.
+    if (gather) {
+        int *arr = (rank == 0) ? malloc(n * sizeof(int)) : NULL;
+        MPI_Gatherv(local_arr, local_n, MPI_INT, arr, plan->counts, plan->displs, MPI_INT, 0, MPI_COMM_WORLD);
+        if (rank == 0) {
+            printf("--- Resultado Coletado no Rank 0 ---\n");
+            printf("Array ordenado: ");
+            print_array(arr, n > 20 ? 20 : n);
+            if (n > 20) printf("(exibindo apenas os 20 primeiros elementos)\n");
+            printf("\n");
         }
-    } else { // Fase Ímpar
-        for (int i = 1; i < n - 1; i += 2) {
-            if (arr[i] > arr[i + 1]) {
-                swap(&arr[i], &arr[i + 1]);
-                }
-            }
+        free(arr);
+    }
+
+    // Gravação paralela opcional: cada processo escreve o seu bloco no deslocamento global.
+    if (output != NULL) {
+        MPI_File fh;
+        int err = MPI_File_open(MPI_COMM_WORLD, output, MPI_MODE_CREATE | MPI_MODE_WRONLY, MPI_INFO_NULL, &fh);
+        if (err == MPI_SUCCESS) {
+            MPI_File_set_size(fh, (MPI_Offset)n * sizeof(int));
+            MPI_File_write_at_all(fh, (MPI_Offset)first * sizeof(int), local_arr, local_n, MPI_INT, MPI_STATUS_IGNORE);
+            MPI_File_close(&fh);
+        } else if (rank == 0) {
+            printf("Falha ao abrir '%s' para escrita com MPI-IO.\n", output);
         }
-}
+    }
+
+    if (plan->report) partition_report(plan, mode, n, computation_time, stats.comm_time, t_parallel, input, rank, size);
+
+    if (rank == 0) {
+        printf("--- Análise de Performance MPI (distribuído) ---\n");
+        printf("Array está ordenado: %s\n", v.sorted ? "Sim" : "Não");
+        printf("Mesmos elementos da entrada: %s\n\n", v.same_keys ? "Sim" : "Não");
+        if (opts->adaptive) printf("Fases executadas: %d de %d\n", stats.phases_run, n);
+        printf("Tempo Total (max): %.6f s\n", t_parallel);
+        printf("Tempo de Computação (soma): %.6f s\n", computation_time_sum);
+        printf("Tempo de Comunicação (soma): %.6f s\n", comm_time_sum);
+        printf("Memória de dados por processo (max): %lld bytes\n", (long long)max_chunk * (long long)sizeof(int));
+        if (output != NULL) printf("Resultado gravado em: %s\n", output);
 
+        save_distributed_result(results_path("mpi_distribuido.csv", input), n, size, mode, t_parallel, computation_time_sum,
+                                comm_time_sum, (long long)max_chunk * (long long)sizeof(int), stats.phases_run);
+    }
 
+    free(local_arr);
+    return v.sorted && v.same_keys;
+}
 
 int main(int argc, char *argv[]) {
     // Inicializa o ambiente MPI.
@@ -59,68 +336,211 @@ int main(int argc, char *argv[]) {
     MPI_Comm_size(MPI_COMM_WORLD, &size); // Obtém o número total de processos.
 
     // Validação dos argumentos de linha de comando.
-    if (argc != 2) {
-        if (rank == 0) printf("Uso: mpirun -np <num_procs> %s <tamanho_array>\n", argv[0]);
+    // --modo=fases (padrão): n fases globais com troca de um elemento por fase.
+    // --modo=sobreposto: como 'fases', mas sobrepondo a troca de fronteira à ordenação local.
+    // --modo=blocos: ordenação local seguida de 'size' fases de merge-split entre blocos.
+    // --adaptativo: nos modos 'fases' e 'sobreposto', para quando um par de fases não faz
+    // trocas em nenhum processo, verificado com um MPI_Allreduce a cada --verificar-cada=k pares.
+    const char *mode = get_option(argc, argv, "modo", "fases");
+    int adaptive = has_flag(argc, argv, "adaptativo");
+    int check_every = adaptive ? atoi(get_option(argc, argv, "verificar-cada", "1")) : 0;
+    // --kernel: força o kernel de compare-exchange (auto, avx512, avx2 ou escalar).
+    int kernel_ok = oetsort_set_kernel(get_option(argc, argv, "kernel", "auto")) == OETSORT_OK;
+    // --tipo e --payload=B: tipo da chave e registros com B bytes de payload (apenas no modo 'fases').
+    oetsort_key_type type = OETSORT_INT32;
+    int type_ok = oetsort_key_type_from_name(get_option(argc, argv, "tipo", "int32"), &type) == OETSORT_OK;
+    int payload_bytes = atoi(get_option(argc, argv, "payload", "0"));
+    int typed = type != OETSORT_INT32 || payload_bytes != 0;
+    // --dist, --semente, --deslocamentos, --unicos e --zipf: distribuição da entrada gerada.
+    oetsort_input input;
+    int input_ok = read_input_options(argc, argv, &input);
+    // --entrada=arquivo: ordena no lugar um arquivo binário de inteiros de 32 bits; cada
+    // processo mapeia apenas o seu intervalo. --saida=arquivo grava o resultado em outro arquivo.
+    const char *input_path = get_option(argc, argv, "entrada", NULL);
+    const char *output_path = get_option(argc, argv, "saida", NULL);
+    int file_mode = input_path != NULL;
+    // --distribuido: cada processo gera e ordena apenas o seu bloco, sem o array inteiro no
+    // rank 0. --coletar reúne o resultado no rank 0; --saida=arquivo o grava com MPI-IO.
+    int distributed = has_flag(argc, argv, "distribuido");
+    int gather = has_flag(argc, argv, "coletar");
+    // --medir-serial: mede a linha de base serial mesmo que ela esteja no cache (baseline_utils.h).
+    int measure_serial = has_flag(argc, argv, "medir-serial");
+    // --rastro=arquivo.json: grava o rastro por fase da ordenação, com um processo por rank
+    // (trace_utils.h); --rastro-cada=K: registra uma fase a cada K (0 = automático).
+    const char *trace_path = get_option(argc, argv, "rastro", NULL);
+    int trace_every = atoi(get_option(argc, argv, "rastro-cada", "0"));
+    // --particao=uniforme|calibrada: divisão do array entre os processos; 'calibrada' mede a
+    // vazão de cada processo e dá a cada um um bloco proporcional a ela (partition_utils.h).
+    // --pesos=arquivo: blocos proporcionais aos pesos do arquivo. --salvar-pesos=arquivo:
+    // grava os pesos medidos na execução. Com qualquer uma delas, imprime o desbalanceamento.
+    const char *partition = get_option(argc, argv, "particao", NULL);
+    const char *weights_path = get_option(argc, argv, "pesos", NULL);
+    const char *save_weights_path = get_option(argc, argv, "salvar-pesos", NULL);
+    int partitioned = partition != NULL || weights_path != NULL || save_weights_path != NULL;
+    // --troca=sendrecv|persistente|rma|rma-pscw: motor de troca do elemento de fronteira
+    // nos modos 'fases' e 'sobreposto' (exchange_utils.h). Com a opção, os tempos vão para
+    // 'mpi_troca.csv', com o motor em uma coluna.
+    const char *exchange_opt = get_option(argc, argv, "troca", NULL);
+    oetsort_exchange exchange = OETSORT_EXCHANGE_SENDRECV;
+    int exchange_ok = exchange_opt == NULL || oetsort_exchange_from_name(exchange_opt, &exchange) == OETSORT_OK;
+    if (count_positional_args(argc, argv) != (file_mode ? 1 : 2) || !kernel_ok || trace_every < 0 ||
+        !exchange_ok || (exchange != OETSORT_EXCHANGE_SENDRECV && (strcmp(mode, "blocos") == 0 || typed)) ||
+        (partition != NULL && strcmp(partition, "uniforme") != 0 && strcmp(partition, "calibrada") != 0) ||
+        (partition != NULL && weights_path != NULL) || (partitioned && (file_mode || typed)) ||
+        (trace_path != NULL && (file_mode || typed)) ||
+        (output_path != NULL && !file_mode && !distributed) || (file_mode && typed) || !input_ok ||
+        (distributed && (file_mode || typed)) || (gather && !distributed) ||
+        (strcmp(mode, "fases") != 0 && strcmp(mode, "sobreposto") != 0 && strcmp(mode, "blocos") != 0) ||
+        (adaptive && (strcmp(mode, "blocos") == 0 || check_every < 1)) ||
+        !type_ok || (payload_bytes != 0 && payload_bytes < 4) || (typed && (adaptive || strcmp(mode, "fases") != 0))) {
+        if (rank == 0) {
+            printf("Uso: mpirun -np <num_procs> %s <tamanho_array> [--modo=fases|sobreposto|blocos] [--adaptativo [--verificar-cada=k]] [--kernel=auto|avx512|avx2|escalar]\n", argv[0]);
+            printf("       mpirun -np <num_procs> %s <tamanho_array> [--tipo=int32|int64|float|double] [--payload=B]\n", argv[0]);
+            printf("       mpirun -np <num_procs> %s --entrada=arquivo.bin [--saida=arquivo.bin] [--modo=...] [--adaptativo [--verificar-cada=k]]\n", argv[0]);
+            printf("       mpirun -np <num_procs> %s <tamanho_array> --distribuido [--coletar] [--saida=arquivo.bin] [--modo=...] [--adaptativo [--verificar-cada=k]]\n", argv[0]);
+            printf("Entrada gerada: [--dist=uniforme|ordenado|invertido|quase-ordenado|poucos-unicos|zipf|tubos-de-orgao] [--semente=S]\n");
+            printf("                [--deslocamentos=K] [--unicos=U] [--zipf=s]\n");
+            printf("Linha de base: [--medir-serial] (ignora o cache de linha de base)\n");
+            printf("Rastro por fase: [--rastro=arquivo.json] [--rastro-cada=K] (sem --entrada, --tipo e --payload)\n");
+            printf("Partição: [--particao=uniforme|calibrada | --pesos=arquivo] [--salvar-pesos=arquivo] (sem --entrada, --tipo e --payload)\n");
+            printf("Troca de fronteira: [--troca=sendrecv|persistente|rma|rma-pscw] (modos 'fases' e 'sobreposto', sem --tipo e --payload)\n");
+        }
         MPI_Finalize();
         return 1;
     }
 
+    // Entrada por arquivo mapeado em memória, sem distribuição pelo rank 0.
+    if (file_mode) {
+        oetsort_options opts;
+        oetsort_default_options(&opts);
+        opts.backend = OETSORT_MPI_PHASES;
+        if (strcmp(mode, "blocos") == 0) opts.backend = OETSORT_MPI_BLOCKS;
+        else if (strcmp(mode, "sobreposto") == 0) opts.backend = OETSORT_MPI_OVERLAP;
+        opts.adaptive = adaptive;
+        opts.check_every = adaptive ? check_every : 1;
+        opts.exchange = exchange;
+        int ok = run_file_mpi(input_path, output_path, &opts, mode, rank, size);
+        MPI_Finalize();
+        return ok ? 0 : 1;
+    }
+
     int n = atoi(argv[1]);
+
+    // Todo processo precisa de ao menos um elemento: a biblioteca recusa blocos vazios
+    // (sem elemento de fronteira para trocar com os vizinhos).
+    if (n < size) {
+        if (rank == 0) printf("O tamanho do array deve ser pelo menos o número de processos (%d).\n", size);
+        MPI_Finalize();
+        return 1;
+    }
+
+    // Tipos genéricos e registros têm um caminho próprio; o caminho int abaixo não muda.
+    if (typed) {
+        int ok = run_typed_mpi(type, n, rank, size, payload_bytes, &input);
+        MPI_Finalize();
+        return ok ? 0 : 1;
+    }
+
+    // Partição do array entre os processos (uniforme, sem opções). As ponderadas também
+    // dão ao menos um elemento a cada processo.
+    partition_plan plan;
+    if (!partition_plan_init(&plan, partition, weights_path, save_weights_path, n, &input, rank, size)) {
+        if (rank == 0) printf("Arquivo de pesos inválido: '%s' (um peso positivo por processo, %d linhas).\n", weights_path, size);
+        MPI_Finalize();
+        return 1;
+    }
+
+    // Modo distribuído: O(n/p) de memória por processo.
+    if (distributed) {
+        oetsort_options opts;
+        oetsort_default_options(&opts);
+        opts.backend = OETSORT_MPI_PHASES;
+        if (strcmp(mode, "blocos") == 0) opts.backend = OETSORT_MPI_BLOCKS;
+        else if (strcmp(mode, "sobreposto") == 0) opts.backend = OETSORT_MPI_OVERLAP;
+        opts.adaptive = adaptive;
+        opts.check_every = adaptive ? check_every : 1;
+        opts.exchange = exchange;
+        if (trace_path != NULL) oetsort_trace_start(trace_every, 0);
+        int ok = run_distributed_mpi(n, &opts, mode, &input, gather, output_path, &plan, rank, size);
+        if (trace_path != NULL) save_trace(trace_path, rank);
+        partition_plan_free(&plan);
+        MPI_Finalize();
+        return ok ? 0 : 1;
+    }
     
     // --- Lógica para Distribuição Desigual de Dados ---
-    // Calcula o tamanho base do bloco de dados para cada processo.
-    int base_chunk = n / size;
-    // Calcula o resto da divisão, que será distribuído entre os primeiros processos.
-    int remainder = n % size;
-    // Cada processo calcula o tamanho do seu bloco local (local_n).
-    // Os 'remainder' primeiros processos recebem um elemento a mais.
-    int local_n = (rank < remainder) ? base_chunk + 1 : base_chunk;
+    // Na partição uniforme, os 'n % size' primeiros processos recebem um elemento a mais;
+    // nas ponderadas, cada bloco é proporcional ao peso do processo (partition_counts).
+    int local_n = plan.counts[rank];
 
     // Aloca memória para o sub-array local de cada processo.
     int *local_arr = (int*)malloc(local_n * sizeof(int));
-    // O array completo 'arr' é alocado em todos os processos para receber o resultado final.
-    int *arr = (int*)malloc(n * sizeof(int));
+    // O array completo 'arr' existe apenas no rank 0, que gera a entrada, mede a versão
+    // serial e recebe o resultado final.
+    int *arr = (rank == 0) ? (int*)malloc(n * sizeof(int)) : NULL;
     double t_serial = 0.0;
+    // Impressão digital da entrada (no rank 0), para verificar o resultado reunido.
+    oetsort_fingerprint expected;
     
-    // Prepara os parâmetros para o MPI_Scatterv e MPI_Allgatherv.
+    // Parâmetros do MPI_Scatterv e MPI_Gatherv.
     // 'sendcounts': array que diz quantos elementos cada processo envia/recebe.
     // 'displs': array que diz o deslocamento (índice inicial) dos dados de cada processo no array global.
-    int *sendcounts = malloc(size * sizeof(int));
-    int *displs = malloc(size * sizeof(int));
-    int current_displ = 0;
-    for (int i = 0; i < size; i++) {
-        sendcounts[i] = (i < remainder) ? base_chunk + 1 : base_chunk;
-        displs[i] = current_displ;
-        current_displ += sendcounts[i];
-    }
+    int *sendcounts = plan.counts;
+    int *displs = plan.displs;
 
     // O processo raiz (rank 0) inicializa o array e calcula o tempo serial.
     if (rank == 0) {
-        int *arr_serial_copy = (int*)malloc(n * sizeof(int));
-        
-        generate_random_array(arr, n, 1000);
-        memcpy(arr_serial_copy, arr, n * sizeof(int));
+        oetsort_generate(arr, n, 0, n, OETSORT_INT32, &input);
+        oetsort_fingerprint_keys(arr, n, OETSORT_INT32, 0, 0, &expected);
 
         printf("--- Configuração ---\n");
         printf("Tamanho do array: %d\n", n);
-        printf("Processos: %d\n\n", size);
+        printf("Processos: %d\n", size);
+        printf("Modo: %s\n", mode);
+        printf("Troca: %s\n", oetsort_exchange_name(exchange));
+        printf("Partição: %s\n", plan.name);
+        printf("Entrada: %s (semente %llu)\n", oetsort_distribution_name(input.dist), (unsigned long long)input.seed);
+        printf("Parada antecipada: %s\n", adaptive ? "Sim" : "Não");
+        printf("Kernel: %s\n\n", oetsort_kernel_name());
 
         printf("--- Array Original ---\n");
         print_array(arr, n > 20 ? 20 : n);
         if (n > 20) printf("(exibindo apenas os 20 primeiros elementos)\n");
         printf("\n");
 
-        // Mede o tempo de execução da versão serial para usar como base para o speedup.
-        double start_serial = MPI_Wtime();
-        odd_even_sort_serial(arr_serial_copy, n);
-        double end_serial = MPI_Wtime();
-        t_serial = end_serial - start_serial;
+        // Tempo da versão serial, usado como base para o speedup: do cache de linha de
+        // base, se já foi medido para esta entrada e compilação, ou medido aqui.
+        // No modo 'blocos' a linha de base é o qsort serial, que é o mesmo algoritmo
+        // usado na ordenação local e é viável para entradas de 10^7-10^8 elementos.
+        int blocks = strcmp(mode, "blocos") == 0;
+        const char *variant = blocks ? "qsort" : (adaptive ? "odd-even-adaptativo" : "odd-even");
+        printf("--- Serial (%s) ---\n", blocks ? "qsort" : "odd-even");
+        if (!measure_serial && baseline_lookup(variant, n, &input, &t_serial)) {
+            printf("Tempo de execução: %.6f segundos (cache de linha de base)\n", t_serial);
+        } else {
+            int *arr_serial_copy = (int*)malloc(n * sizeof(int));
+            memcpy(arr_serial_copy, arr, n * sizeof(int));
+            double start_serial = MPI_Wtime();
+            int phases_serial = n;
+            if (blocks) {
+                qsort(arr_serial_copy, n, sizeof(int), compare_ints);
+            } else {
+                oetsort_options serial_opts;
+                oetsort_default_options(&serial_opts);
+                serial_opts.adaptive = adaptive;
+                oetsort_stats serial_stats;
+                oetsort_sort(arr_serial_copy, n, &serial_opts, &serial_stats);
+                phases_serial = serial_stats.phases_run;
+            }
+            double end_serial = MPI_Wtime();
+            t_serial = end_serial - start_serial;
 
-        printf("--- Serial ---\n");
-        printf("Tempo de execução: %.6f segundos\n", t_serial);
-        printf("Array está ordenado: %s\n\n", is_sorted(arr_serial_copy, n) ? "Sim" : "Não");
-        
-        free(arr_serial_copy);
+            printf("Tempo de execução: %.6f segundos\n", t_serial);
+            if (adaptive) printf("Fases executadas: %d de %d\n", phases_serial, n);
+            if (report_verification("", arr_serial_copy, n, &expected)) baseline_store(variant, n, &input, t_serial);
+            free(arr_serial_copy);
+        }
+        printf("\n");
     }
 
     // O processo raiz envia o tempo serial para todos os outros processos.
@@ -133,51 +553,24 @@ int main(int argc, char *argv[]) {
                  0, MPI_COMM_WORLD);
 
     // Sincroniza todos os processos antes de iniciar a medição do tempo paralelo.
+    if (trace_path != NULL) oetsort_trace_start(trace_every, 0);
     MPI_Barrier(MPI_COMM_WORLD);
     double total_start = MPI_Wtime();
-    double comm_time = 0.0; // Variável para acumular o tempo de comunicação.
-
-    // Loop principal do Odd-Even Sort paralelo.
-    for (int phase = 0; phase < n; phase++) {
-        // 1. Ordenação local: cada processo executa uma fase no seu sub-array.
-        single_phase_odd_even(local_arr, local_n, phase);
-
-        // 2. Comunicação de fronteiras: troca de elementos com processos vizinhos.
-        int partner;
-        // Determina o processo parceiro para a troca nesta fase.
-        if ((phase % 2) == 0) { // Fase par
-            partner = (rank % 2 == 0) ? rank + 1 : rank - 1;
-        } else { // Fase ímpar
-            partner = (rank % 2 != 0) ? rank + 1 : rank - 1;
-        }
 
-        // Verifica se o parceiro é válido (dentro dos limites de 0 a size-1).
-        if (partner >= 0 && partner < size) {
-            int send_val, recv_val;
-            // Determina qual elemento da fronteira enviar.
-            if (rank < partner) {
-                send_val = local_arr[local_n - 1]; // Envia o último elemento.
-            }
-            else {
-                send_val = local_arr[0]; // Envia o primeiro elemento.
-            }
-            
-            // Mede o tempo da operação de comunicação.
-            double comm_start = MPI_Wtime();
-            // MPI_Sendrecv envia e recebe mensagens simultaneamente, evitando deadlocks.
-            MPI_Sendrecv(&send_val, 1, MPI_INT, partner, 0,
-                         &recv_val, 1, MPI_INT, partner, 0,
-                         MPI_COMM_WORLD, MPI_STATUS_IGNORE);
-            comm_time += (MPI_Wtime() - comm_start);
-
-            // Compara o elemento da fronteira local com o recebido e atualiza se necessário.
-            if (rank < partner) { // Processo de rank menor compara seu último com o primeiro do vizinho.
-                if (send_val > recv_val) local_arr[local_n - 1] = recv_val;
-            } else { // Processo de rank maior compara seu primeiro com o último do vizinho.
-                if (recv_val > send_val) local_arr[0] = recv_val;
-            }
-        }
-    }
+    // Executa a ordenação paralela no modo escolhido.
+    oetsort_options opts;
+    oetsort_default_options(&opts);
+    opts.backend = OETSORT_MPI_PHASES;
+    if (strcmp(mode, "blocos") == 0) opts.backend = OETSORT_MPI_BLOCKS;
+    else if (strcmp(mode, "sobreposto") == 0) opts.backend = OETSORT_MPI_OVERLAP;
+    opts.adaptive = adaptive;
+    opts.check_every = adaptive ? check_every : 1;
+    opts.exchange = exchange;
+    oetsort_stats stats;
+    oetsort_sort(local_arr, local_n, &opts, &stats);
+    int phases_run = stats.phases_run;
+    double comm_time = stats.comm_time; // Tempo de comunicação exposto deste processo.
+    double overlap_time = stats.overlap_time; // Computação feita com mensagens em trânsito (modo 'sobreposto').
 
     // Sincroniza novamente antes de finalizar a medição e coletar os resultados.
     MPI_Barrier(MPI_COMM_WORLD);
@@ -186,18 +579,21 @@ int main(int argc, char *argv[]) {
     double computation_time = total_time - comm_time;
 
     // Coleta os sub-arrays ordenados de todos os processos e monta o array final em 'arr'.
-    // MPI_Allgatherv faz com que todos os processos recebam o resultado completo.
-    MPI_Allgatherv(local_arr, local_n, MPI_INT,
-                   arr, sendcounts, displs, MPI_INT,
-                   MPI_COMM_WORLD);
+    // Apenas o rank 0 usa o resultado completo, então ele é reunido só nele (MPI_Gatherv).
+    MPI_Gatherv(local_arr, local_n, MPI_INT,
+                arr, sendcounts, displs, MPI_INT,
+                0, MPI_COMM_WORLD);
 
     // Reduz (agrega) os tempos de todos os processos no processo raiz para análise.
-    double t_parallel, comm_time_sum, computation_time_sum;
+    double t_parallel, comm_time_sum, computation_time_sum, overlap_time_sum;
     // MPI_MAX para o tempo total, pois o tempo da execução é o do processo mais lento.
     MPI_Reduce(&total_time, &t_parallel, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
     // MPI_SUM para os tempos de comunicação e computação para calcular o overhead.
     MPI_Reduce(&comm_time, &comm_time_sum, 1, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
     MPI_Reduce(&computation_time, &computation_time_sum, 1, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+    MPI_Reduce(&overlap_time, &overlap_time_sum, 1, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+    if (trace_path != NULL) save_trace(trace_path, rank);
+    if (plan.report) partition_report(&plan, mode, n, computation_time, comm_time, t_parallel, &input, rank, size);
 
     // O processo raiz imprime os resultados e salva no CSV.
     if (rank == 0) {
@@ -205,7 +601,8 @@ int main(int argc, char *argv[]) {
         printf("Array ordenado: ");
         print_array(arr, n > 20 ? 20 : n);
         if (n > 20) printf("(exibindo apenas os 20 primeiros elementos)\n");
-        printf("Array está ordenado: %s\n\n", is_sorted(arr, n) ? "Sim" : "Não");
+        report_verification("", arr, n, &expected);
+        printf("\n");
 
         // Cálculo das métricas de desempenho.
         double t_computation_avg = computation_time_sum / size;
@@ -215,23 +612,42 @@ int main(int argc, char *argv[]) {
         double speedup = t_serial / t_parallel;
         double efficiency = speedup / size;
 
+        printf("Fases executadas: %d\n", phases_run);
         printf("Tempo Total (max): %.6f s\n", t_parallel);
         printf("Tempo de Computação (soma): %.6f s\n", computation_time_sum);
         printf("Tempo de Comunicação (soma): %.6f s\n", comm_time_sum);
+        if (exchange == OETSORT_EXCHANGE_RMA) printf("Janela de memória compartilhada: %s\n", stats.shared_window ? "Sim" : "Não");
+        if (strcmp(mode, "sobreposto") == 0) {
+            // Computação executada enquanto as trocas estavam em trânsito: é o limite superior
+            // da latência escondida. O ganho efetivo é a redução do tempo de comunicação
+            // em relação ao modo 'fases' (data/mpi.csv).
+            printf("Tempo de Computação Sobreposta (soma): %.6f s\n", overlap_time_sum);
+        }
         printf("Overhead Absoluto: %.6f s\n", overhead_abs);
         printf("Overhead Relativo: %.2f%%\n", overhead_rel);
         printf("Eficiência de Comunicação: %.4f\n", comm_efficiency);
         printf("Speedup: %.4f\n", speedup);
         printf("Eficiência: %.4f\n", efficiency);
 
-        save_mpi_result("data/mpi.csv", n, size, t_parallel, computation_time_sum, comm_time_sum, overhead_abs, overhead_rel, comm_efficiency, speedup, efficiency);
+        // Cada modo grava em seu próprio arquivo, mantendo o formato de 'data/mpi.csv'. Com
+        // --troca, os motores de troca são comparados em 'mpi_troca.csv'.
+        const char *csv_name = "mpi.csv";
+        if (strcmp(mode, "blocos") == 0) csv_name = "mpi_blocos.csv";
+        else if (strcmp(mode, "sobreposto") == 0) csv_name = "mpi_sobreposto.csv";
+        if (adaptive) {
+            save_adaptive_result(results_path("adaptativo.csv", &input), "mpi", n, size, mode, t_parallel, phases_run);
+        } else if (exchange_opt != NULL) {
+            save_exchange_result(results_path("mpi_troca.csv", &input), n, size, mode, oetsort_exchange_name(exchange), stats.shared_window,
+                                 t_parallel, computation_time_sum, comm_time_sum, speedup);
+        } else {
+            save_mpi_result(results_path(csv_name, &input), n, size, t_parallel, computation_time_sum, comm_time_sum, overhead_abs, overhead_rel, comm_efficiency, speedup, efficiency);
+        }
     }
 
     // Libera toda a memória alocada.
     free(arr);
     free(local_arr);
-    free(sendcounts);
-    free(displs);
+    partition_plan_free(&plan);
     
     // Finaliza o ambiente MPI.
     MPI_Finalize();
@@ -1,3 +1,4 @@
+#define _GNU_SOURCE // Para MAP_POPULATE e copy_file_range (mmap_utils.h) e sched_setaffinity (numa_utils.h)
 #include <stdio.h>
 #include <stdlib.h>
 #include <omp.h> // Biblioteca OpenMP
@@ -5,199 +6,525 @@
 #include <string.h>
 #include "utils.h"
 #include "csv_utils.h"
+#include "mmap_utils.h"
+#include "numa_utils.h"
+#include "gen_utils.h" // Tamanhos dos segmentos do modo --segmentos
+#include "tune_utils.h"
+#include "baseline_utils.h"
+#include "oetsort.h" // Biblioteca com os algoritmos de ordenação
 
-// Função para trocar dois elementos de posição.
-void swap(int *a, int *b) {
-    int temp = *a;
-    *a = *b;
-    *b = temp;
+// Executa a ordenação de 'arr' com o backend informado e as opções comuns da linha
+// de comando. Retorna o número de fases executadas.
+int run_backend(int arr[], int n, oetsort_backend backend, int num_threads, int adaptive, int tile) {
+    oetsort_options opts;
+    oetsort_default_options(&opts);
+    opts.backend = backend;
+    opts.num_threads = num_threads;
+    opts.adaptive = adaptive;
+    opts.tile = tile;
+    oetsort_stats stats;
+    oetsort_sort(arr, n, &opts, &stats);
+    return stats.phases_run;
 }
 
-// Versão serial do algoritmo para cálculo de speedup.
-void odd_even_sort_serial(int arr[], int n) {
-    int phase, i;
-    for (phase = 0; phase < n; phase++) {
-        if (phase % 2 == 0) {
-            for (i = 1; i < n; i += 2) {
-                if (arr[i - 1] > arr[i]) {
-                    swap(&arr[i - 1], &arr[i]);
-                }
-            }
+// Executa as versões serial e OpenMP (schedule static) com um tipo de chave genérico
+// (--tipo) e, se payload_bytes > 0, com registros chave + payload (--payload).
+// Em cada execução o payload é movido uma única vez, depois da ordenação das chaves.
+// Retorna 1 se os dois resultados estiverem corretos.
+int run_typed_openmp(oetsort_key_type type, int n, int num_threads, int payload_bytes, const oetsort_input *input) {
+    size_t key_size = oetsort_key_size(type);
+    const char *type_name = oetsort_key_type_name(type);
+    void *keys_base = malloc((size_t)n * key_size); // Chaves originais não modificadas
+    void *keys = malloc((size_t)n * key_size);      // Cópia para cada execução
+    uint32_t *idx = NULL;
+    void *payload = NULL, *sorted_payload = NULL;
+
+    oetsort_generate(keys_base, n, 0, n, type, input);
+    oetsort_fingerprint expected;
+    oetsort_fingerprint_keys(keys_base, n, type, num_threads, 0, &expected);
+    if (payload_bytes > 0) {
+        idx = malloc((size_t)n * sizeof(uint32_t));
+        payload = malloc((size_t)n * payload_bytes);
+        sorted_payload = malloc((size_t)n * payload_bytes);
+        fill_payload(payload, n, payload_bytes);
+    }
+
+    printf("--- Configuração ---\n");
+    printf("Tamanho do array: %d\n", n);
+    printf("Threads: %d\n", num_threads);
+    printf("Entrada: %s (semente %llu)\n", oetsort_distribution_name(input->dist), (unsigned long long)input->seed);
+    printf("Tipo da chave: %s\n", type_name);
+    printf("Payload: %d bytes por registro\n\n", payload_bytes);
+
+    int ok = 1;
+    double t_serial = 0.0;
+    for (int run = 0; run < 2; run++) {
+        memcpy(keys, keys_base, (size_t)n * key_size);
+        if (payload_bytes > 0) init_record_indices(idx, n);
+
+        oetsort_options opts;
+        oetsort_default_options(&opts);
+        opts.backend = (run == 0) ? OETSORT_SERIAL : OETSORT_OPENMP_STATIC;
+        opts.num_threads = num_threads;
+
+        double start = omp_get_wtime();
+        oetsort_sort_keys(keys, idx, n, type, &opts, NULL);
+        if (payload_bytes > 0) {
+            oetsort_apply_permutation(sorted_payload, payload, idx, n, payload_bytes);
+        }
+        double t = omp_get_wtime() - start;
+
+        int run_ok = verify_keys(keys, n, type, &expected);
+        if (payload_bytes > 0) {
+            run_ok = run_ok && verify_records(keys, keys_base, key_size, sorted_payload, idx, n, payload_bytes);
+        }
+        ok = ok && run_ok;
+
+        if (run == 0) {
+            t_serial = t;
+            printf("--- Serial ---\n");
+            printf("Tempo de execução: %.6f segundos\n", t);
+            printf("Array está ordenado: %s\n\n", run_ok ? "Sim" : "Não");
+            save_typed_result(results_path("tipos.csv", input), "serial", type_name, payload_bytes, n, 1, t, 1.0, 1.0);
         } else {
-            for (i = 1; i < n - 1; i += 2) {
-                if (arr[i] > arr[i + 1]) {
-                    swap(&arr[i], &arr[i + 1]);
-                }
-            }
+            double speedup = t_serial / t;
+            double efficiency = speedup / num_threads;
+            printf("--- Análise de Performance OpenMP ---\n");
+            printf("Schedule: static\n");
+            printf("  Tempo: %.6f s\n", t);
+            printf("  Speedup: %.4f\n", speedup);
+            printf("  Eficiência: %.4f\n", efficiency);
+            printf("  Array está ordenado: %s\n", run_ok ? "Sim" : "Não");
+            save_typed_result(results_path("tipos.csv", input), "openmp", type_name, payload_bytes, n, num_threads, t, speedup, efficiency);
         }
     }
+
+    free(keys_base);
+    free(keys);
+    free(idx);
+    free(payload);
+    free(sorted_payload);
+    return ok;
 }
 
-// Versão paralela com OpenMP e escalonamento (schedule) ESTÁTICO.
-void odd_even_sort_openmp_static(int arr[], int n, int num_threads) {
-    int phase, i;
-    // Inicia a região paralela.
-    // 'num_threads': define o número de threads.
-    // 'default(none)': força a declaração explícita do escopo de cada variável.
-    // 'shared(arr, n)': 'arr' e 'n' são compartilhados entre todas as threads.
-    // 'private(phase, i)': cada thread tem sua própria cópia de 'phase' e 'i'.
-    #pragma omp parallel num_threads(num_threads) default(none) shared(arr, n) private(phase, i)
-    {
-        for (phase = 0; phase < n; phase++) {
-            if (phase % 2 == 0) { // Fase Par
-                // Paraleliza o loop 'for'.
-                // 'schedule(static)': divide as iterações em blocos de tamanho igual
-                // e os distribui estaticamente para as threads. Ideal para cargas de trabalho balanceadas.
-                #pragma omp for schedule(static)
-                for (i = 1; i < n; i += 2) {
-                    if (arr[i - 1] > arr[i]) {
-                        swap(&arr[i - 1], &arr[i]);
-                    }
-                }
-            } else { // Fase Ímpar
-                #pragma omp for schedule(static)
-                for (i = 1; i < n - 1; i += 2) {
-                    if (arr[i] > arr[i + 1]) {
-                        swap(&arr[i], &arr[i + 1]);
-                    }
-                }
-            }
-        }
+// Ordena no lugar um arquivo binário bruto de inteiros (--entrada), mapeado em
+// memória, ou uma cópia dele feita em 'output' (--saida), com um único schedule.
+// Não há execução serial de referência nem escrita no CSV.
+// Retorna 1 se o resultado estiver ordenado.
+int run_file_openmp(const char *input, const char *output, oetsort_backend backend, int num_threads, int adaptive, int tile) {
+    long long size = file_size_bytes(input);
+    if (size < 0) return 0;
+    if (size % sizeof(int) != 0 || size / sizeof(int) > 2147483647LL) {
+        printf("O tamanho de '%s' não corresponde a um array de inteiros de 32 bits.\n", input);
+        return 0;
     }
+    int n = (int)(size / sizeof(int));
+
+    double start_map = omp_get_wtime();
+    mapped_file m;
+    if (output != NULL && !create_output_file(output, (size_t)size)) return 0;
+    if (!map_sort_range(input, output, 0, (size_t)size, &m)) return 0;
+    int *arr = (int *)m.data;
+    double end_map = omp_get_wtime();
+
+    // Impressão digital da entrada, para verificar depois que nenhum elemento foi alterado.
+    oetsort_fingerprint expected;
+    oetsort_fingerprint_keys(arr, n, OETSORT_INT32, num_threads, 0, &expected);
+
+    double start_time = omp_get_wtime();
+    int phases = run_backend(arr, n, backend, num_threads, adaptive, tile);
+    double end_time = omp_get_wtime();
+
+    printf("--- Configuração ---\n");
+    printf("Entrada: %s (%d elementos)\n", input, n);
+    printf("Saída: %s\n", output != NULL ? output : "no próprio arquivo de entrada");
+    printf("Threads: %d\n", num_threads);
+    printf("Kernel: %s\n\n", oetsort_kernel_name());
+
+    printf("--- Resultados ---\n");
+    printf("Schedule: %s\n", oetsort_backend_name(backend) + strlen("openmp-"));
+    printf("  Tempo de mapeamento: %.6f s\n", end_map - start_map);
+    printf("  Tempo: %.6f s\n", end_time - start_time);
+    if (adaptive) printf("  Fases executadas: %d de %d\n", phases, n);
+    int ok = report_verification("  ", arr, n, &expected);
+
+    unmap_file(&m);
+    return ok;
 }
 
-// Versão paralela com OpenMP e escalonamento (schedule) DINÂMICO.
-void odd_even_sort_openmp_dynamic(int arr[], int n, int num_threads) {
-    int phase, i;
-    #pragma omp parallel num_threads(num_threads) default(none) shared(arr, n) private(phase, i)
-    {
-        for (phase = 0; phase < n; phase++) {
-            if (phase % 2 == 0) { // Fase Par
-                // 'schedule(dynamic)': as iterações são distribuídas dinamicamente para as threads
-                // em blocos. Quando uma thread termina, ela pega o próximo bloco disponível.
-                // Tem mais overhead que o static.
-                #pragma omp for schedule(dynamic)
-                for (i = 1; i < n; i += 2) {
-                    if (arr[i - 1] > arr[i]) {
-                        swap(&arr[i - 1], &arr[i]);
-                    }
-                }
-            } else { // Fase Ímpar
-                #pragma omp for schedule(dynamic)
-                for (i = 1; i < n - 1; i += 2) {
-                    if (arr[i] > arr[i + 1]) {
-                        swap(&arr[i], &arr[i + 1]);
-                    }
-                }
+// Ordena em lote muitos segmentos pequenos e independentes (--segmentos=MIN:MAX) que
+// somam 'n' elementos, com tamanhos sorteados em [min_len, max_len] (o último pode ser
+// menor). Compara o laço que ordena um segmento por vez (serial e com o paralelismo
+// interno do schedule static) com oetsort_sort_segments(), que divide os segmentos
+// entre as threads e ordena vários ao mesmo tempo nas lanes SIMD.
+// Retorna 1 se todos os resultados estiverem corretos.
+int run_segments_openmp(int n, int num_threads, int min_len, int max_len, const oetsort_input *input) {
+    // Offsets dos segmentos (num_segments + 1 entradas, como em uma matriz CSR).
+    int capacity = n / min_len + 2;
+    int *offsets = malloc(capacity * sizeof(int));
+    int num_segments = 0;
+    offsets[0] = 0;
+    while (offsets[num_segments] < n) {
+        int len = min_len + (int)gen_bounded(gen_random(input->seed, GEN_STREAM_SEGMENT, num_segments), max_len - min_len + 1);
+        int end = offsets[num_segments] + len;
+        offsets[++num_segments] = (end < n) ? end : n;
+    }
+
+    int *arr_base = malloc(n * sizeof(int));
+    int *arr_temp = malloc(n * sizeof(int));
+    oetsort_generate(arr_base, n, 0, n, OETSORT_INT32, input);
+    oetsort_fingerprint expected;
+    oetsort_fingerprint_keys(arr_base, n, OETSORT_INT32, num_threads, 0, &expected);
+
+    printf("--- Configuração ---\n");
+    printf("Tamanho total: %d\n", n);
+    printf("Segmentos: %d (tamanhos entre %d e %d)\n", num_segments, min_len, max_len);
+    printf("Entrada: %s (semente %llu)\n", oetsort_distribution_name(input->dist), (unsigned long long)input->seed);
+    printf("Threads: %d\n", num_threads);
+    printf("Kernel: %s\n\n", oetsort_kernel_name());
+
+    static const struct {
+        const char *name;
+        int batch;               // 1: oetsort_sort_segments; 0: um oetsort_sort por segmento.
+        oetsort_backend backend;
+    } methods[] = {
+        {"laco-serial", 0, OETSORT_SERIAL},
+        {"laco-openmp", 0, OETSORT_OPENMP_STATIC},
+        {"lote-serial", 1, OETSORT_SERIAL},
+        {"lote-openmp", 1, OETSORT_OPENMP_STATIC},
+    };
+
+    printf("--- Ordenação em Lote ---\n");
+    int ok = 1;
+    double t_loop = 0.0;
+    for (size_t k = 0; k < sizeof(methods) / sizeof(methods[0]); k++) {
+        oetsort_options opts;
+        oetsort_default_options(&opts);
+        opts.backend = methods[k].backend;
+        opts.num_threads = num_threads;
+
+        memcpy(arr_temp, arr_base, n * sizeof(int));
+        double start_time = omp_get_wtime();
+        if (methods[k].batch) {
+            oetsort_sort_segments(arr_temp, offsets, num_segments, &opts, NULL);
+        } else {
+            for (int seg = 0; seg < num_segments; seg++) {
+                oetsort_sort(arr_temp + offsets[seg], offsets[seg + 1] - offsets[seg], &opts, NULL);
             }
         }
+        double t = omp_get_wtime() - start_time;
+        if (k == 0) t_loop = t;
+
+        // Cada segmento deve estar ordenado, e o buffer deve ter os mesmos elementos.
+        int sorted = 1;
+        for (int seg = 0; seg < num_segments && sorted; seg++) {
+            sorted = oetsort_keys_sorted(arr_temp + offsets[seg], offsets[seg + 1] - offsets[seg], OETSORT_INT32);
+        }
+        oetsort_verification v;
+        oetsort_verify(arr_temp, n, OETSORT_INT32, num_threads, 0, &expected, &v);
+        ok = ok && sorted && v.same_keys;
+
+        printf("Método: %s\n", methods[k].name);
+        printf("  Tempo: %.6f s\n", t);
+        printf("  Segmentos por segundo: %.1f\n", num_segments / t);
+        printf("  Speedup: %.4f\n", t_loop / t);
+        printf("  Segmentos ordenados: %s\n", sorted ? "Sim" : "Não");
+        printf("  Mesmos elementos da entrada: %s\n\n", v.same_keys ? "Sim" : "Não");
+        save_segments_result(results_path("segmentos.csv", input), n, num_segments, min_len, max_len, num_threads, methods[k].name, t, t_loop / t);
     }
+
+    free(offsets);
+    free(arr_base);
+    free(arr_temp);
+    return ok;
 }
 
-// Versão paralela com OpenMP e escalonamento (schedule) GUIADO.
-void odd_even_sort_openmp_guided(int arr[], int n, int num_threads) {
-    int phase, i;
-    #pragma omp parallel num_threads(num_threads) default(none) shared(arr, n) private(phase, i)
-    {
-        for (phase = 0; phase < n; phase++) {
-            if (phase % 2 == 0) { // Fase Par
-                // 'schedule(guided)': semelhante ao dynamic, mas o tamanho dos blocos diminui
-                // ao longo do tempo. Começa com blocos grandes e termina com pequenos.
-                // É um meio-termo entre static e dynamic.
-                #pragma omp for schedule(guided)
-                for (i = 1; i < n; i += 2) {
-                    if (arr[i - 1] > arr[i]) {
-                        swap(&arr[i - 1], &arr[i]);
-                    }
-                }
-            } else { // Fase Ímpar
-                #pragma omp for schedule(guided)
-                for (i = 1; i < n - 1; i += 2) {
-                    if (arr[i] > arr[i + 1]) {
-                        swap(&arr[i], &arr[i + 1]);
-                    }
-                }
-            }
+// Autoajuste (--autoajuste): usa a configuração do cache para esta CPU e faixa de
+// tamanho ou, se não houver (ou com --autoajuste=refazer), mede todas as configurações
+// de tune_candidates e grava a vencedora no cache. Depois ordena com ela.
+// Retorna 1 se o resultado estiver correto.
+int run_autotune_openmp(int n, int max_threads, int refresh, const oetsort_input *input) {
+    int *arr_base = malloc(n * sizeof(int));
+    int *arr_temp = malloc(n * sizeof(int));
+    oetsort_generate(arr_base, n, 0, n, OETSORT_INT32, input);
+    oetsort_fingerprint expected;
+    oetsort_fingerprint_keys(arr_base, n, OETSORT_INT32, max_threads, 0, &expected);
+
+    tune_key key;
+    tune_key_init(&key, n, max_threads);
+    printf("--- Configuração ---\n");
+    printf("Tamanho do array: %d (faixa de 2^%d a 2^%d)\n", n, key.bucket, key.bucket + 1);
+    printf("Entrada: %s (semente %llu)\n", oetsort_distribution_name(input->dist), (unsigned long long)input->seed);
+    printf("Threads: até %d\n", max_threads);
+    printf("CPU: %s (%d CPUs)\n", key.cpu, key.cores);
+    printf("Kernel: %s\n\n", oetsort_kernel_name());
+
+    tune_config cfg = {OETSORT_SERIAL, 1, 0, 0, 0.0};
+    int cached = !refresh && tune_cache_lookup(TUNE_CACHE_PATH, &key, &cfg);
+    if (!cached) {
+        printf("--- Busca ---\n");
+        double start = omp_get_wtime();
+        if (!tune_search(arr_base, arr_temp, n, max_threads, &expected, &cfg)) {
+            printf("Nenhuma configuração ordenou corretamente.\n");
+            free(arr_base);
+            free(arr_temp);
+            return 0;
         }
+        printf("Tempo total da busca: %.3f s\n\n", omp_get_wtime() - start);
+        tune_cache_store(TUNE_CACHE_PATH, &key, &cfg);
     }
+
+    char label[96];
+    tune_describe(&cfg, label, sizeof(label));
+    printf("--- Configuração %s ---\n", cached ? "do cache (sem busca)" : "escolhida (gravada no cache)");
+    printf("%s\n", label);
+    oetsort_options opts;
+    tune_options(&cfg, &opts);
+    memcpy(arr_temp, arr_base, n * sizeof(int));
+    double start_time = omp_get_wtime();
+    oetsort_sort(arr_temp, n, &opts, NULL);
+    double t = omp_get_wtime() - start_time;
+    printf("  Tempo: %.6f s\n", t);
+    int ok = report_verification("  ", arr_temp, n, &expected);
+
+    free(arr_base);
+    free(arr_temp);
+    return ok;
 }
 
+// Posicionamento de memória e threads (--posicionamento).
+enum {
+    PLACEMENT_DEFAULT,  // Cópia pela thread mestre (primeiro toque em um único nó), threads livres.
+    PLACEMENT_NUMA,     // Primeiro toque por cada thread e threads fixadas (numa_utils.h).
+    PLACEMENT_COMPARE   // Executa os dois, para medir a penalidade entre soquetes.
+};
+
+// Executa todos os schedules OpenMP sobre cópias de 'arr_base' em 'arr_temp', imprime
+// os resultados e salva os CSVs. Com 'numa', as cópias são paralelas (schedule static,
+// preservando o nó de cada página) e os schedules são salvos com o sufixo "-numa", para
+// que as duas curvas de speedup possam ser comparadas.
+void run_schedules(const int arr_base[], int arr_temp[], int n, int num_threads, int adaptive, int tile, double t_serial,
+                   int numa, const oetsort_fingerprint *expected, const oetsort_input *input) {
+    static const struct {
+        const char *name;
+        oetsort_backend backend;
+    } schedules[] = {
+        {"static", OETSORT_OPENMP_STATIC},
+        {"dynamic", OETSORT_OPENMP_DYNAMIC},
+        {"guided", OETSORT_OPENMP_GUIDED},
+        // Sincronização entre vizinhos (sem barreira global por fase). Não há variante
+        // adaptativa: detectar a convergência exigiria a sincronização global que ele evita.
+        {"neighbor", OETSORT_OPENMP_NEIGHBOR},
+        // Ladrilhamento temporal (apenas quando --tile é informado).
+        {"tiled", OETSORT_OPENMP_TILED},
+        // Pool persistente de pthreads com barreira de espera ativa (pool_utils.h), sem
+        // variante adaptativa.
+        {"pool", OETSORT_PTHREAD_POOL},
+    };
 
+    for (size_t k = 0; k < sizeof(schedules) / sizeof(schedules[0]); k++) {
+        oetsort_backend backend = schedules[k].backend;
+        if (adaptive && (backend == OETSORT_OPENMP_NEIGHBOR || backend == OETSORT_OPENMP_TILED || backend == OETSORT_PTHREAD_POOL)) continue;
+        if (backend == OETSORT_OPENMP_TILED && tile == 0) continue;
+        char label[32];
+        snprintf(label, sizeof(label), "%s%s", schedules[k].name, numa ? "-numa" : "");
+
+        if (numa) parallel_copy_ints(arr_temp, arr_base, n, num_threads);
+        else memcpy(arr_temp, arr_base, n * sizeof(int));
+        double start_time = omp_get_wtime();
+        int phases = run_backend(arr_temp, n, backend, num_threads, adaptive, backend == OETSORT_OPENMP_TILED ? tile : 0);
+        double end_time = omp_get_wtime();
+        double t_parallel = end_time - start_time;
+        double speedup = t_serial / t_parallel;
+        double efficiency = speedup / num_threads;
+        printf("Schedule: %s\n", label);
+        printf("  Tempo: %.6f s\n", t_parallel);
+        printf("  Speedup: %.4f\n", speedup);
+        printf("  Eficiência: %.4f\n", efficiency);
+        if (adaptive) printf("  Fases executadas: %d de %d\n", phases, n);
+        report_verification("  ", arr_temp, n, expected);
+        printf("\n");
+        if (adaptive) {
+            save_adaptive_result(results_path("adaptativo.csv", input), "openmp", n, num_threads, label, t_parallel, phases);
+        } else {
+            save_openmp_result(results_path("openmp.csv", input), n, num_threads, label, t_parallel, speedup, efficiency);
+        }
+    }
+}
 
 int main(int argc, char *argv[]) {
-    if (argc != 3) {
-        printf("Uso: %s <tamanho_array> <num_threads>\n", argv[0]);
+    // --adaptativo: interrompe a ordenação assim que um par de fases não faz trocas.
+    // --kernel: força o kernel de compare-exchange (auto, avx512, avx2 ou escalar).
+    // --tile=K: inclui na comparação o motor com ladrilhamento temporal (tiles de K elementos).
+    // --tipo: tipo da chave (int32, int64, float ou double).
+    // --payload=B: ordena registros com B bytes de payload (B >= 4) além da chave.
+    // --entrada=arquivo: ordena no lugar um arquivo binário de inteiros de 32 bits mapeado em
+    // memória, com o schedule de --schedule; --saida=arquivo grava o resultado em outro arquivo.
+    const char *input_path = get_option(argc, argv, "entrada", NULL);
+    const char *output_path = get_option(argc, argv, "saida", NULL);
+    const char *schedule = get_option(argc, argv, "schedule", NULL);
+    int file_mode = input_path != NULL;
+    oetsort_backend file_backend = OETSORT_OPENMP_STATIC;
+    if (schedule != NULL) {
+        if (strcmp(schedule, "dynamic") == 0) file_backend = OETSORT_OPENMP_DYNAMIC;
+        else if (strcmp(schedule, "guided") == 0) file_backend = OETSORT_OPENMP_GUIDED;
+        else if (strcmp(schedule, "neighbor") == 0) file_backend = OETSORT_OPENMP_NEIGHBOR;
+        else if (strcmp(schedule, "tiled") == 0) file_backend = OETSORT_OPENMP_TILED;
+        else if (strcmp(schedule, "pool") == 0) file_backend = OETSORT_PTHREAD_POOL;
+        else if (strcmp(schedule, "static") != 0) schedule = "";
+    }
+    int adaptive = has_flag(argc, argv, "adaptativo");
+    // --medir-serial: mede a linha de base serial mesmo que ela esteja no cache (baseline_utils.h).
+    int measure_serial = has_flag(argc, argv, "medir-serial");
+    // --posicionamento=padrao|numa|comparar: posicionamento de memória e threads (ver numa_utils.h).
+    const char *placement_name = get_option(argc, argv, "posicionamento", "padrao");
+    int placement = PLACEMENT_DEFAULT;
+    if (strcmp(placement_name, "numa") == 0) placement = PLACEMENT_NUMA;
+    else if (strcmp(placement_name, "comparar") == 0) placement = PLACEMENT_COMPARE;
+    else if (strcmp(placement_name, "padrao") != 0) placement = -1;
+    int tile = atoi(get_option(argc, argv, "tile", "0"));
+    oetsort_key_type type = OETSORT_INT32;
+    int type_ok = oetsort_key_type_from_name(get_option(argc, argv, "tipo", "int32"), &type) == OETSORT_OK;
+    int payload_bytes = atoi(get_option(argc, argv, "payload", "0"));
+    int typed = type != OETSORT_INT32 || payload_bytes != 0;
+    // --dist, --semente, --deslocamentos, --unicos e --zipf: distribuição da entrada gerada.
+    oetsort_input input;
+    int input_ok = read_input_options(argc, argv, &input);
+    // --autoajuste[=refazer]: escolhe threads, schedule, chunk e tile pelo cache ou por busca.
+    const char *autotune_value = get_option(argc, argv, "autoajuste", NULL);
+    int autotune = has_flag(argc, argv, "autoajuste") || autotune_value != NULL;
+    int refresh = autotune_value != NULL && strcmp(autotune_value, "refazer") == 0;
+    int autotune_ok = !autotune || ((autotune_value == NULL || refresh) && !file_mode && !typed && !adaptive && tile == 0 &&
+                                    placement == PLACEMENT_DEFAULT);
+    // --segmentos=MIN:MAX: ordena em lote segmentos independentes de MIN a MAX elementos.
+    const char *segments = get_option(argc, argv, "segmentos", NULL);
+    int min_len = 0, max_len = 0;
+    int segments_ok = segments == NULL || (sscanf(segments, "%d:%d", &min_len, &max_len) == 2 && min_len >= 1 && max_len >= min_len);
+    if (!segments_ok || (segments != NULL && (file_mode || typed || adaptive || tile > 0 || placement != PLACEMENT_DEFAULT || autotune))) {
+        segments_ok = 0;
+    }
+    // --rastro=arquivo.json: grava o rastro por fase das execuções OpenMP (trace_utils.h);
+    // --rastro-cada=K: registra uma fase a cada K (0 = automático).
+    const char *trace_path = get_option(argc, argv, "rastro", NULL);
+    int trace_every = atoi(get_option(argc, argv, "rastro-cada", "0"));
+    int trace_ok = trace_every >= 0 && (trace_path == NULL || !(file_mode || typed || segments != NULL || autotune));
+    if (count_positional_args(argc, argv) != (file_mode ? 2 : 3) || (output_path != NULL && !file_mode) || !segments_ok || !autotune_ok || !trace_ok ||
+        (schedule != NULL && (!file_mode || *schedule == '\0')) || (file_mode && typed) || !input_ok ||
+        (file_backend == OETSORT_OPENMP_TILED) != (file_mode && tile > 0) ||
+        (adaptive && (file_backend == OETSORT_OPENMP_NEIGHBOR || file_backend == OETSORT_OPENMP_TILED || file_backend == OETSORT_PTHREAD_POOL)) || oetsort_set_kernel(get_option(argc, argv, "kernel", "auto")) != OETSORT_OK ||
+        tile < 0 || tile == 1 || placement < 0 || (placement != PLACEMENT_DEFAULT && (file_mode || typed)) ||
+        !type_ok || (payload_bytes != 0 && payload_bytes < 4) || (typed && (adaptive || tile > 0))) {
+        printf("Uso: %s <tamanho_array> <num_threads> [--adaptativo] [--tile=K] [--kernel=auto|avx512|avx2|escalar]\n", argv[0]);
+        printf("       %s <tamanho_array> <num_threads> [--posicionamento=padrao|numa|comparar]\n", argv[0]);
+        printf("       %s <tamanho_array> <num_threads> [--tipo=int32|int64|float|double] [--payload=B]\n", argv[0]);
+        printf("       %s <tamanho_total> <num_threads> --segmentos=MIN:MAX\n", argv[0]);
+        printf("       %s <tamanho_array> <max_threads> --autoajuste[=refazer]\n", argv[0]);
+        printf("       %s <num_threads> --entrada=arquivo.bin [--saida=arquivo.bin] [--schedule=static|dynamic|guided|neighbor|pool|tiled --tile=K] [--adaptativo]\n", argv[0]);
+        printf("Entrada gerada: [--dist=uniforme|ordenado|invertido|quase-ordenado|poucos-unicos|zipf|tubos-de-orgao] [--semente=S]\n");
+        printf("                [--deslocamentos=K] [--unicos=U] [--zipf=s]\n");
+        printf("Linha de base: [--medir-serial] (ignora o cache de linha de base)\n");
+        printf("Rastro por fase: [--rastro=arquivo.json] [--rastro-cada=K]\n");
         return 1;
     }
 
+    // Entrada por arquivo mapeado em memória.
+    if (file_mode) {
+        int num_threads = atoi(argv[1]);
+        return run_file_openmp(input_path, output_path, file_backend, num_threads, adaptive, tile) ? 0 : 1;
+    }
+
     int n = atoi(argv[1]);
     int num_threads = atoi(argv[2]);
+
+    // Autoajuste com cache em disco.
+    if (autotune) {
+        return run_autotune_openmp(n, num_threads, refresh, &input) ? 0 : 1;
+    }
+
+    // Lote de segmentos independentes.
+    if (segments != NULL) {
+        return run_segments_openmp(n, num_threads, min_len, max_len, &input) ? 0 : 1;
+    }
+
+    // Tipos genéricos e registros têm um caminho próprio; o caminho int abaixo não muda.
+    if (typed) {
+        return run_typed_openmp(type, n, num_threads, payload_bytes, &input) ? 0 : 1;
+    }
+
     int *arr_base = malloc(n * sizeof(int)); // Array original não modificado
     int *arr_temp = malloc(n * sizeof(int)); // Cópia para cada execução
 
-    generate_random_array(arr_base, n, 1000);
+    oetsort_generate(arr_base, n, 0, n, OETSORT_INT32, &input);
+    // Impressão digital da entrada: cada execução é verificada sem ordenação de referência.
+    oetsort_fingerprint expected;
+    oetsort_fingerprint_keys(arr_base, n, OETSORT_INT32, num_threads, 0, &expected);
 
     printf("--- Configuração ---\n");
     printf("Tamanho do array: %d\n", n);
-    printf("Threads: %d\n\n", num_threads);
+    printf("Entrada: %s (semente %llu)\n", oetsort_distribution_name(input.dist), (unsigned long long)input.seed);
+    printf("Threads: %d\n", num_threads);
+    printf("Posicionamento: %s\n", placement_name);
+    printf("Parada antecipada: %s\n", adaptive ? "Sim" : "Não");
+    printf("Kernel: %s\n", oetsort_kernel_name());
+    if (tile > 0) printf("Tile: %d elementos (%d fases por bloco)\n", tile, tile / 2);
+    printf("\n");
 
     // --- Execução Serial (para linha de base) ---
-    memcpy(arr_temp, arr_base, n * sizeof(int)); // Copia o array original
-    double start_time_serial = omp_get_wtime(); // Inicia a contagem de tempo
-    odd_even_sort_serial(arr_temp, n);
-    double end_time_serial = omp_get_wtime(); // Finaliza a contagem
-    double t_serial = end_time_serial - start_time_serial;
+    // O tempo vem do cache de linha de base (baseline_utils.h) quando esta entrada já foi
+    // medida com esta compilação da biblioteca; caso contrário é medido e gravado.
+    const char *variant = adaptive ? "odd-even-adaptativo" : "odd-even";
+    double t_serial;
     printf("--- Serial ---\n");
-    printf("Tempo de execução: %.6f segundos\n", t_serial);
-    printf("Array está ordenado: %s\n\n", is_sorted(arr_temp, n) ? "Sim" : "Não");
+    if (!measure_serial && baseline_lookup(variant, n, &input, &t_serial)) {
+        printf("Tempo de execução: %.6f segundos (cache de linha de base)\n", t_serial);
+    } else {
+        memcpy(arr_temp, arr_base, n * sizeof(int)); // Copia o array original
+        double start_time_serial = omp_get_wtime(); // Inicia a contagem de tempo
+        int phases_serial = run_backend(arr_temp, n, OETSORT_SERIAL, 1, adaptive, 0);
+        double end_time_serial = omp_get_wtime(); // Finaliza a contagem
+        t_serial = end_time_serial - start_time_serial;
+        printf("Tempo de execução: %.6f segundos\n", t_serial);
+        if (adaptive) printf("Fases executadas: %d de %d\n", phases_serial, n);
+        if (report_verification("", arr_temp, n, &expected)) baseline_store(variant, n, &input, t_serial);
+    }
+    printf("\n");
 
     // --- Análise de Performance OpenMP ---
+    // Com --rastro, as execuções abaixo são registradas (a linha de base não).
+    if (trace_path != NULL) oetsort_trace_start(trace_every, 0);
     printf("--- Análise de Performance OpenMP ---\n");
+    if (placement != PLACEMENT_NUMA) {
+        if (placement == PLACEMENT_COMPARE) printf("Posicionamento: padrão (cópia pela thread mestre, threads não fixadas)\n\n");
+        run_schedules(arr_base, arr_temp, n, num_threads, adaptive, tile, t_serial, 0, &expected, &input);
+    }
 
-    // Execução com schedule Static
-    memcpy(arr_temp, arr_base, n * sizeof(int));
-    double start_time_static = omp_get_wtime();
-    odd_even_sort_openmp_static(arr_temp, n, num_threads);
-    double end_time_static = omp_get_wtime();
-    double t_parallel_static = end_time_static - start_time_static;
-    double speedup_static = t_serial / t_parallel_static;
-    double efficiency_static = speedup_static / num_threads;
-    printf("Schedule: static\n");
-    printf("  Tempo: %.6f s\n", t_parallel_static);
-    printf("  Speedup: %.4f\n", speedup_static);
-    printf("  Eficiência: %.4f\n", efficiency_static);
-    printf("  Array está ordenado: %s\n\n", is_sorted(arr_temp, n) ? "Sim" : "Não");
-    save_openmp_result("data/openmp.csv", n, num_threads, "static", t_parallel_static, speedup_static, efficiency_static);
-
-    // Execução com schedule Dynamic
-    memcpy(arr_temp, arr_base, n * sizeof(int));
-    double start_time_dynamic = omp_get_wtime();
-    odd_even_sort_openmp_dynamic(arr_temp, n, num_threads);
-    double end_time_dynamic = omp_get_wtime();
-    double t_parallel_dynamic = end_time_dynamic - start_time_dynamic;
-    double speedup_dynamic = t_serial / t_parallel_dynamic;
-    double efficiency_dynamic = speedup_dynamic / num_threads;
-    printf("Schedule: dynamic\n");
-    printf("  Tempo: %.6f s\n", t_parallel_dynamic);
-    printf("  Speedup: %.4f\n", speedup_dynamic);
-    printf("  Eficiência: %.4f\n", efficiency_dynamic);
-    printf("  Array está ordenado: %s\n\n", is_sorted(arr_temp, n) ? "Sim" : "Não");
-    save_openmp_result("data/openmp.csv", n, num_threads, "dynamic", t_parallel_dynamic, speedup_dynamic, efficiency_dynamic);
-
-    // Execução com schedule Guided
-    memcpy(arr_temp, arr_base, n * sizeof(int));
-    double start_time_guided = omp_get_wtime();
-    odd_even_sort_openmp_guided(arr_temp, n, num_threads);
-    double end_time_guided = omp_get_wtime();
-    double t_parallel_guided = end_time_guided - start_time_guided;
-    double speedup_guided = t_serial / t_parallel_guided;
-    double efficiency_guided = speedup_guided / num_threads;
-    printf("Schedule: guided\n");
-    printf("  Tempo: %.6f s\n", t_parallel_guided);
-    printf("  Speedup: %.4f\n", speedup_guided);
-    printf("  Eficiência: %.4f\n", efficiency_guided);
-    printf("  Array está ordenado: %s\n", is_sorted(arr_temp, n) ? "Sim" : "Não");
-    save_openmp_result("data/openmp.csv", n, num_threads, "guided", t_parallel_guided, speedup_guided, efficiency_guided);
+    // --- Posicionamento NUMA: threads fixadas e páginas tocadas primeiro por suas donas ---
+    if (placement != PLACEMENT_DEFAULT) {
+        cpu_info *cpus;
+        int num_cpus = numa_list_cpus(&cpus);
+        int *plan = malloc(num_threads * sizeof(int));
+        numa_plan(cpus, num_cpus, num_threads, plan);
+        numa_pin_threads(cpus, plan, num_threads);
+
+        int *arr_numa = numa_alloc_ints(n);
+        parallel_copy_ints(arr_numa, arr_base, n, num_threads); // Primeiro toque.
+        printf("Posicionamento: numa (%d CPUs disponíveis)\n", num_cpus);
+        numa_report(arr_numa, n, num_threads);
+        printf("\n");
+        run_schedules(arr_base, arr_numa, n, num_threads, adaptive, tile, t_serial, 1, &expected, &input);
+
+        numa_free_ints(arr_numa, n);
+        free(plan);
+        free(cpus);
+    }
+
+    if (trace_path != NULL) {
+        if (oetsort_trace_stop(trace_path, 0) == OETSORT_OK) {
+            printf("Rastro por fase salvo em '%s'\n", trace_path);
+        } else {
+            fprintf(stderr, "Falha ao gravar o rastro em '%s'\n", trace_path);
+        }
+    }
 
     free(arr_base);
     free(arr_temp);
@@ -1,59 +1,195 @@
 #define _POSIX_C_SOURCE 199309L // Define a versão do POSIX para ter acesso a clock_gettime
+#define _GNU_SOURCE // Para MAP_POPULATE e copy_file_range (mmap_utils.h)
 #include <stdio.h>
 #include <stdlib.h>
 #include <time.h>
 #include "utils.h"
 #include "csv_utils.h"
+#include "mmap_utils.h"
+#include "oetsort.h" // Biblioteca com os algoritmos de ordenação
+
+// Executa a ordenação serial com um tipo de chave genérico (--tipo) e, se
+// payload_bytes > 0, com registros chave + payload (--payload).
+// Os registros são ordenados pelas chaves e índices; o payload é movido uma única
+// vez ao final. Retorna 1 se o resultado estiver correto.
+int run_typed_serial(oetsort_key_type type, int n, int payload_bytes, const oetsort_input *input) {
+    size_t key_size = oetsort_key_size(type);
+    void *keys = malloc((size_t)n * key_size);
+    void *original_keys = NULL;
+    uint32_t *idx = NULL;
+    void *payload = NULL, *sorted_payload = NULL;
+
+    oetsort_generate(keys, n, 0, n, type, input);
+    oetsort_fingerprint expected;
+    oetsort_fingerprint_keys(keys, n, type, 0, 0, &expected);
+    if (payload_bytes > 0) {
+        original_keys = malloc((size_t)n * key_size);
+        memcpy(original_keys, keys, (size_t)n * key_size);
+        idx = malloc((size_t)n * sizeof(uint32_t));
+        init_record_indices(idx, n);
+        payload = malloc((size_t)n * payload_bytes);
+        sorted_payload = malloc((size_t)n * payload_bytes);
+        fill_payload(payload, n, payload_bytes);
+    }
 
-// Função para trocar dois elementos de posição em um array.
-void swap(int *a, int *b) {
-    int temp = *a;
-    *a = *b;
-    *b = temp;
-}
+    printf("--- Configuração ---\n");
+    printf("Tamanho do array: %d\n", n);
+    printf("Entrada: %s (semente %llu)\n", oetsort_distribution_name(input->dist), (unsigned long long)input->seed);
+    printf("Tipo da chave: %s\n", oetsort_key_type_name(type));
+    printf("Payload: %d bytes por registro\n\n", payload_bytes);
+
+    printf("--- Array Original ---\n");
+    oetsort_print_keys(keys, n > 20 ? 20 : n, type);
+    if (n > 20) printf("(exibindo apenas os 20 primeiros elementos)\n");
+    printf("\n");
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
 
-// Implementação do algoritmo Odd-Even Transposition Sort de forma serial.
-void odd_even_sort_serial(int arr[], int n) {
-    int phase, i;
-    // O algoritmo precisa de 'n' fases para garantir a ordenação completa.
-    for (phase = 0; phase < n; phase++) {
-        if (phase % 2 == 0) {
-            // Fase par: compara e troca elementos em posições (arr[i-1], arr[i]) para i ímpar.
-            // Isso cobre os pares (0,1), (2,3), (4,5), ...
-            for (i = 1; i < n; i += 2) {
-                if (arr[i - 1] > arr[i]) {
-                    swap(&arr[i - 1], &arr[i]);
-                }
-            }
-        } else {
-            // Fase ímpar: compara e troca elementos em posições (arr[i], arr[i+1]) para i ímpar.
-            // Isso cobre os pares (1,2), (3,4), (5,6), ...
-            for (i = 1; i < n - 1; i += 2) {
-                if (arr[i] > arr[i + 1]) {
-                    swap(&arr[i], &arr[i + 1]);
-                }
-            }
-        }
+    oetsort_sort_keys(keys, idx, n, type, NULL, NULL);
+    if (payload_bytes > 0) {
+        oetsort_apply_permutation(sorted_payload, payload, idx, n, payload_bytes);
     }
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double time_taken = (end.tv_sec - start.tv_sec) + (double)(end.tv_nsec - start.tv_nsec) / 1e9;
+
+    int ok = verify_keys(keys, n, type, &expected);
+    if (payload_bytes > 0) {
+        ok = ok && verify_records(keys, original_keys, key_size, sorted_payload, idx, n, payload_bytes);
+    }
+
+    printf("--- Resultados ---\n");
+    printf("Tempo de execução: %.6f segundos\n", time_taken);
+    printf("Array ordenado: ");
+    oetsort_print_keys(keys, n > 20 ? 20 : n, type);
+    if (n > 20) printf("(exibindo apenas os 20 primeiros elementos)\n");
+    printf("Array está ordenado%s: %s\n", payload_bytes > 0 ? " (e registros íntegros)" : " (e permutação da entrada)", ok ? "Sim" : "Não");
+
+    save_typed_result(results_path("tipos.csv", input), "serial", oetsort_key_type_name(type), payload_bytes, n, 1, time_taken, 1.0, 1.0);
+
+    free(keys);
+    free(original_keys);
+    free(idx);
+    free(payload);
+    free(sorted_payload);
+    return ok;
 }
 
+// Ordena no lugar um arquivo binário bruto de inteiros (--entrada), mapeado em
+// memória, ou uma cópia dele feita em 'output' (--saida). Não há geração de dados,
+// cópia para um buffer nem escrita no CSV: os dados não são os dos experimentos.
+// Retorna 1 se o resultado estiver ordenado.
+int run_file_serial(const char *input, const char *output, const oetsort_options *opts) {
+    long long size = file_size_bytes(input);
+    if (size < 0) return 0;
+    if (size % sizeof(int) != 0 || size / sizeof(int) > 2147483647LL) {
+        printf("O tamanho de '%s' não corresponde a um array de inteiros de 32 bits.\n", input);
+        return 0;
+    }
+    int n = (int)(size / sizeof(int));
+
+    struct timespec start_map, end_map, start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start_map);
+    mapped_file m;
+    if (output != NULL && !create_output_file(output, (size_t)size)) return 0;
+    if (!map_sort_range(input, output, 0, (size_t)size, &m)) return 0;
+    int *arr = (int *)m.data;
+    clock_gettime(CLOCK_MONOTONIC, &end_map);
+
+    // Impressão digital da entrada, para verificar depois que nenhum elemento foi alterado.
+    oetsort_fingerprint expected;
+    oetsort_fingerprint_keys(arr, n, OETSORT_INT32, 0, 0, &expected);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    oetsort_stats stats;
+    oetsort_sort(arr, n, opts, &stats);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    double map_time = (end_map.tv_sec - start_map.tv_sec) + (double)(end_map.tv_nsec - start_map.tv_nsec) / 1e9;
+    double time_taken = (end.tv_sec - start.tv_sec) + (double)(end.tv_nsec - start.tv_nsec) / 1e9;
 
+    printf("--- Configuração ---\n");
+    printf("Entrada: %s (%d elementos)\n", input, n);
+    printf("Saída: %s\n", output != NULL ? output : "no próprio arquivo de entrada");
+    printf("Kernel: %s\n\n", oetsort_kernel_name());
+
+    printf("--- Resultados ---\n");
+    printf("Tempo de mapeamento: %.6f segundos\n", map_time);
+    printf("Tempo de execução: %.6f segundos\n", time_taken);
+    printf("Fases executadas: %d de %d\n", stats.phases_run, n);
+    printf("Array ordenado: ");
+    print_array(arr, n > 20 ? 20 : n);
+    if (n > 20) printf("(exibindo apenas os 20 primeiros elementos)\n");
+    int ok = report_verification("", arr, n, &expected);
+
+    unmap_file(&m);
+    return ok;
+}
 
 int main(int argc, char *argv[]) {
     // Validação dos argumentos de linha de comando.
-    if (argc != 2) {
-        printf("Uso: %s <tamanho_array>\n", argv[0]);
+    // --adaptativo: interrompe a ordenação assim que um par de fases não faz trocas.
+    // --kernel: força o kernel de compare-exchange (auto, avx512, avx2 ou escalar).
+    // --tile=K: usa o ladrilhamento temporal com tiles de K elementos (K >= 2).
+    // --tipo: tipo da chave (int32, int64, float ou double).
+    // --payload=B: ordena registros com B bytes de payload (B >= 4) além da chave.
+    // --entrada=arquivo: ordena no lugar um arquivo binário de inteiros de 32 bits mapeado em
+    // memória (o tamanho do array vem do arquivo); --saida=arquivo grava o resultado em outro arquivo.
+    const char *input_path = get_option(argc, argv, "entrada", NULL);
+    const char *output_path = get_option(argc, argv, "saida", NULL);
+    int file_mode = input_path != NULL;
+    int adaptive = has_flag(argc, argv, "adaptativo");
+    int tile = atoi(get_option(argc, argv, "tile", "0"));
+    oetsort_key_type type = OETSORT_INT32;
+    int type_ok = oetsort_key_type_from_name(get_option(argc, argv, "tipo", "int32"), &type) == OETSORT_OK;
+    int payload_bytes = atoi(get_option(argc, argv, "payload", "0"));
+    int typed = type != OETSORT_INT32 || payload_bytes != 0;
+    // --dist, --semente, --deslocamentos, --unicos e --zipf: distribuição da entrada gerada.
+    oetsort_input input;
+    int input_ok = read_input_options(argc, argv, &input);
+    if (count_positional_args(argc, argv) != (file_mode ? 1 : 2) || (output_path != NULL && !file_mode) || (file_mode && typed) || !input_ok || oetsort_set_kernel(get_option(argc, argv, "kernel", "auto")) != OETSORT_OK ||
+        tile < 0 || tile == 1 || (tile > 0 && adaptive) ||
+        !type_ok || (payload_bytes != 0 && payload_bytes < 4) || (typed && (adaptive || tile > 0))) {
+        printf("Uso: %s <tamanho_array> [--adaptativo | --tile=K] [--kernel=auto|avx512|avx2|escalar]\n", argv[0]);
+        printf("       %s <tamanho_array> [--tipo=int32|int64|float|double] [--payload=B]\n", argv[0]);
+        printf("       %s --entrada=arquivo.bin [--saida=arquivo.bin] [--adaptativo | --tile=K]\n", argv[0]);
+        printf("Entrada gerada: [--dist=uniforme|ordenado|invertido|quase-ordenado|poucos-unicos|zipf|tubos-de-orgao] [--semente=S]\n");
+        printf("                [--deslocamentos=K] [--unicos=U] [--zipf=s]\n");
         return 1;
     }
 
+    // Entrada por arquivo mapeado em memória.
+    if (file_mode) {
+        oetsort_options opts;
+        oetsort_default_options(&opts);
+        opts.backend = (tile > 0) ? OETSORT_SERIAL_TILED : OETSORT_SERIAL;
+        opts.tile = tile;
+        opts.adaptive = adaptive;
+        return run_file_serial(input_path, output_path, &opts) ? 0 : 1;
+    }
+
     int n = atoi(argv[1]); // Converte o tamanho do array de string para inteiro.
+
+    // Tipos genéricos e registros têm um caminho próprio; o caminho int abaixo não muda.
+    if (typed) {
+        return run_typed_serial(type, n, payload_bytes, &input) ? 0 : 1;
+    }
+
     int *arr = malloc(n * sizeof(int)); // Aloca memória para o array.
 
-    // Gera um array com números aleatórios.
-    generate_random_array(arr, n, 1000);
+    // Gera a entrada com a distribuição e a semente escolhidas.
+    oetsort_generate(arr, n, 0, n, OETSORT_INT32, &input);
+    oetsort_fingerprint expected;
+    oetsort_fingerprint_keys(arr, n, OETSORT_INT32, 0, 0, &expected);
 
     printf("--- Configuração ---\n");
-    printf("Tamanho do array: %d\n\n", n);
+    printf("Tamanho do array: %d\n", n);
+    printf("Entrada: %s (semente %llu)\n", oetsort_distribution_name(input.dist), (unsigned long long)input.seed);
+    printf("Parada antecipada: %s\n", adaptive ? "Sim" : "Não");
+    printf("Kernel: %s\n", oetsort_kernel_name());
+    if (tile > 0) printf("Tile: %d elementos (%d fases por bloco)\n", tile, tile / 2);
+    printf("\n");
 
     printf("--- Array Original ---\n");
     print_array(arr, n > 20 ? 20 : n); // Imprime os 20 primeiros elementos para visualização.
@@ -64,7 +200,15 @@ int main(int argc, char *argv[]) {
     struct timespec start, end;
     clock_gettime(CLOCK_MONOTONIC, &start);
 
-    odd_even_sort_serial(arr, n); // Executa a ordenação.
+    // Executa a ordenação.
+    oetsort_options opts;
+    oetsort_default_options(&opts);
+    opts.backend = (tile > 0) ? OETSORT_SERIAL_TILED : OETSORT_SERIAL;
+    opts.tile = tile;
+    opts.adaptive = adaptive;
+    oetsort_stats stats;
+    oetsort_sort(arr, n, &opts, &stats);
+    int phases_run = stats.phases_run;
 
     clock_gettime(CLOCK_MONOTONIC, &end);
 
@@ -73,16 +217,25 @@ int main(int argc, char *argv[]) {
 
     printf("--- Resultados ---\n");
     printf("Tempo de execução: %.6f segundos\n", time_taken);
+    printf("Fases executadas: %d de %d\n", phases_run, n);
 
     printf("Array ordenado: ");
     print_array(arr, n > 20 ? 20 : n);
     if (n > 20) printf("(exibindo apenas os 20 primeiros elementos)\n");
 
-    // Verifica se o array está de fato ordenado.
-    printf("Array está ordenado: %s\n", is_sorted(arr, n) ? "Sim" : "Não");
+    // Verifica se o array está de fato ordenado e se é uma permutação da entrada.
+    report_verification("", arr, n, &expected);
 
     // Salva o resultado (tamanho do array e tempo) no arquivo CSV.
-    save_serial_result("data/serial.csv", n, time_taken);
+    // As execuções adaptativas vão para um arquivo próprio, para não misturar as médias.
+    // Entradas não uniformes vão para um subdiretório próprio (ver results_path).
+    if (adaptive) {
+        save_adaptive_result(results_path("adaptativo.csv", &input), "serial", n, 1, "serial", time_taken, phases_run);
+    } else if (tile > 0) {
+        save_serial_result(results_path("serial_tiled.csv", &input), n, time_taken);
+    } else {
+        save_serial_result(results_path("serial.csv", &input), n, time_taken);
+    }
 
     free(arr); // Libera a memória alocada.
     return 0;
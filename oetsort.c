@@ -0,0 +1,1643 @@
+#define _GNU_SOURCE // Para afinidade das threads do pool (pool_utils.h) e syscall() (counter_utils.h)
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#ifdef _OPENMP
+#include <omp.h> // Biblioteca OpenMP
+#include <sched.h> // Para sched_yield()
+#endif
+#ifdef OETSORT_WITH_MPI
+#include <mpi.h>
+#endif
+#include "oetsort.h"
+#include "pool_utils.h"
+#include "counter_utils.h"
+#include "trace_utils.h"
+#include "simd_utils.h"
+#include "tile_utils.h"
+#include "network_utils.h"
+#ifdef OETSORT_WITH_MPI
+#include "exchange_utils.h" // Antes de key_types.h: a versão MPI por tipo usa phase_partner.
+#endif
+#include "key_types.h"
+#include "gen_utils.h"
+
+/*
+ * Implementação da liboetsort (ver oetsort.h).
+ *
+ * Toda a biblioteca fica em uma única unidade de compilação para que o kernel de
+ * compare-exchange selecionado (estado de simd_utils.h) seja o mesmo em todos os
+ * backends. Os backends OpenMP são compilados quando a biblioteca é compilada com
+ * OpenMP; os backends MPI e o híbrido, quando OETSORT_WITH_MPI está definido.
+ */
+
+// ------------------------------------------------------------------------------------
+// Backends seriais
+// ------------------------------------------------------------------------------------
+
+// Implementação do algoritmo Odd-Even Transposition Sort de forma serial.
+static void odd_even_sort_serial(int arr[], int n) {
+    // O algoritmo precisa de 'n' fases para garantir a ordenação completa.
+    // Fase par: ordena os pares (0,1), (2,3), (4,5), ...
+    // Fase ímpar: ordena os pares (1,2), (3,4), (5,6), ...
+    // Os pares de cada fase são ordenados sem desvios pelo kernel de
+    // compare-exchange vetorizado (simd_utils.h).
+    for (int phase = 0; phase < n; phase++) {
+        trace_span span = trace_begin(phase);
+        phase_odd_even(arr, n, phase);
+        trace_step(&span, TRACE_COMPUTE);
+    }
+}
+
+// Versão adaptativa do algoritmo serial: interrompe a ordenação quando um par de
+// fases (par + ímpar) termina sem nenhuma troca, pois nesse caso todos os pares
+// adjacentes já estão em ordem. Retorna o número de fases efetivamente executadas.
+static int odd_even_sort_serial_adaptive(int arr[], int n) {
+    int swapped = 0;
+    for (int phase = 0; phase < n; phase++) {
+        if (phase % 2 == 0) swapped = 0; // Início de um novo par de fases.
+        trace_span span = trace_begin(phase);
+        swapped |= phase_odd_even(arr, n, phase);
+        trace_step(&span, TRACE_COMPUTE);
+        if (phase % 2 == 1 && !swapped) return phase + 1; // Par de fases sem trocas: array ordenado.
+    }
+    return n;
+}
+
+// Versão com ladrilhamento temporal: aplica tile/2 fases consecutivas a cada tile
+// de 'tile' elementos enquanto ele está na cache (ver tile_utils.h). Após o
+// trapézio de cada tile é processado o triângulo da fronteira à sua esquerda,
+// que já tem os dois vizinhos prontos. O resultado é idêntico ao fase a fase.
+static void odd_even_sort_serial_tiled(int arr[], int n, int tile) {
+    int depth = tile / 2;
+    int num_tiles = (n + tile - 1) / tile;
+    for (int p0 = 0; p0 < n; p0 += depth) {
+        int d = (n - p0 < depth) ? n - p0 : depth; // O último bloco pode ser menor.
+        trace_span span = trace_begin_range(p0, d);
+        for (int k = 0; k < num_tiles; k++) {
+            int lo = k * tile;
+            int hi = (lo + tile < n) ? lo + tile : n;
+            tile_trapezoid(arr, n, lo, hi, p0, d);
+            if (k > 0) tile_boundary(arr, n, lo, p0, d);
+        }
+        trace_step(&span, TRACE_COMPUTE);
+    }
+}
+
+// ------------------------------------------------------------------------------------
+// Backends OpenMP
+// ------------------------------------------------------------------------------------
+
+#ifdef _OPENMP
+// Versão paralela com OpenMP para os schedules static, dynamic e guided.
+// Cada fase é dividida em blocos de PHASE_BLOCK_PAIRS pares; as iterações do
+// laço paralelo são os blocos, e cada bloco é ordenado pelo kernel vetorizado.
+// O schedule e o tamanho do pedaço (chunk, em blocos) são escolhidos em tempo de
+// execução ('schedule(runtime)'), como na versão adaptativa abaixo:
+// - static: divide os blocos em pedaços de tamanho igual, distribuídos de forma fixa
+//   entre as threads. Ideal para cargas de trabalho balanceadas.
+// - dynamic: quando uma thread termina um pedaço, ela pega o próximo disponível.
+//   Tem mais overhead que o static, que cresce quanto menor for o pedaço.
+// - guided: semelhante ao dynamic, mas os pedaços começam grandes e diminuem até
+//   'chunk'. É um meio-termo entre static e dynamic.
+// Com chunk 0 é usado o tamanho padrão de cada schedule.
+static void odd_even_sort_openmp_scheduled(int arr[], int n, int num_threads, omp_sched_t kind, int chunk) {
+    int phase, b;
+    int num_blocks = phase_num_blocks(n);
+    omp_set_schedule(kind, chunk);
+    // Inicia a região paralela.
+    // 'num_threads': define o número de threads.
+    // 'default(none)': força a declaração explícita do escopo de cada variável.
+    // 'shared(arr, n, num_blocks)': compartilhados entre todas as threads.
+    // 'private(phase, b)': cada thread tem sua própria cópia de 'phase' e 'b'.
+    #pragma omp parallel num_threads(num_threads) default(none) shared(arr, n, num_blocks) private(phase, b)
+    {
+        COUNTERS_THREAD_BEGIN();
+        for (phase = 0; phase < n; phase++) {
+            trace_span span = trace_begin(phase);
+            // Paraleliza o loop 'for' sobre os blocos da fase (par ou ímpar).
+            // A barreira do fim da fase é explícita para que a espera possa ser
+            // medida (counter_utils.h, trace_utils.h); é a mesma barreira implícita.
+            #pragma omp for schedule(runtime) nowait
+            for (b = 0; b < num_blocks; b++) {
+                phase_block_odd_even(arr, n, phase, b);
+            }
+            trace_step(&span, TRACE_COMPUTE);
+            COUNTERS_BARRIER();
+            trace_step(&span, TRACE_WAIT);
+        }
+        COUNTERS_THREAD_END();
+    }
+}
+
+// Versão paralela ADAPTATIVA: interrompe a ordenação quando um par de fases (par + ímpar)
+// termina sem trocas. O schedule é escolhido em tempo de execução ('schedule(runtime)'),
+// o que permite usar a mesma função para static, dynamic e guided.
+// Cada thread acumula suas trocas em uma variável privada e, ao final do par de fases,
+// a redução é feita em uma flag compartilhada. São usadas duas flags alternadas: a flag
+// do próximo par é zerada pela thread mestre depois da barreira da fase par, quando
+// todas as threads já leram seu valor anterior.
+// Retorna o número de fases efetivamente executadas.
+static int odd_even_sort_openmp_adaptive(int arr[], int n, int num_threads, omp_sched_t kind, int chunk) {
+    int swapped[2] = {0, 0};
+    int phases_run = n;
+    int num_blocks = phase_num_blocks(n);
+    omp_set_schedule(kind, chunk); // Chunk 0: tamanho padrão do schedule.
+
+    #pragma omp parallel num_threads(num_threads) default(none) shared(arr, n, num_blocks, swapped, phases_run)
+    {
+        COUNTERS_THREAD_BEGIN();
+        for (int phase = 0; phase < n; phase += 2) {
+            int k = (phase / 2) % 2; // Flag usada neste par de fases.
+            int my_swapped = 0;
+            trace_span span = trace_begin_range(phase, 2);
+
+            // Fase Par
+            #pragma omp for schedule(runtime) nowait
+            for (int b = 0; b < num_blocks; b++) {
+                my_swapped |= phase_block_odd_even(arr, n, phase, b);
+            }
+            trace_step(&span, TRACE_COMPUTE);
+            COUNTERS_BARRIER();
+            trace_step(&span, TRACE_WAIT);
+
+            // Zera a flag do próximo par (já lida por todas as threads no par anterior).
+            #pragma omp master
+            swapped[1 - k] = 0;
+
+            // Fase Ímpar (sem barreira implícita: a barreira vem depois da redução).
+            if (phase + 1 < n) {
+                #pragma omp for schedule(runtime) nowait
+                for (int b = 0; b < num_blocks; b++) {
+                    my_swapped |= phase_block_odd_even(arr, n, phase + 1, b);
+                }
+            }
+
+            // Redução do indicador de trocas.
+            if (my_swapped) {
+                #pragma omp atomic write
+                swapped[k] = 1;
+            }
+            trace_step(&span, TRACE_COMPUTE);
+            COUNTERS_BARRIER();
+            trace_step(&span, TRACE_WAIT);
+
+            if (!swapped[k]) {
+                #pragma omp master
+                phases_run = (phase + 2 < n) ? phase + 2 : n;
+                break;
+            }
+        }
+        COUNTERS_THREAD_END();
+    }
+    return phases_run;
+}
+
+// Contador de progresso de uma thread, isolado em sua própria linha de cache
+// para que as leituras dos vizinhos não causem falso compartilhamento.
+typedef struct {
+    int value;
+    char pad[64 - sizeof(int)];
+} padded_counter;
+
+// Espera até que o contador indique que pelo menos 'phase' fases foram concluídas.
+// Faz espera ativa e cede o processador periodicamente caso haja mais threads que núcleos.
+static inline void wait_for_phase(padded_counter *counter, int phase) {
+    int spins = 0;
+    for (;;) {
+        int done;
+        #pragma omp atomic read acquire
+        done = counter->value;
+        if (done >= phase) break;
+        if (++spins >= 1000) {
+            sched_yield();
+            spins = 0;
+        }
+    }
+}
+
+// Versão paralela com OpenMP sincronizada apenas entre VIZINHOS.
+// Cada thread é dona de uma fatia contígua fixa do array e processa os pares cujo
+// elemento esquerdo está na sua fatia. Antes da fase 'p', a thread só espera que
+// as threads vizinhas (esquerda e direita) tenham concluído a fase 'p-1', pois só
+// elas tocam os elementos das bordas da sua fatia. Não há barreira global por fase,
+// e threads distantes podem ficar até algumas fases à frente umas das outras.
+static void odd_even_sort_openmp_neighbor(int arr[], int n, int num_threads) {
+    // Cada fatia precisa de pelo menos dois elementos, para que apenas vizinhas
+    // diretas compartilhem elementos de fronteira.
+    if (num_threads > n / 2) num_threads = n / 2;
+    if (num_threads < 1) num_threads = 1;
+
+    padded_counter *progress = aligned_alloc(64, num_threads * sizeof(padded_counter));
+    for (int t = 0; t < num_threads; t++) {
+        progress[t].value = 0;
+    }
+
+    #pragma omp parallel num_threads(num_threads) default(none) shared(arr, n, progress)
+    {
+        int t = omp_get_thread_num();
+        int nt = omp_get_num_threads(); // O runtime pode criar menos threads que o pedido.
+        int lo = (int)((long long)t * n / nt);
+        int hi = (int)((long long)(t + 1) * n / nt);
+        COUNTERS_THREAD_BEGIN();
+
+        for (int phase = 0; phase < n; phase++) {
+            // Espera apenas as vizinhas terminarem a fase anterior.
+            trace_span span = trace_begin(phase);
+            if (t > 0) COUNTERS_WAIT(wait_for_phase(&progress[t - 1], phase));
+            if (t < nt - 1) COUNTERS_WAIT(wait_for_phase(&progress[t + 1], phase));
+            trace_step(&span, TRACE_WAIT);
+
+            // Pares (j, j+1) da fase com j na fatia da thread.
+            phase_range_odd_even(arr, n, phase, lo, hi);
+            trace_step(&span, TRACE_COMPUTE);
+
+            // Publica a conclusão da fase para as vizinhas.
+            #pragma omp atomic write release
+            progress[t].value = phase + 1;
+        }
+        COUNTERS_THREAD_END();
+    }
+
+    free(progress);
+}
+
+
+// Versão paralela com ladrilhamento temporal (ver tile_utils.h).
+// A cada bloco de tile/2 fases, os trapézios dos tiles são processados em paralelo
+// e, depois de uma barreira, os triângulos das fronteiras. São duas barreiras a cada
+// tile/2 fases, em vez de uma por fase, e cada tile é reutilizado na cache por
+// tile/2 fases antes de a thread seguir para o próximo.
+static void odd_even_sort_openmp_tiled(int arr[], int n, int tile, int num_threads) {
+    int depth = tile / 2;
+    int num_tiles = (n + tile - 1) / tile;
+    #pragma omp parallel num_threads(num_threads) default(none) shared(arr, n, tile, depth, num_tiles)
+    {
+        COUNTERS_THREAD_BEGIN();
+        for (int p0 = 0; p0 < n; p0 += depth) {
+            int d = (n - p0 < depth) ? n - p0 : depth; // O último bloco pode ser menor.
+            trace_span span = trace_begin_range(p0, d);
+
+            // Passo 1: trapézios, independentes entre tiles.
+            #pragma omp for schedule(static) nowait
+            for (int k = 0; k < num_tiles; k++) {
+                int lo = k * tile;
+                int hi = (lo + tile < n) ? lo + tile : n;
+                tile_trapezoid(arr, n, lo, hi, p0, d);
+            }
+            trace_step(&span, TRACE_COMPUTE);
+            COUNTERS_BARRIER();
+            trace_step(&span, TRACE_WAIT);
+
+            // Passo 2: triângulos das fronteiras, que não se sobrepõem.
+            #pragma omp for schedule(static) nowait
+            for (int k = 1; k < num_tiles; k++) {
+                tile_boundary(arr, n, k * tile, p0, d);
+            }
+            trace_step(&span, TRACE_COMPUTE);
+            COUNTERS_BARRIER();
+            trace_step(&span, TRACE_WAIT);
+        }
+        COUNTERS_THREAD_END();
+    }
+}
+
+#endif // _OPENMP
+
+// ------------------------------------------------------------------------------------
+// Pool persistente de pthreads
+// ------------------------------------------------------------------------------------
+
+typedef struct {
+    int *arr;
+    int n;
+    int num_blocks;
+} pool_sort_args;
+
+// Parte da thread 't' de 'nt': uma faixa fixa de blocos de pares em todas as fases, como
+// no schedule(static), com a barreira de espera ativa do pool entre as fases.
+static void pool_sort_task(void *p, int t, int nt) {
+    const pool_sort_args *a = p;
+    int lo = (int)((long long)t * a->num_blocks / nt);
+    int hi = (int)((long long)(t + 1) * a->num_blocks / nt);
+    int sense = 0;
+    COUNTERS_THREAD_BEGIN();
+    for (int phase = 0; phase < a->n; phase++) {
+        trace_span span = trace_begin(phase);
+        for (int b = lo; b < hi; b++) {
+            phase_block_odd_even(a->arr, a->n, phase, b);
+        }
+        trace_step(&span, TRACE_COMPUTE);
+        COUNTERS_WAIT(pool_barrier_wait(&pool.barrier, &sense));
+        trace_step(&span, TRACE_WAIT);
+    }
+    COUNTERS_THREAD_END();
+}
+
+// Versão paralela sobre o pool persistente de pthreads (ver pool_utils.h): sem abertura
+// de região paralela por ordenação e sem threads dormindo entre as fases.
+static void odd_even_sort_pool(int arr[], int n, int num_threads) {
+    pool_sort_args args = {arr, n, phase_num_blocks(n)};
+    // Cada thread precisa de pelo menos um bloco de pares.
+    if (num_threads > args.num_blocks) num_threads = args.num_blocks;
+    pool_run(pool_sort_task, &args, num_threads);
+}
+
+// ------------------------------------------------------------------------------------
+// Backends MPI
+// ------------------------------------------------------------------------------------
+
+#ifdef OETSORT_WITH_MPI
+// Função de comparação de inteiros para o qsort da ordenação local do modo 'blocos'.
+static int compare_int_keys(const void *a, const void *b) {
+    int x = *(const int *)a;
+    int y = *(const int *)b;
+    return (x > y) - (x < y); // Evita o overflow de 'x - y'.
+}
+
+// Verifica, ao fim de cada 'check_every' pares de fases, se algum processo fez trocas
+// no último par. Retorna 1 se a ordenação pode parar. Com 'check_every' igual a 0
+// (parada antecipada desligada) nunca faz a redução.
+static int converged(int swapped, int phase, int check_every, double *comm_time) {
+    if (check_every <= 0 || phase % 2 == 0 || ((phase / 2) + 1) % check_every != 0) {
+        return 0;
+    }
+    int global_swapped;
+    trace_span span = trace_begin(phase);
+    double comm_start = MPI_Wtime();
+    MPI_Allreduce(&swapped, &global_swapped, 1, MPI_INT, MPI_LOR, MPI_COMM_WORLD);
+    *comm_time += (MPI_Wtime() - comm_start);
+    trace_step(&span, TRACE_WAIT);
+    return !global_swapped;
+}
+
+// Reúne em 'counts' o tamanho do bloco de cada processo e retorna o tamanho global, ou
+// -1 se, com mais de um processo, algum bloco está vazio: sem elemento de fronteira, o
+// processo não tem o que trocar com os vizinhos, e todos devolvem OETSORT_ERR_ARG.
+// '*until_converged' indica se o número fixo de fases pode não bastar e a ordenação deve
+// continuar até um par de fases sem mudanças em nenhum processo. O número fixo só basta
+// com todos os blocos do mesmo tamanho: no modo 'blocos' (as 'size' fases do merge-split
+// entre blocos iguais) e, com 'even_blocks', nos modos de fases, desde que esse tamanho
+// seja par. Com blocos ímpares, a paridade local das fases deixa de coincidir com a
+// global, e as 'n' fases podem não bastar (na entrada invertida, por exemplo), mesmo na
+// divisão uniforme.
+static int gather_counts(int n, int size, int even_blocks, int counts[], int *until_converged) {
+    MPI_Allgather(&n, 1, MPI_INT, counts, 1, MPI_INT, MPI_COMM_WORLD);
+    int global_n = 0, empty = 0;
+    *until_converged = 0;
+    for (int i = 0; i < size; i++) {
+        global_n += counts[i];
+        if (counts[i] != counts[0]) *until_converged = 1;
+        if (counts[i] == 0) empty = 1;
+    }
+    if (even_blocks && size > 1 && counts[0] % 2 != 0) *until_converged = 1;
+    return (empty && size > 1) ? -1 : global_n;
+}
+
+// Modo 'fases': executa as 'n' fases globais do algoritmo, trocando apenas
+// um elemento de fronteira com o vizinho a cada fase.
+// Com 'check_every' > 0, a ordenação para quando um par de fases (par + ímpar)
+// termina sem trocas em nenhum processo. A troca é feita pelo motor 'ex'.
+// Retorna o número de fases executadas.
+static int odd_even_sort_mpi_phases(int local_arr[], int local_n, int n, int rank, int size, int check_every,
+                                    exchange_engine *ex, double *comm_time) {
+    int swapped = 0; // Trocas no par de fases atual.
+    for (int phase = 0; phase < n; phase++) {
+        if (phase % 2 == 0) swapped = 0;
+
+        // 1. Ordenação local: cada processo executa uma fase no seu sub-array.
+        trace_span span = trace_begin(phase);
+        swapped |= phase_odd_even(local_arr, local_n, phase);
+        trace_step(&span, TRACE_COMPUTE);
+
+        // 2. Comunicação de fronteiras: troca de elementos com processos vizinhos.
+        // Determina o processo parceiro para a troca nesta fase.
+        int partner = phase_partner(rank, phase);
+
+        // Verifica se o parceiro é válido (dentro dos limites de 0 a size-1).
+        if (partner >= 0 && partner < size) {
+            int send_val;
+            // Determina qual elemento da fronteira enviar.
+            if (rank < partner) {
+                send_val = local_arr[local_n - 1]; // Envia o último elemento.
+            }
+            else {
+                send_val = local_arr[0]; // Envia o primeiro elemento.
+            }
+        
+            // Mede o tempo da operação de comunicação.
+            double comm_start = MPI_Wtime();
+            int recv_val = exchange_value(ex, partner, send_val);
+            *comm_time += (MPI_Wtime() - comm_start);
+            trace_step(&span, TRACE_EXCHANGE);
+
+            // Compara o elemento da fronteira local com o recebido e atualiza se necessário.
+            if (rank < partner) { // Processo de rank menor compara seu último com o primeiro do vizinho.
+                if (send_val > recv_val) {
+                    local_arr[local_n - 1] = recv_val;
+                    swapped = 1;
+                    COUNTERS_ADD_SWAPS(1); // A troca de fronteira é contada só de um lado.
+                }
+            } else { // Processo de rank maior compara seu primeiro com o último do vizinho.
+                if (recv_val > send_val) {
+                    local_arr[0] = recv_val;
+                    swapped = 1;
+                }
+            }
+        }
+
+        // 3. Parada antecipada (se habilitada).
+        if (converged(swapped, phase, check_every, comm_time)) return phase + 1;
+    }
+    return n;
+}
+
+// Modo 'sobreposto': mesmas fases do modo 'fases', mas a troca de fronteira é
+// iniciada (exchange_start) antes da ordenação local. Primeiro é resolvido
+// o único par local que contém o elemento de fronteira; em seguida a mensagem é
+// postada e os pares internos são processados enquanto ela está em trânsito.
+// 'comm_time' acumula apenas o tempo exposto (início + conclusão da troca) e
+// 'overlap_time' o tempo de computação executado com a mensagem em trânsito.
+// A parada antecipada ('check_every') funciona como no modo 'fases'.
+static int odd_even_sort_mpi_overlap(int local_arr[], int local_n, int n, int rank, int size, int check_every,
+                                     exchange_engine *ex, double *comm_time, double *overlap_time) {
+    int swapped = 0; // Trocas no par de fases atual.
+    for (int phase = 0; phase < n; phase++) {
+        if (phase % 2 == 0) swapped = 0;
+        int partner = phase_partner(rank, phase);
+        trace_span span = trace_begin(phase);
+
+        // Sem parceiro nesta fase: apenas a ordenação local.
+        if (partner < 0 || partner >= size) {
+            swapped |= phase_odd_even(local_arr, local_n, phase);
+            trace_step(&span, TRACE_COMPUTE);
+            if (converged(swapped, phase, check_every, comm_time)) return phase + 1;
+            continue;
+        }
+
+        // Índice esquerdo do par que contém o elemento de fronteira
+        // (o último elemento se o parceiro está à direita, o primeiro caso contrário).
+        int b = (rank < partner) ? local_n - 2 : 0;
+
+        // 1. Resolve o par de fronteira para que o valor enviado seja o pós-fase.
+        swapped |= phase_range_odd_even(local_arr, local_n, phase, b, b + 1);
+        int send_val = (rank < partner) ? local_arr[local_n - 1] : local_arr[0];
+        trace_step(&span, TRACE_COMPUTE);
+
+        // 2. Inicia a troca sem esperar pelo parceiro.
+        double comm_start = MPI_Wtime();
+        exchange_start(ex, partner, send_val);
+        double compute_start = MPI_Wtime();
+        *comm_time += (compute_start - comm_start);
+        trace_step(&span, TRACE_EXCHANGE);
+
+        // 3. Processa os pares internos enquanto a mensagem está em trânsito.
+        swapped |= phase_range_odd_even(local_arr, local_n, phase, 0, b);
+        swapped |= phase_range_odd_even(local_arr, local_n, phase, b + 1, local_n);
+        trace_step(&span, TRACE_COMPUTE);
+
+        // 4. Aguarda a troca e finaliza a comparação de fronteira.
+        double wait_start = MPI_Wtime();
+        *overlap_time += (wait_start - compute_start);
+        int recv_val = exchange_finish(ex, partner);
+        *comm_time += (MPI_Wtime() - wait_start);
+        trace_step(&span, TRACE_EXCHANGE);
+
+        if (rank < partner) {
+            if (send_val > recv_val) {
+                local_arr[local_n - 1] = recv_val;
+                swapped = 1;
+                COUNTERS_ADD_SWAPS(1);
+            }
+        } else {
+            if (recv_val > send_val) {
+                local_arr[0] = recv_val;
+                swapped = 1;
+            }
+        }
+
+        if (converged(swapped, phase, check_every, comm_time)) return phase + 1;
+    }
+    return n;
+}
+
+// Mantém em 'local_arr' os 'local_n' menores elementos da união de dois blocos ordenados.
+// 'tmp' deve ter espaço para pelo menos 'local_n' elementos. Retorna 1 se o bloco mudou.
+static int merge_split_low(int local_arr[], int local_n, const int recv_arr[], int recv_n, int tmp[]) {
+    int i = 0, j = 0;
+    for (int k = 0; k < local_n; k++) {
+        if (j >= recv_n || (i < local_n && local_arr[i] <= recv_arr[j])) {
+            tmp[k] = local_arr[i++];
+        } else {
+            tmp[k] = recv_arr[j++];
+        }
+    }
+    int changed = memcmp(local_arr, tmp, local_n * sizeof(int)) != 0;
+    memcpy(local_arr, tmp, local_n * sizeof(int));
+    return changed;
+}
+
+// Mantém em 'local_arr' os 'local_n' maiores elementos da união de dois blocos ordenados.
+// A intercalação é feita do fim para o começo. 'tmp' deve ter espaço para 'local_n' elementos.
+// Retorna 1 se o bloco mudou.
+static int merge_split_high(int local_arr[], int local_n, const int recv_arr[], int recv_n, int tmp[]) {
+    int i = local_n - 1, j = recv_n - 1;
+    for (int k = local_n - 1; k >= 0; k--) {
+        if (j < 0 || (i >= 0 && local_arr[i] > recv_arr[j])) {
+            tmp[k] = local_arr[i--];
+        } else {
+            tmp[k] = recv_arr[j--];
+        }
+    }
+    int changed = memcmp(local_arr, tmp, local_n * sizeof(int)) != 0;
+    memcpy(local_arr, tmp, local_n * sizeof(int));
+    return changed;
+}
+
+// Modo 'blocos': ordena o bloco local uma única vez e depois executa apenas 'size'
+// fases entre processos. Em cada fase os vizinhos trocam seus blocos inteiros e
+// fazem um merge-split: o de rank menor fica com a metade menor e o de rank maior
+// com a metade maior. São O(p) mensagens por processo em vez de O(n).
+// As 'size' fases bastam com blocos iguais (ver gather_counts); com 'until_converged',
+// as fases continuam até um par de fases sem mudanças em nenhum bloco.
+// Retorna o número de fases executadas.
+static int odd_even_sort_mpi_blocks(int local_arr[], int local_n, const int counts[], int rank, int size, int until_converged, double *comm_time) {
+    // Ordenação local inicial do bloco (blocos pequenos pela rede especializada).
+    trace_span span = trace_begin(0);
+    if (!sort_network(local_arr, local_n)) qsort(local_arr, local_n, sizeof(int), compare_int_keys);
+    trace_step(&span, TRACE_LOCAL_SORT);
+
+    // O buffer de recepção comporta o maior bloco (a distribuição é do chamador).
+    int max_n = 0;
+    for (int i = 0; i < size; i++) {
+        if (counts[i] > max_n) max_n = counts[i];
+    }
+    int *recv_arr = (int*)malloc((max_n > 0 ? max_n : 1) * sizeof(int));
+    int *tmp = (int*)malloc((local_n > 0 ? local_n : 1) * sizeof(int));
+
+    int changed = 0; // Mudanças no par de fases atual.
+    int phase;
+    for (phase = 0; phase < size || until_converged; phase++) {
+        if (phase % 2 == 0) changed = 0;
+        int partner = phase_partner(rank, phase);
+        if (partner >= 0 && partner < size) {
+            int recv_n = counts[partner];
+            span = trace_begin(phase);
+            double comm_start = MPI_Wtime();
+            MPI_Sendrecv(local_arr, local_n, MPI_INT, partner, 0,
+                         recv_arr, recv_n, MPI_INT, partner, 0,
+                         MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+            *comm_time += (MPI_Wtime() - comm_start);
+            trace_step(&span, TRACE_EXCHANGE);
+
+            if (rank < partner) {
+                changed |= merge_split_low(local_arr, local_n, recv_arr, recv_n, tmp);
+            } else {
+                changed |= merge_split_high(local_arr, local_n, recv_arr, recv_n, tmp);
+            }
+            trace_step(&span, TRACE_COMPUTE);
+        }
+        // Verificação global a cada par de fases depois das 'size' primeiras.
+        if (until_converged && phase + 1 >= size && converged(changed, phase, 1, comm_time)) {
+            phase++;
+            break;
+        }
+    }
+
+    free(recv_arr);
+    free(tmp);
+    return phase;
+}
+
+#ifdef _OPENMP
+// Troca o elemento de fronteira com o processo parceiro da fase e mantém o menor
+// no processo de rank menor e o maior no de rank maior, como na versão MPI.
+static void exchange_boundary(int local_arr[], int local_n, int rank, int size, int phase, exchange_engine *ex, double *comm_time) {
+    int partner = phase_partner(rank, phase);
+    if (partner < 0 || partner >= size) return;
+
+    int send_val = (rank < partner) ? local_arr[local_n - 1] : local_arr[0];
+
+    double comm_start = MPI_Wtime();
+    int recv_val = exchange_value(ex, partner, send_val);
+    *comm_time += (MPI_Wtime() - comm_start);
+
+    if (rank < partner) {
+        if (send_val > recv_val) {
+            local_arr[local_n - 1] = recv_val;
+            COUNTERS_ADD_SWAPS(1);
+        }
+    } else {
+        if (recv_val > send_val) local_arr[0] = recv_val;
+    }
+}
+
+// Ordenação híbrida: as 'n' fases globais do modo 'fases' do MPI, mas a fase local de
+// cada processo é dividida entre uma equipe de threads OpenMP. A região paralela é
+// aberta uma única vez; a cada fase as threads processam os blocos de pares do
+// sub-array local e, depois da barreira, apenas a thread mestre faz a troca de
+// fronteira com o processo vizinho (MPI_THREAD_FUNNELED).
+static void odd_even_sort_hybrid(int local_arr[], int local_n, int n, int rank, int size, int num_threads,
+                                 exchange_engine *ex, double *comm_time) {
+    int num_blocks = phase_num_blocks(local_n);
+    #pragma omp parallel num_threads(num_threads) default(none) shared(local_arr, local_n, n, rank, size, num_blocks, ex, comm_time)
+    {
+        COUNTERS_THREAD_BEGIN();
+        for (int phase = 0; phase < n; phase++) {
+            trace_span span = trace_begin(phase);
+            // 1. Ordenação local dividida entre as threads do processo.
+            #pragma omp for schedule(static) nowait
+            for (int b = 0; b < num_blocks; b++) {
+                phase_block_odd_even(local_arr, local_n, phase, b);
+            }
+            trace_step(&span, TRACE_COMPUTE);
+            COUNTERS_BARRIER();
+            trace_step(&span, TRACE_WAIT);
+
+            // 2. Comunicação de fronteiras, feita apenas pela thread mestre.
+            #pragma omp master
+            {
+                exchange_boundary(local_arr, local_n, rank, size, phase, ex, comm_time);
+                trace_step(&span, TRACE_EXCHANGE);
+            }
+
+            // As demais threads esperam a fronteira atualizada antes da próxima fase.
+            COUNTERS_BARRIER();
+            trace_step(&span, TRACE_WAIT);
+        }
+        COUNTERS_THREAD_END();
+    }
+}
+#endif // _OPENMP
+#endif // OETSORT_WITH_MPI
+
+// ------------------------------------------------------------------------------------
+// Interface pública
+// ------------------------------------------------------------------------------------
+
+#ifdef _OPENMP
+#define OETSORT_HAS_OPENMP 1
+#else
+#define OETSORT_HAS_OPENMP 0
+#endif
+
+#ifdef OETSORT_WITH_MPI
+#define OETSORT_HAS_MPI 1
+#else
+#define OETSORT_HAS_MPI 0
+#endif
+
+// Nomes dos backends, na ordem de oetsort_backend.
+static const char *backend_names[OETSORT_NUM_BACKENDS] = {
+    "serial", "serial-tiled",
+    "openmp-static", "openmp-dynamic", "openmp-guided", "openmp-neighbor", "openmp-tiled", "pthreads-pool",
+    "mpi-fases", "mpi-sobreposto", "mpi-blocos", "hibrido"
+};
+
+// Nomes dos motores de troca de fronteira, na ordem de oetsort_exchange.
+static const char *exchange_names[OETSORT_NUM_EXCHANGES] = {
+    "sendrecv", "persistente", "rma", "rma-pscw"
+};
+
+// Operações de cada tipo de chave (key_types.h), na ordem de oetsort_key_type.
+static const key_ops *key_ops_table[OETSORT_NUM_KEY_TYPES] = {
+    &key_ops_i32, &key_ops_i64, &key_ops_f32, &key_ops_f64
+};
+
+void oetsort_default_options(oetsort_options *opts) {
+    opts->backend = OETSORT_SERIAL;
+    opts->num_threads = 0;
+    opts->tile = 0;
+    opts->chunk = 0;
+    opts->adaptive = 0;
+    opts->check_every = 1;
+    opts->pack_keys = 0;
+    opts->exchange = OETSORT_EXCHANGE_SENDRECV;
+}
+
+int oetsort_backend_available(oetsort_backend backend) {
+    switch (backend) {
+    case OETSORT_SERIAL:
+    case OETSORT_SERIAL_TILED:
+        return 1;
+    case OETSORT_OPENMP_STATIC:
+    case OETSORT_OPENMP_DYNAMIC:
+    case OETSORT_OPENMP_GUIDED:
+    case OETSORT_OPENMP_NEIGHBOR:
+    case OETSORT_OPENMP_TILED:
+        return OETSORT_HAS_OPENMP;
+    case OETSORT_PTHREAD_POOL:
+        return 1;
+    case OETSORT_MPI_PHASES:
+    case OETSORT_MPI_OVERLAP:
+    case OETSORT_MPI_BLOCKS:
+        return OETSORT_HAS_MPI;
+    case OETSORT_HYBRID:
+        return OETSORT_HAS_MPI && OETSORT_HAS_OPENMP;
+    default:
+        return 0;
+    }
+}
+
+const char *oetsort_backend_name(oetsort_backend backend) {
+    if (backend < 0 || backend >= OETSORT_NUM_BACKENDS) return NULL;
+    return backend_names[backend];
+}
+
+// Valida a combinação de backend e opções comum às duas chamadas de ordenação.
+static int check_options(const oetsort_options *opts) {
+    if (opts->backend < 0 || opts->backend >= OETSORT_NUM_BACKENDS || !oetsort_backend_available(opts->backend)) {
+        return OETSORT_ERR_BACKEND;
+    }
+    int tiled = opts->backend == OETSORT_SERIAL_TILED || opts->backend == OETSORT_OPENMP_TILED;
+    if (tiled && opts->tile < 2) return OETSORT_ERR_ARG;
+    if (opts->num_threads < 0 || opts->chunk < 0) return OETSORT_ERR_ARG;
+    if (opts->exchange < 0 || opts->exchange >= OETSORT_NUM_EXCHANGES) return OETSORT_ERR_ARG;
+    // O modo 'blocos' troca blocos inteiros, de tamanho variável, com MPI_Sendrecv.
+    if (opts->backend == OETSORT_MPI_BLOCKS && opts->exchange != OETSORT_EXCHANGE_SENDRECV) return OETSORT_ERR_ARG;
+    // A parada antecipada só existe nos backends que fazem uma fase por vez com
+    // sincronização global; ver README.
+    if (opts->adaptive) {
+        if (tiled || opts->backend == OETSORT_OPENMP_NEIGHBOR || opts->backend == OETSORT_PTHREAD_POOL || opts->backend == OETSORT_MPI_BLOCKS ||
+            opts->backend == OETSORT_HYBRID || opts->check_every < 1) {
+            return OETSORT_ERR_ARG;
+        }
+    }
+    return OETSORT_OK;
+}
+
+// Maior array ordenado pela rede especializada com um kernel vetorizado: a partir daí o
+// laço de fases, com 8 ou 16 pares por instrução, passa a ganhar da rede escalar. Com o
+// kernel escalar a rede ganha em todos os tamanhos até SORT_NETWORK_MAX.
+#define SORT_NETWORK_SIMD_CUTOFF 32
+
+static int use_sort_network(int n) {
+    int cutoff = (compare_exchange_impl == compare_exchange_scalar) ? SORT_NETWORK_MAX : SORT_NETWORK_SIMD_CUTOFF;
+    return n <= cutoff;
+}
+
+#ifdef _OPENMP
+// Threads a usar: as pedidas nas opções ou o padrão do runtime OpenMP.
+static int resolve_threads(const oetsort_options *opts) {
+    return (opts->num_threads > 0) ? opts->num_threads : omp_get_max_threads();
+}
+#endif
+
+// ------------------------------------------------------------------------------------
+// Chaves compactadas
+// ------------------------------------------------------------------------------------
+
+// Backends com versão para as instâncias uint8 e uint16 de key_types.h (no MPI, com a
+// troca por MPI_Sendrecv da versão por tipo).
+static int packable_backend(const oetsort_options *opts) {
+    if (opts->adaptive) return 0;
+    if (opts->backend == OETSORT_MPI_PHASES) return opts->exchange == OETSORT_EXCHANGE_SENDRECV;
+    return opts->backend == OETSORT_SERIAL || opts->backend == OETSORT_OPENMP_STATIC;
+}
+
+// Threads das passagens de compactação: as do backend OpenMP, ou apenas a chamadora.
+static int packing_threads(const oetsort_options *opts) {
+#ifdef _OPENMP
+    if (opts->backend == OETSORT_OPENMP_STATIC) return resolve_threads(opts);
+#endif
+    return 1;
+}
+
+// Bytes por chave (1 ou 2) com que 'data' pode ser compactado, ou 0 se o intervalo das
+// chaves não cabe em 16 bits. O mínimo, de todos os processos no MPI, vai para 'min_key'.
+static int packed_width(const int data[], int n, const oetsort_options *opts, int *min_key) {
+    int lo = INT_MAX, hi = INT_MIN;
+    int num_threads = packing_threads(opts);
+#ifdef _OPENMP
+    #pragma omp parallel for num_threads(num_threads) if(num_threads > 1) reduction(min:lo) reduction(max:hi)
+#endif
+    for (int i = 0; i < n; i++) {
+        if (data[i] < lo) lo = data[i];
+        if (data[i] > hi) hi = data[i];
+    }
+    long long range = (long long)hi - lo;
+#ifdef OETSORT_WITH_MPI
+    if (opts->backend == OETSORT_MPI_PHASES) {
+        // Mínimo e máximo globais em uma única redução: min(lo) e min(-hi).
+        long long local[2] = {lo, -(long long)hi}, global[2];
+        MPI_Allreduce(local, global, 2, MPI_LONG_LONG, MPI_MIN, MPI_COMM_WORLD);
+        lo = (int)global[0];
+        range = -global[1] - global[0];
+    }
+#endif
+    *min_key = lo;
+    if (range < 0) return 1; // Sem nenhuma chave.
+    if (range <= UINT8_MAX) return 1;
+    if (range <= UINT16_MAX) return 2;
+    return 0;
+}
+
+// Ordena as chaves deslocadas por 'min_key' em um buffer de 'width' bytes por chave e as
+// devolve a 'data'. Retorna OETSORT_OK ou OETSORT_ERR_ARG (bloco MPI vazio).
+static int sort_packed(int data[], int n, int width, int min_key, const oetsort_options *opts, oetsort_stats *st) {
+    const key_ops *ops = (width == 1) ? &key_ops_u8 : &key_ops_u16;
+    void *keys = malloc((size_t)(n > 0 ? n : 1) * width);
+    uint8_t *k8 = keys;
+    uint16_t *k16 = keys;
+    int num_threads = packing_threads(opts);
+    int err = OETSORT_OK;
+#ifdef _OPENMP
+    #pragma omp parallel for num_threads(num_threads) if(num_threads > 1)
+#endif
+    for (int i = 0; i < n; i++) {
+        if (width == 1) k8[i] = (uint8_t)(data[i] - min_key);
+        else k16[i] = (uint16_t)(data[i] - min_key);
+    }
+
+    switch (opts->backend) {
+    case OETSORT_SERIAL:
+        ops->sort_serial(keys, NULL, n);
+        break;
+#ifdef _OPENMP
+    case OETSORT_OPENMP_STATIC:
+        ops->sort_openmp(keys, NULL, n, num_threads);
+        break;
+#endif
+#ifdef OETSORT_WITH_MPI
+    case OETSORT_MPI_PHASES: {
+        int rank, size, until_converged;
+        MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+        MPI_Comm_size(MPI_COMM_WORLD, &size);
+        int *counts = malloc(size * sizeof(int));
+        int global_n = gather_counts(n, size, 1, counts, &until_converged);
+        free(counts);
+        if (global_n < 0) {
+            err = OETSORT_ERR_ARG; // As chaves ficam como estão e voltam intactas a 'data'.
+            break;
+        }
+        trace_set_phases(global_n);
+        st->phases_run = ops->sort_mpi(keys, NULL, n, global_n, rank, size, until_converged, &st->comm_time);
+        break;
+    }
+#endif
+    default:
+        break;
+    }
+
+#ifdef _OPENMP
+    #pragma omp parallel for num_threads(num_threads) if(num_threads > 1)
+#endif
+    for (int i = 0; i < n; i++) {
+        data[i] = min_key + ((width == 1) ? k8[i] : k16[i]);
+    }
+    free(keys);
+    st->packed_bytes = width;
+    return err;
+}
+
+int oetsort_sort(int *data, int n, const oetsort_options *opts, oetsort_stats *stats) {
+    oetsort_options defaults;
+    if (opts == NULL) {
+        oetsort_default_options(&defaults);
+        opts = &defaults;
+    }
+    if (n < 0 || (data == NULL && n > 0)) return OETSORT_ERR_ARG;
+    int err = check_options(opts);
+    if (err != OETSORT_OK) return err;
+
+    oetsort_stats st = {n, 0.0, 0.0};
+    COUNTERS_RESET();
+    double trace_start_time = trace_active ? trace_now() : 0.0;
+    // Arrays pequenos nos backends seriais e OpenMP: a rede especializada do tamanho, na
+    // thread chamadora, sem o custo de controle dos laços nem o de criar a equipe.
+    if (opts->backend < OETSORT_MPI_PHASES && use_sort_network(n)) {
+        COUNTERS_THREAD_BEGIN();
+        sort_network(data, n);
+        COUNTERS_THREAD_END();
+        if (trace_active) trace_record(TRACE_SORT, opts->backend, 0, trace_start_time, trace_now());
+        if (stats != NULL) *stats = st;
+        return OETSORT_OK;
+    }
+    trace_set_phases(n);
+    int min_key, width = (opts->pack_keys && packable_backend(opts)) ? packed_width(data, n, opts, &min_key) : 0;
+    if (width > 0) {
+        // A versão OpenMP por tipo registra os contadores de cada thread.
+        int packed_team = opts->backend == OETSORT_OPENMP_STATIC;
+        if (!packed_team) COUNTERS_THREAD_BEGIN();
+        err = sort_packed(data, n, width, min_key, opts, &st);
+        if (!packed_team) COUNTERS_THREAD_END();
+        if (err != OETSORT_OK) return err;
+        if (opts->backend == OETSORT_MPI_PHASES) COUNTERS_ADD_WAIT(st.comm_time);
+        if (trace_active) trace_record(TRACE_SORT, opts->backend, 0, trace_start_time, trace_now());
+        if (stats != NULL) *stats = st;
+        return OETSORT_OK;
+    }
+    // Nos backends com equipe de threads cada thread registra os seus contadores dentro
+    // da região paralela; nos demais, a thread chamadora registra os do processo.
+    int team = (opts->backend >= OETSORT_OPENMP_STATIC && opts->backend <= OETSORT_PTHREAD_POOL) || opts->backend == OETSORT_HYBRID;
+    if (!team) COUNTERS_THREAD_BEGIN();
+    switch (opts->backend) {
+    case OETSORT_SERIAL:
+        if (opts->adaptive) {
+            st.phases_run = odd_even_sort_serial_adaptive(data, n);
+        } else {
+            odd_even_sort_serial(data, n);
+        }
+        break;
+    case OETSORT_SERIAL_TILED:
+        odd_even_sort_serial_tiled(data, n, opts->tile);
+        break;
+#ifdef _OPENMP
+    case OETSORT_OPENMP_STATIC:
+    case OETSORT_OPENMP_DYNAMIC:
+    case OETSORT_OPENMP_GUIDED: {
+        int num_threads = resolve_threads(opts);
+        omp_sched_t kind = omp_sched_static;
+        if (opts->backend == OETSORT_OPENMP_DYNAMIC) kind = omp_sched_dynamic;
+        else if (opts->backend == OETSORT_OPENMP_GUIDED) kind = omp_sched_guided;
+        if (opts->adaptive) {
+            st.phases_run = odd_even_sort_openmp_adaptive(data, n, num_threads, kind, opts->chunk);
+        } else {
+            odd_even_sort_openmp_scheduled(data, n, num_threads, kind, opts->chunk);
+        }
+        break;
+    }
+    case OETSORT_OPENMP_NEIGHBOR:
+        odd_even_sort_openmp_neighbor(data, n, resolve_threads(opts));
+        break;
+    case OETSORT_OPENMP_TILED:
+        odd_even_sort_openmp_tiled(data, n, opts->tile, resolve_threads(opts));
+        break;
+#endif
+    case OETSORT_PTHREAD_POOL:
+        odd_even_sort_pool(data, n, opts->num_threads > 0 ? opts->num_threads : pool_default_threads());
+        break;
+#ifdef OETSORT_WITH_MPI
+    case OETSORT_MPI_PHASES:
+    case OETSORT_MPI_OVERLAP:
+    case OETSORT_MPI_BLOCKS:
+    case OETSORT_HYBRID: {
+        int rank, size;
+        MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+        MPI_Comm_size(MPI_COMM_WORLD, &size);
+        // Cada processo conhece apenas o seu bloco; o número de fases é o tamanho global.
+        int *counts = malloc(size * sizeof(int));
+        int until_converged;
+        int global_n = gather_counts(n, size, opts->backend != OETSORT_MPI_BLOCKS, counts, &until_converged);
+        if (global_n < 0) {
+            free(counts);
+            err = OETSORT_ERR_ARG;
+            break;
+        }
+        int check_every = opts->adaptive ? opts->check_every : 0;
+        st.phases_run = global_n;
+        trace_set_phases(opts->backend == OETSORT_MPI_BLOCKS ? size : global_n);
+        // Motor de troca de fronteira, criado uma vez para todas as fases; a criação
+        // (coletiva) conta como comunicação.
+        exchange_engine ex;
+        if (opts->backend != OETSORT_MPI_BLOCKS) {
+            double comm_start = MPI_Wtime();
+            exchange_init(&ex, opts->exchange, rank, size);
+            st.comm_time += MPI_Wtime() - comm_start;
+            st.shared_window = ex.shared[EXCHANGE_LEFT] || ex.shared[EXCHANGE_RIGHT];
+        }
+        if (opts->backend == OETSORT_MPI_PHASES) {
+            st.phases_run = odd_even_sort_mpi_phases(data, n, global_n, rank, size, check_every, &ex, &st.comm_time);
+        } else if (opts->backend == OETSORT_MPI_OVERLAP) {
+            st.phases_run = odd_even_sort_mpi_overlap(data, n, global_n, rank, size, check_every, &ex, &st.comm_time, &st.overlap_time);
+        } else if (opts->backend == OETSORT_MPI_BLOCKS) {
+            st.phases_run = odd_even_sort_mpi_blocks(data, n, counts, rank, size, until_converged, &st.comm_time);
+        }
+#ifdef _OPENMP
+        else {
+            odd_even_sort_hybrid(data, n, global_n, rank, size, resolve_threads(opts), &ex, &st.comm_time);
+        }
+#endif
+        if (opts->backend != OETSORT_MPI_BLOCKS) {
+            // Fora dos blocos iguais e pares, uma ordenação que chegou às 'n' fases sem
+            // convergir continua com o motor 'fases' até um par de fases sem trocas em
+            // nenhum processo.
+            if (until_converged && st.phases_run >= global_n) {
+                st.phases_run += odd_even_sort_mpi_phases(data, n, INT_MAX, rank, size, 1, &ex, &st.comm_time);
+            }
+            double comm_start = MPI_Wtime();
+            exchange_free(&ex);
+            st.comm_time += MPI_Wtime() - comm_start;
+        }
+        free(counts);
+        break;
+    }
+#endif
+    default:
+        return OETSORT_ERR_BACKEND;
+    }
+    if (!team) COUNTERS_THREAD_END();
+    if (err != OETSORT_OK) return err;
+    // No MPI, a comunicação do processo (thread 0) conta como espera.
+    if (opts->backend >= OETSORT_MPI_PHASES) COUNTERS_ADD_WAIT(st.comm_time);
+    if (trace_active) trace_record(TRACE_SORT, opts->backend, 0, trace_start_time, trace_now());
+
+    if (stats != NULL) *stats = st;
+    return OETSORT_OK;
+}
+
+int oetsort_counters_enabled(void) {
+#ifdef OETSORT_WITH_COUNTERS
+    return 1;
+#else
+    return 0;
+#endif
+}
+
+int oetsort_last_counters(oetsort_counters out[], int max) {
+#ifdef OETSORT_WITH_COUNTERS
+    int count = 0;
+    for (int t = 0; t < COUNTERS_MAX_THREADS; t++) {
+        if (counters_slots[t].used) count = t + 1;
+    }
+    for (int t = 0; t < count && t < max; t++) {
+        out[t] = counters_slots[t].c;
+    }
+    return count;
+#else
+    (void)out;
+    (void)max;
+    return 0;
+#endif
+}
+
+void oetsort_pool_shutdown(void) {
+    pool_shutdown();
+}
+
+int oetsort_trace_start(int every, int capacity) {
+    if (every < 0 || capacity < 0) return OETSORT_ERR_ARG;
+    trace_start(every, capacity);
+    return OETSORT_OK;
+}
+
+int oetsort_trace_stop(const char *path, int global) {
+    if (path == NULL) return OETSORT_ERR_ARG;
+#ifndef OETSORT_WITH_MPI
+    if (global) return OETSORT_ERR_BACKEND;
+#endif
+    trace_event *events;
+    long long dropped;
+    long long count = trace_collect(&events, &dropped);
+    int *procs = NULL;
+    int num_procs = 1, rank = 0, err = OETSORT_OK;
+
+    if (!global) {
+        procs = calloc((size_t)(count > 0 ? count : 1), sizeof(int));
+    }
+#ifdef OETSORT_WITH_MPI
+    else {
+        // Os eventos de todos os processos vão para o rank 0, que grava o arquivo.
+        MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+        MPI_Comm_size(MPI_COMM_WORLD, &num_procs);
+        int local_bytes = (int)(count * (long long)sizeof(trace_event));
+        int *bytes = NULL, *displs = NULL;
+        long long total_dropped = 0;
+        if (rank == 0) {
+            bytes = malloc(num_procs * sizeof(int));
+            displs = malloc(num_procs * sizeof(int));
+        }
+        MPI_Gather(&local_bytes, 1, MPI_INT, bytes, 1, MPI_INT, 0, MPI_COMM_WORLD);
+        MPI_Reduce(&dropped, &total_dropped, 1, MPI_LONG_LONG, MPI_SUM, 0, MPI_COMM_WORLD);
+        trace_event *all = NULL;
+        if (rank == 0) {
+            long long total = 0;
+            for (int p = 0; p < num_procs; p++) {
+                displs[p] = (int)(total * (long long)sizeof(trace_event));
+                total += bytes[p] / (int)sizeof(trace_event);
+            }
+            all = malloc((size_t)(total > 0 ? total : 1) * sizeof(trace_event));
+            procs = malloc((size_t)(total > 0 ? total : 1) * sizeof(int));
+            for (int p = 0; p < num_procs; p++) {
+                for (int i = 0; i < bytes[p] / (int)sizeof(trace_event); i++) {
+                    procs[displs[p] / (int)sizeof(trace_event) + i] = p;
+                }
+            }
+            count = total;
+            dropped = total_dropped;
+        }
+        MPI_Gatherv(events, local_bytes, MPI_BYTE, all, bytes, displs, MPI_BYTE, 0, MPI_COMM_WORLD);
+        free(events);
+        events = all;
+        free(bytes);
+        free(displs);
+    }
+#endif
+
+    if (rank == 0) {
+        FILE *fp = fopen(path, "w");
+        if (fp == NULL) {
+            err = OETSORT_ERR_IO;
+        } else {
+            trace_write_json(fp, events, procs, count, num_procs, backend_names, dropped);
+            fclose(fp);
+        }
+    }
+#ifdef OETSORT_WITH_MPI
+    // Todos os processos devolvem o mesmo código.
+    if (global) MPI_Bcast(&err, 1, MPI_INT, 0, MPI_COMM_WORLD);
+#endif
+    free(events);
+    free(procs);
+    return err;
+}
+
+int oetsort_sort_keys(void *keys, uint32_t idx[], int n, oetsort_key_type type, const oetsort_options *opts, oetsort_stats *stats) {
+    oetsort_options defaults;
+    if (opts == NULL) {
+        oetsort_default_options(&defaults);
+        opts = &defaults;
+    }
+    if (type < 0 || type >= OETSORT_NUM_KEY_TYPES || n < 0 || (keys == NULL && n > 0)) return OETSORT_ERR_ARG;
+    // Chaves int32 sem registros seguem o caminho int, com todos os backends.
+    if (type == OETSORT_INT32 && idx == NULL) return oetsort_sort((int *)keys, n, opts, stats);
+
+    int err = check_options(opts);
+    if (err != OETSORT_OK) return err;
+    if (opts->adaptive || (opts->backend == OETSORT_MPI_PHASES && opts->exchange != OETSORT_EXCHANGE_SENDRECV)) return OETSORT_ERR_ARG;
+
+    const key_ops *ops = key_ops_table[type];
+    oetsort_stats st = {n, 0.0, 0.0};
+    COUNTERS_RESET();
+    switch (opts->backend) {
+    case OETSORT_SERIAL:
+        ops->sort_serial(keys, idx, n);
+        break;
+#ifdef _OPENMP
+    case OETSORT_OPENMP_STATIC:
+        ops->sort_openmp(keys, idx, n, resolve_threads(opts));
+        break;
+#endif
+#ifdef OETSORT_WITH_MPI
+    case OETSORT_MPI_PHASES: {
+        int rank, size, until_converged;
+        MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+        MPI_Comm_size(MPI_COMM_WORLD, &size);
+        int *counts = malloc(size * sizeof(int));
+        int global_n = gather_counts(n, size, 1, counts, &until_converged);
+        free(counts);
+        if (global_n < 0) return OETSORT_ERR_ARG;
+        st.phases_run = ops->sort_mpi(keys, idx, n, global_n, rank, size, until_converged, &st.comm_time);
+        break;
+    }
+#endif
+    default:
+        return OETSORT_ERR_ARG; // Backend disponível, mas sem versão para tipos genéricos.
+    }
+
+    if (stats != NULL) *stats = st;
+    return OETSORT_OK;
+}
+
+void oetsort_apply_permutation(void *out, const void *in, const uint32_t idx[], int n, size_t payload_bytes) {
+    apply_payload_permutation(out, in, idx, n, payload_bytes);
+}
+
+// ------------------------------------------------------------------------------------
+// Lotes de segmentos independentes
+// ------------------------------------------------------------------------------------
+
+// Maior segmento ordenado pelos kernels de lanes; os maiores são ordenados um a um pelo
+// backend das opções. O buffer transposto de um grupo (SEGMENT_MAX_LANE_LEN linhas de
+// SEGMENT_LANES inteiros, 32 KB) cabe na L1/L2 de cada thread.
+#define SEGMENT_MAX_LANE_LEN 512
+
+// Ordena um grupo de até SEGMENT_LANES segmentos (índices em 'group') com o kernel de
+// lanes: transpõe para 'rows', completa as lanes curtas com INT_MAX (que ficam no fim e
+// não são copiadas de volta), aplica tantas fases quanto o maior segmento e desfaz a
+// transposição.
+static void sort_lane_group(int data[], const int offsets[], const int group[], int count, int rows[]) {
+    int len = 0;
+    for (int l = 0; l < count; l++) {
+        int seg_len = offsets[group[l] + 1] - offsets[group[l]];
+        if (seg_len > len) len = seg_len;
+    }
+    for (int l = 0; l < SEGMENT_LANES; l++) {
+        const int *seg = (l < count) ? data + offsets[group[l]] : NULL;
+        int seg_len = (l < count) ? offsets[group[l] + 1] - offsets[group[l]] : 0;
+        for (int i = 0; i < len; i++) {
+            rows[i * SEGMENT_LANES + l] = (i < seg_len) ? seg[i] : INT_MAX;
+        }
+    }
+    lanes_sort_impl(rows, len);
+    for (int l = 0; l < count; l++) {
+        int *seg = data + offsets[group[l]];
+        int seg_len = offsets[group[l] + 1] - offsets[group[l]];
+        for (int i = 0; i < seg_len; i++) {
+            seg[i] = rows[i * SEGMENT_LANES + l];
+        }
+    }
+}
+
+int oetsort_sort_segments(int *data, const int offsets[], int num_segments, const oetsort_options *opts, oetsort_stats *stats) {
+    oetsort_options defaults;
+    if (opts == NULL) {
+        oetsort_default_options(&defaults);
+        opts = &defaults;
+    }
+    if (num_segments < 0 || (num_segments > 0 && (offsets == NULL || offsets[0] < 0))) return OETSORT_ERR_ARG;
+    for (int s = 0; s < num_segments; s++) {
+        if (offsets[s + 1] < offsets[s]) return OETSORT_ERR_ARG;
+    }
+    if (num_segments > 0 && data == NULL && offsets[num_segments] > 0) return OETSORT_ERR_ARG;
+    int err = check_options(opts);
+    if (err != OETSORT_OK) return err;
+    // Os segmentos são independentes: não há versão distribuída nem parada antecipada.
+    if (opts->adaptive || opts->backend >= OETSORT_MPI_PHASES) return OETSORT_ERR_ARG;
+
+    // Segmentos pequenos em ordem crescente de tamanho (counting sort), para que cada
+    // grupo de lanes reúna segmentos de tamanhos próximos e quase não haja preenchimento.
+    // Segmentos com menos de 2 elementos já estão ordenados.
+    int *counts = calloc(SEGMENT_MAX_LANE_LEN + 2, sizeof(int));
+    int num_small = 0, max_len = 0;
+    for (int s = 0; s < num_segments; s++) {
+        int seg_len = offsets[s + 1] - offsets[s];
+        if (seg_len > max_len) max_len = seg_len;
+        if (seg_len >= 2 && seg_len <= SEGMENT_MAX_LANE_LEN) {
+            counts[seg_len + 1]++;
+            num_small++;
+        }
+    }
+    for (int len = 1; len <= SEGMENT_MAX_LANE_LEN + 1; len++) counts[len] += counts[len - 1];
+    int *small = malloc((num_small > 0 ? num_small : 1) * sizeof(int));
+    for (int s = 0; s < num_segments; s++) {
+        int seg_len = offsets[s + 1] - offsets[s];
+        if (seg_len >= 2 && seg_len <= SEGMENT_MAX_LANE_LEN) small[counts[seg_len]++] = s;
+    }
+    free(counts);
+
+    // Paralelismo entre grupos: cada thread ordena grupos inteiros no seu buffer
+    // transposto. schedule(dynamic) equilibra grupos de tamanhos diferentes.
+    int num_groups = (num_small + SEGMENT_LANES - 1) / SEGMENT_LANES;
+    int num_threads = 1;
+#ifdef _OPENMP
+    if (opts->backend >= OETSORT_OPENMP_STATIC) num_threads = resolve_threads(opts);
+#endif
+    #pragma omp parallel num_threads(num_threads) if(num_threads > 1)
+    {
+        int *rows = malloc(SEGMENT_MAX_LANE_LEN * SEGMENT_LANES * sizeof(int));
+        #pragma omp for schedule(dynamic, 4)
+        for (int g = 0; g < num_groups; g++) {
+            int first = g * SEGMENT_LANES;
+            int count = (num_small - first < SEGMENT_LANES) ? num_small - first : SEGMENT_LANES;
+            sort_lane_group(data, offsets, small + first, count, rows);
+        }
+        free(rows);
+    }
+    free(small);
+
+    // Segmentos grandes: um por vez, com o paralelismo interno do backend. O primeiro
+    // erro do backend interrompe o lote e é devolvido ao chamador.
+    for (int s = 0; s < num_segments; s++) {
+        int seg_len = offsets[s + 1] - offsets[s];
+        if (seg_len <= SEGMENT_MAX_LANE_LEN) continue;
+        err = oetsort_sort(data + offsets[s], seg_len, opts, NULL);
+        if (err != OETSORT_OK) return err;
+    }
+
+    if (stats != NULL) {
+        oetsort_stats st = {max_len, 0.0, 0.0};
+        *stats = st;
+    }
+    return OETSORT_OK;
+}
+
+int oetsort_set_kernel(const char *name) {
+    return set_compare_exchange_kernel(name) ? OETSORT_OK : OETSORT_ERR_KERNEL;
+}
+
+const char *oetsort_kernel_name(void) {
+    return compare_exchange_name;
+}
+
+#ifndef OETSORT_BUILD_ID
+#define OETSORT_BUILD_ID "desconhecido" // Compilada fora do Makefile.
+#endif
+
+const char *oetsort_build_id(void) {
+    return OETSORT_BUILD_ID;
+}
+
+int oetsort_exchange_from_name(const char *name, oetsort_exchange *exchange) {
+    for (int e = 0; e < OETSORT_NUM_EXCHANGES; e++) {
+        if (strcmp(name, exchange_names[e]) == 0) {
+            *exchange = (oetsort_exchange)e;
+            return OETSORT_OK;
+        }
+    }
+    return OETSORT_ERR_ARG;
+}
+
+const char *oetsort_exchange_name(oetsort_exchange exchange) {
+    if (exchange < 0 || exchange >= OETSORT_NUM_EXCHANGES) return NULL;
+    return exchange_names[exchange];
+}
+
+int oetsort_key_type_from_name(const char *name, oetsort_key_type *type) {
+    for (int t = 0; t < OETSORT_NUM_KEY_TYPES; t++) {
+        if (strcmp(key_ops_table[t]->name, name) == 0) {
+            *type = (oetsort_key_type)t;
+            return OETSORT_OK;
+        }
+    }
+    return OETSORT_ERR_ARG;
+}
+
+const char *oetsort_key_type_name(oetsort_key_type type) {
+    if (type < 0 || type >= OETSORT_NUM_KEY_TYPES) return NULL;
+    return key_ops_table[type]->name;
+}
+
+size_t oetsort_key_size(oetsort_key_type type) {
+    if (type < 0 || type >= OETSORT_NUM_KEY_TYPES) return 0;
+    return key_ops_table[type]->size;
+}
+
+int oetsort_keys_sorted(const void *keys, int n, oetsort_key_type type) {
+    return key_ops_table[type]->is_sorted(keys, n);
+}
+
+// ------------------------------------------------------------------------------------
+// Verificação: impressão digital do multiconjunto de chaves e ordem
+// ------------------------------------------------------------------------------------
+
+// Semente fixa dos hashes da impressão digital (não depende da semente da entrada).
+#define FINGERPRINT_SEED 0x6f6574736f7274ULL
+// Elementos por bloco da verificação paralela. Cada bloco é percorrido pelos hashes e
+// logo depois pela verificação da ordem, enquanto ainda está na cache.
+#define VERIFY_CHUNK 65536
+
+// Bits da chave i como inteiro de 64 bits (chaves de 4 bytes ocupam a metade baixa).
+static inline uint64_t key_bits(const unsigned char *keys, int i, size_t key_size) {
+    if (key_size == 4) {
+        uint32_t bits;
+        memcpy(&bits, keys + (size_t)i * 4, 4);
+        return bits;
+    }
+    uint64_t bits;
+    memcpy(&bits, keys + (size_t)i * 8, 8);
+    return bits;
+}
+
+// Percorre as chaves locais em blocos de VERIFY_CHUNK divididos entre as threads. Com
+// 'fp' não nulo, acumula a impressão digital; com 'sorted' não nulo, verifica a ordem
+// (cada bloco inclui o primeiro elemento do seguinte, para cobrir as fronteiras).
+static void verify_local(const void *keys, int n, oetsort_key_type type, int num_threads, oetsort_fingerprint *fp, int *sorted) {
+    const key_ops *ops = key_ops_table[type];
+    const unsigned char *bytes = (const unsigned char *)keys;
+    const size_t key_size = ops->size;
+    const int with_fp = fp != NULL;
+    const int with_order = sorted != NULL;
+    int num_chunks = (n + VERIFY_CHUNK - 1) / VERIFY_CHUNK;
+    uint64_t sum_a = 0, sum_b = 0;
+    int ok = 1;
+#ifdef _OPENMP
+    int threads = (num_threads > 0) ? num_threads : omp_get_max_threads();
+    #pragma omp parallel for num_threads(threads) schedule(static) if(num_chunks > 1) reduction(+:sum_a, sum_b) reduction(&&:ok)
+#else
+    (void)num_threads;
+#endif
+    for (int c = 0; c < num_chunks; c++) {
+        int from = c * VERIFY_CHUNK;
+        int to = (n - from > VERIFY_CHUNK) ? from + VERIFY_CHUNK : n;
+        if (with_fp) {
+            for (int i = from; i < to; i++) {
+                uint64_t bits = key_bits(bytes, i, key_size);
+                sum_a += gen_random(FINGERPRINT_SEED, GEN_STREAM_FINGERPRINT_A, bits);
+                sum_b += gen_random(FINGERPRINT_SEED, GEN_STREAM_FINGERPRINT_B, bits);
+            }
+        }
+        if (with_order) {
+            ok = ok && ops->is_sorted(bytes + (size_t)from * key_size, (to < n ? to + 1 : to) - from);
+        }
+    }
+    if (with_fp) {
+        fp->count = n;
+        fp->sum_a = sum_a;
+        fp->sum_b = sum_b;
+    }
+    if (with_order) *sorted = ok;
+}
+
+#ifdef OETSORT_WITH_MPI
+// Soma as impressões digitais de todos os processos (as somas são em módulo 2^64).
+static void combine_fingerprint(oetsort_fingerprint *fp) {
+    uint64_t values[3] = {(uint64_t)fp->count, fp->sum_a, fp->sum_b};
+    MPI_Allreduce(MPI_IN_PLACE, values, 3, MPI_UINT64_T, MPI_SUM, MPI_COMM_WORLD);
+    fp->count = (long long)values[0];
+    fp->sum_a = values[1];
+    fp->sum_b = values[2];
+}
+
+// Extremos e ordem do bloco de um processo, reunidos na verificação global.
+typedef struct {
+    int has_keys;
+    int sorted;
+    unsigned char first[8];
+    unsigned char last[8];
+} block_bounds;
+
+// Ordem global: todos os blocos ordenados e, ignorando os blocos vazios, a última chave
+// de cada bloco não maior que a primeira do bloco seguinte. Os extremos de todos os
+// processos são reunidos com um único MPI_Allgather (O(p) de memória), de modo que todos
+// chegam ao mesmo resultado sem uma redução adicional.
+static int global_sorted(const void *keys, int n, oetsort_key_type type, int local_sorted) {
+    const key_ops *ops = key_ops_table[type];
+    const size_t key_size = ops->size;
+    int size;
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+    block_bounds mine;
+    memset(&mine, 0, sizeof(mine));
+    mine.has_keys = n > 0;
+    mine.sorted = local_sorted;
+    if (n > 0) {
+        memcpy(mine.first, keys, key_size);
+        memcpy(mine.last, (const unsigned char *)keys + (size_t)(n - 1) * key_size, key_size);
+    }
+    block_bounds *all = malloc((size_t)size * sizeof(block_bounds));
+    MPI_Allgather(&mine, sizeof(block_bounds), MPI_BYTE, all, sizeof(block_bounds), MPI_BYTE, MPI_COMM_WORLD);
+
+    int sorted = 1;
+    const unsigned char *prev_last = NULL;
+    uint64_t pair[2]; // Duas chaves consecutivas, alinhadas para is_sorted.
+    for (int r = 0; r < size; r++) {
+        if (!all[r].has_keys) continue;
+        sorted = sorted && all[r].sorted;
+        if (prev_last != NULL) {
+            memcpy(pair, prev_last, key_size);
+            memcpy((unsigned char *)pair + key_size, all[r].first, key_size);
+            sorted = sorted && ops->is_sorted(pair, 2);
+        }
+        prev_last = all[r].last;
+    }
+    free(all);
+    return sorted;
+}
+#endif
+
+// Argumentos comuns às duas chamadas de verificação.
+static int check_verify_args(const void *keys, int n, oetsort_key_type type, int num_threads, int global) {
+    if (n < 0 || (keys == NULL && n > 0) || type < 0 || type >= OETSORT_NUM_KEY_TYPES || num_threads < 0) {
+        return OETSORT_ERR_ARG;
+    }
+    if (global && !OETSORT_HAS_MPI) return OETSORT_ERR_BACKEND;
+    return OETSORT_OK;
+}
+
+int oetsort_fingerprint_keys(const void *keys, int n, oetsort_key_type type, int num_threads, int global, oetsort_fingerprint *fp) {
+    int err = check_verify_args(keys, n, type, num_threads, global);
+    if (err != OETSORT_OK) return err;
+    verify_local(keys, n, type, num_threads, fp, NULL);
+#ifdef OETSORT_WITH_MPI
+    if (global) combine_fingerprint(fp);
+#endif
+    return OETSORT_OK;
+}
+
+int oetsort_verify(const void *keys, int n, oetsort_key_type type, int num_threads, int global,
+                   const oetsort_fingerprint *expected, oetsort_verification *result) {
+    int err = check_verify_args(keys, n, type, num_threads, global);
+    if (err != OETSORT_OK) return err;
+    oetsort_fingerprint fp;
+    int sorted;
+    verify_local(keys, n, type, num_threads, expected != NULL ? &fp : NULL, &sorted);
+#ifdef OETSORT_WITH_MPI
+    if (global) {
+        if (expected != NULL) combine_fingerprint(&fp);
+        sorted = global_sorted(keys, n, type, sorted);
+    }
+#endif
+    result->sorted = sorted;
+    result->same_keys = expected == NULL ||
+                        (fp.count == expected->count && fp.sum_a == expected->sum_a && fp.sum_b == expected->sum_b);
+    return OETSORT_OK;
+}
+
+// Nomes das distribuições, na ordem de oetsort_distribution.
+static const char *distribution_names[OETSORT_NUM_DISTRIBUTIONS] = {
+    "uniforme", "ordenado", "invertido", "quase-ordenado", "poucos-unicos", "zipf", "tubos-de-orgao"
+};
+
+void oetsort_default_input(oetsort_input *input) {
+    input->dist = OETSORT_DIST_UNIFORM;
+    input->seed = 1;
+    input->max_val = 1000;
+    input->displacements = 0;
+    input->unique = 16;
+    input->zipf_s = 1.0;
+}
+
+int oetsort_distribution_from_name(const char *name, oetsort_distribution *dist) {
+    for (int d = 0; d < OETSORT_NUM_DISTRIBUTIONS; d++) {
+        if (strcmp(name, distribution_names[d]) == 0) {
+            *dist = (oetsort_distribution)d;
+            return OETSORT_OK;
+        }
+    }
+    return OETSORT_ERR_ARG;
+}
+
+const char *oetsort_distribution_name(oetsort_distribution dist) {
+    if (dist < 0 || dist >= OETSORT_NUM_DISTRIBUTIONS) return NULL;
+    return distribution_names[dist];
+}
+
+// Grava 'value' na posição i de um array de chaves do tipo 'type'.
+static inline void store_key(void *keys, int i, oetsort_key_type type, double value) {
+    switch (type) {
+    case OETSORT_INT32: ((int32_t *)keys)[i] = (int32_t)value; break;
+    case OETSORT_INT64: ((int64_t *)keys)[i] = (int64_t)value; break;
+    case OETSORT_FLOAT: ((float *)keys)[i] = (float)value; break;
+    default: ((double *)keys)[i] = value; break;
+    }
+}
+
+int oetsort_generate(void *keys, int n, long long first, long long total, oetsort_key_type type, const oetsort_input *input) {
+    if (n < 0 || first < 0 || first + n > total || type < 0 || type >= OETSORT_NUM_KEY_TYPES ||
+        input->dist < 0 || input->dist >= OETSORT_NUM_DISTRIBUTIONS || input->max_val < 1 ||
+        input->unique < 1 || input->displacements < 0 || !(input->zipf_s > 0.0)) {
+        return OETSORT_ERR_ARG;
+    }
+    const uint64_t seed = input->seed;
+    const uint32_t max_val = (uint32_t)input->max_val;
+    const int fractional = (type == OETSORT_FLOAT || type == OETSORT_DOUBLE);
+    double *zipf_cdf = NULL;
+    if (input->dist == OETSORT_DIST_ZIPF) {
+        zipf_cdf = gen_zipf_table(input->max_val, input->zipf_s);
+        if (zipf_cdf == NULL) return OETSORT_ERR_ARG;
+    }
+
+    // Cada posição é independente das demais: o laço pode ser dividido entre as threads.
+#ifdef _OPENMP
+    #pragma omp parallel for schedule(static)
+#endif
+    for (int i = 0; i < n; i++) {
+        long long g = first + i; // Posição global.
+        uint64_t r = gen_random(seed, GEN_STREAM_VALUE, (uint64_t)g);
+        double value;
+        switch (input->dist) {
+        case OETSORT_DIST_UNIFORM:
+            value = gen_bounded(r, max_val);
+            if (fractional) value += gen_bounded(gen_random(seed, GEN_STREAM_FRACTION, (uint64_t)g), 1000) / 1000.0;
+            break;
+        case OETSORT_DIST_SORTED:
+        case OETSORT_DIST_NEARLY_SORTED:
+            value = (double)((g * (long long)max_val) / total);
+            break;
+        case OETSORT_DIST_REVERSED:
+            value = (double)(((total - 1 - g) * (long long)max_val) / total);
+            break;
+        case OETSORT_DIST_FEW_UNIQUE:
+            value = (double)(((long long)gen_bounded(r, (uint32_t)input->unique) * max_val) / input->unique);
+            break;
+        case OETSORT_DIST_ZIPF:
+            value = gen_zipf_sample(zipf_cdf, input->max_val, gen_unit(r));
+            break;
+        default: { // OETSORT_DIST_ORGAN_PIPE
+            long long half = (total + 1) / 2;
+            long long d = (g < half) ? g : total - 1 - g;
+            value = (double)((d * (long long)max_val) / half);
+            break;
+        }
+        }
+        store_key(keys, i, type, value);
+    }
+
+    // Quase ordenado: as posições deslocadas são sorteadas sobre o array global; cada
+    // fatia aplica apenas as que caem dentro dela.
+    if (input->dist == OETSORT_DIST_NEARLY_SORTED) {
+        long long k = input->displacements > 0 ? input->displacements : (total / 100 > 0 ? total / 100 : 1);
+        for (long long j = 0; j < k; j++) {
+            long long pos = (long long)(gen_random(seed, GEN_STREAM_POSITION, (uint64_t)j) % (uint64_t)total);
+            if (pos >= first && pos < first + n) {
+                store_key(keys, (int)(pos - first), type, gen_bounded(gen_random(seed, GEN_STREAM_DISPLACED, (uint64_t)j), max_val));
+            }
+        }
+    }
+
+    free(zipf_cdf);
+    return OETSORT_OK;
+}
+
+void oetsort_print_keys(const void *keys, int n, oetsort_key_type type) {
+    key_ops_table[type]->print(keys, n);
+}
+
+#ifdef OETSORT_WITH_MPI
+MPI_Datatype oetsort_key_mpi_type(oetsort_key_type type) {
+    return key_ops_table[type]->mpi_type();
+}
+#endif
+
+const char *oetsort_strerror(int err) {
+    switch (err) {
+    case OETSORT_OK: return "sucesso";
+    case OETSORT_ERR_ARG: return "argumento ou combinação de opções inválida";
+    case OETSORT_ERR_BACKEND: return "backend desconhecido ou não disponível nesta biblioteca";
+    case OETSORT_ERR_KERNEL: return "kernel de compare-exchange inválido ou não suportado pela CPU";
+    case OETSORT_ERR_IO: return "falha ao gravar arquivo";
+    default: return "erro desconhecido";
+    }
+}
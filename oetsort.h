@@ -0,0 +1,402 @@
+#ifndef OETSORT_H
+#define OETSORT_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/*
+ * liboetsort: Odd-Even Transposition Sort como biblioteca.
+ *
+ * Todas as versões (serial, OpenMP e MPI) são expostas por uma única chamada,
+ * oetsort_sort(), que ordena um buffer do chamador no próprio lugar; o backend e
+ * seus parâmetros vêm de uma struct oetsort_options. Os executáveis do projeto
+ * são apenas drivers sobre esta interface.
+ *
+ * Backends MPI: cada processo passa o seu bloco local ('data' com 'n' elementos)
+ * e todos os processos de MPI_COMM_WORLD devem fazer a chamada. O resultado é o
+ * array global ordenado na ordem dos ranks. Os blocos podem ter qualquer tamanho não
+ * nulo (partição ponderada); com mais de um processo, um bloco vazio em qualquer
+ * processo dá OETSORT_ERR_ARG em todos. O número fixo de fases (n, ou p no modo blocos) só basta com
+ * todos os blocos do mesmo tamanho, e par fora do modo blocos; nos demais casos,
+ * inclusive na divisão uniforme com resto, a ordenação continua com fases extras até
+ * uma fase par e uma ímpar não mudarem nenhum bloco.
+ * MPI_Init (ou MPI_Init_thread, com MPI_THREAD_FUNNELED no backend híbrido) é
+ * responsabilidade do chamador.
+ *
+ * Os backends OpenMP e MPI só estão disponíveis se a biblioteca foi compilada com
+ * OpenMP e com OETSORT_WITH_MPI, respectivamente (ver oetsort_backend_available()).
+ */
+
+// Códigos de retorno das funções da biblioteca.
+#define OETSORT_OK 0
+#define OETSORT_ERR_ARG -1      // Argumento ou combinação de opções inválida.
+#define OETSORT_ERR_BACKEND -2  // Backend desconhecido ou não compilado nesta biblioteca.
+#define OETSORT_ERR_KERNEL -3   // Kernel de compare-exchange inválido ou não suportado pela CPU.
+#define OETSORT_ERR_IO -4       // Falha ao gravar um arquivo.
+
+typedef enum {
+    OETSORT_SERIAL,          // Fase a fase, em uma thread.
+    OETSORT_SERIAL_TILED,    // Serial com ladrilhamento temporal (opção 'tile').
+    OETSORT_OPENMP_STATIC,   // OpenMP, schedule(static).
+    OETSORT_OPENMP_DYNAMIC,  // OpenMP, schedule(dynamic).
+    OETSORT_OPENMP_GUIDED,   // OpenMP, schedule(guided).
+    OETSORT_OPENMP_NEIGHBOR, // OpenMP com sincronização apenas entre threads vizinhas.
+    OETSORT_OPENMP_TILED,    // OpenMP com ladrilhamento temporal (opção 'tile').
+    OETSORT_PTHREAD_POOL,    // Pool persistente de pthreads com barreira de espera ativa.
+    OETSORT_MPI_PHASES,      // MPI, n fases globais com troca do elemento de fronteira.
+    OETSORT_MPI_OVERLAP,     // MPI, como 'fases', com a troca sobreposta à ordenação local.
+    OETSORT_MPI_BLOCKS,      // MPI, ordenação local + merge-split entre blocos.
+    OETSORT_HYBRID,          // MPI entre processos + OpenMP dentro de cada processo.
+    OETSORT_NUM_BACKENDS
+} oetsort_backend;
+
+// Troca do elemento de fronteira nos backends OETSORT_MPI_PHASES, OETSORT_MPI_OVERLAP e
+// OETSORT_HYBRID (ver exchange_utils.h).
+typedef enum {
+    OETSORT_EXCHANGE_SENDRECV,    // MPI_Sendrecv a cada fase (MPI_Isend/MPI_Irecv no 'sobreposto').
+    OETSORT_EXCHANGE_PERSISTENT,  // Requisições persistentes criadas uma vez e reiniciadas a cada fase.
+    OETSORT_EXCHANGE_RMA,         // Janela compartilhada com vizinhos no mesmo nó; entre nós, como RMA_PSCW.
+    OETSORT_EXCHANGE_RMA_PSCW,    // MPI_Put na janela do vizinho com sincronização PSCW.
+    OETSORT_NUM_EXCHANGES
+} oetsort_exchange;
+
+typedef enum {
+    OETSORT_INT32,
+    OETSORT_INT64,
+    OETSORT_FLOAT,
+    OETSORT_DOUBLE,
+    OETSORT_NUM_KEY_TYPES
+} oetsort_key_type;
+
+// Distribuições das entradas geradas por oetsort_generate().
+typedef enum {
+    OETSORT_DIST_UNIFORM,        // Valores uniformes em [0, max_val).
+    OETSORT_DIST_SORTED,         // Já em ordem crescente (melhor caso).
+    OETSORT_DIST_REVERSED,       // Em ordem decrescente (pior caso: n fases com trocas).
+    OETSORT_DIST_NEARLY_SORTED,  // Crescente com 'displacements' posições sorteadas trocadas por valores uniformes.
+    OETSORT_DIST_FEW_UNIQUE,     // Apenas 'unique' valores distintos.
+    OETSORT_DIST_ZIPF,           // Zipf com expoente 'zipf_s': valores pequenos muito repetidos.
+    OETSORT_DIST_ORGAN_PIPE,     // Crescente até o meio do array e decrescente depois.
+    OETSORT_NUM_DISTRIBUTIONS
+} oetsort_distribution;
+
+typedef struct {
+    oetsort_distribution dist;
+    uint64_t seed;              // A mesma semente gera sempre o mesmo array.
+    int max_val;                // Valores em [0, max_val).
+    long long displacements;    // OETSORT_DIST_NEARLY_SORTED (0 = 1% do tamanho, no mínimo 1).
+    int unique;                 // OETSORT_DIST_FEW_UNIQUE.
+    double zipf_s;              // OETSORT_DIST_ZIPF (> 0).
+} oetsort_input;
+
+// Impressão digital de um multiconjunto de chaves (oetsort_fingerprint_keys): soma, em
+// módulo 2^64, de dois hashes independentes dos bits de cada chave. Não depende da ordem
+// das chaves, então é a mesma antes e depois de uma ordenação correta, e muda (exceto com
+// probabilidade desprezível) se alguma chave for perdida, duplicada ou sobrescrita.
+typedef struct {
+    long long count;  // Número de chaves.
+    uint64_t sum_a;
+    uint64_t sum_b;
+} oetsort_fingerprint;
+
+// Resultado de oetsort_verify().
+typedef struct {
+    int sorted;       // Chaves em ordem crescente (no modo global, também entre os blocos).
+    int same_keys;    // Mesma impressão digital da entrada: o resultado é uma permutação dela.
+} oetsort_verification;
+
+typedef struct {
+    oetsort_backend backend;
+    int num_threads;  // Threads dos backends OpenMP, pool e híbrido (0 = padrão do runtime; no pool, as CPUs do processo).
+    int tile;         // Tamanho do tile dos backends com ladrilhamento (>= 2).
+    int chunk;        // OpenMP static/dynamic/guided: blocos de fase por pedaço (0 = padrão do schedule).
+    int adaptive;     // Parada antecipada quando um par de fases não faz trocas.
+    int check_every;  // Backends MPI adaptativos: verificação global a cada k pares de fases.
+    int pack_keys;    // Compacta as chaves em 8 ou 16 bits quando o intervalo delas cabe (ver oetsort_sort).
+    oetsort_exchange exchange;  // Troca de fronteira dos backends MPI 'fases', 'sobreposto' e híbrido.
+} oetsort_options;
+
+typedef struct {
+    int phases_run;       // Fases executadas (menor que n com parada antecipada).
+    double comm_time;     // Backends MPI: tempo de comunicação exposto deste processo.
+    double overlap_time;  // OETSORT_MPI_OVERLAP: computação feita com mensagens em trânsito.
+    int packed_bytes;     // Bytes por chave no modo de chaves compactadas (0 = não compactou).
+    int shared_window;    // OETSORT_EXCHANGE_RMA: 1 se algum vizinho foi trocado pela janela compartilhada.
+} oetsort_stats;
+
+// Contadores de caminho quente de uma thread (backends OpenMP e híbrido) ou do processo
+// (backends seriais e MPI) em uma ordenação; ver oetsort_last_counters().
+typedef struct {
+    long long swaps;          // Pares trocados nos compare-exchange das fases.
+    double wait_time;         // Espera nas barreiras de fase (ou pelas vizinhas) e, no MPI, na comunicação.
+    long long cycles;         // Eventos de hardware da thread (perf_event_open); -1 se indisponíveis.
+    long long instructions;
+    long long llc_misses;     // Falhas de cache de último nível.
+    long long branch_misses;  // Erros de previsão de desvio.
+} oetsort_counters;
+
+/**
+ * @brief Preenche as opções com os valores padrão (backend serial, sem parada antecipada).
+ */
+void oetsort_default_options(oetsort_options *opts);
+
+/**
+ * @brief Ordena 'data' em ordem crescente com o backend escolhido em 'opts'.
+ *
+ * Nos backends seriais e OpenMP, arrays pequenos (até 32 elementos com os kernels
+ * vetorizados, 64 com o escalar) são ordenados na thread chamadora por uma rede de
+ * ordenação especializada para o tamanho (todas as n fases; com parada antecipada,
+ * phases_run é n).
+ *
+ * Com 'pack_keys', a ordenação procura antes o menor e o maior valor (no MPI, de todos
+ * os processos). Se o intervalo entre eles cabe em 8 ou 16 bits, as chaves deslocadas
+ * pelo mínimo são ordenadas em um buffer de uint8_t ou uint16_t (1/4 ou 1/2 dos bytes
+ * por fase, 4 ou 2 vezes mais pares por instrução vetorial, mensagens MPI de 1 ou 2
+ * bytes) e copiadas de volta; packed_bytes informa a largura usada. Backends
+ * compactados: OETSORT_SERIAL, OETSORT_OPENMP_STATIC e OETSORT_MPI_PHASES, sem parada
+ * antecipada (no MPI, com as fases extras dos blocos de tamanhos diferentes ou
+ * ímpares); nos demais, ou com o intervalo largo demais, a opção é ignorada. A
+ * ordenação compactada não registra eventos por fase no rastro.
+ *
+ * 'exchange' escolhe como os backends MPI 'fases', 'sobreposto' e híbrido trocam o
+ * elemento de fronteira; o motor é criado uma vez por chamada e o seu tempo entra em
+ * comm_time. OETSORT_MPI_BLOCKS aceita apenas OETSORT_EXCHANGE_SENDRECV, e a compactação
+ * das chaves só é feita com ele.
+ *
+ * @param data Buffer do chamador (nos backends MPI, o bloco local do processo).
+ * @param n Número de elementos de 'data'.
+ * @param opts Opções; NULL usa os valores padrão.
+ * @param stats Estatísticas da execução; pode ser NULL.
+ * @return int OETSORT_OK ou um código de erro.
+ */
+int oetsort_sort(int *data, int n, const oetsort_options *opts, oetsort_stats *stats);
+
+/**
+ * @brief Ordena chaves do tipo 'type' e, opcionalmente, registros.
+ *
+ * Com 'idx' não nulo, 'idx[i]' identifica o registro da chave 'keys[i]' e acompanha
+ * a chave durante a ordenação (estável); o payload pode então ser movido de uma só
+ * vez com oetsort_apply_permutation(). Backends suportados: OETSORT_SERIAL,
+ * OETSORT_OPENMP_STATIC e OETSORT_MPI_PHASES, sem parada antecipada e com a troca
+ * OETSORT_EXCHANGE_SENDRECV (chaves int32 sem registros equivalem a oetsort_sort() e
+ * aceitam todos os backends). No MPI, os blocos podem ter qualquer tamanho não nulo,
+ * com as mesmas fases extras de oetsort_sort(); com mais de um processo, um bloco vazio
+ * em qualquer processo dá OETSORT_ERR_ARG em todos.
+ *
+ * @return int OETSORT_OK ou um código de erro.
+ */
+int oetsort_sort_keys(void *keys, uint32_t idx[], int n, oetsort_key_type type, const oetsort_options *opts, oetsort_stats *stats);
+
+/**
+ * @brief Ordena, cada um em ordem crescente, muitos segmentos independentes de um mesmo
+ * buffer (por exemplo, uma linha de uma matriz esparsa ou a lista de um bucket).
+ *
+ * O segmento s é data[offsets[s] .. offsets[s+1]-1], com 'offsets' não decrescente e
+ * de num_segments+1 entradas. Segmentos de até 512 elementos são ordenados em grupos
+ * de 16 com o kernel de compare-exchange selecionado, um segmento por lane, e os
+ * grupos são divididos entre as threads nos backends OpenMP. Segmentos maiores são
+ * ordenados um a um com o paralelismo interno do backend. Backends suportados: seriais
+ * e OpenMP, sem parada antecipada. Em 'stats', phases_run é o tamanho do maior segmento.
+ *
+ * @return int OETSORT_OK ou um código de erro.
+ */
+int oetsort_sort_segments(int *data, const int offsets[], int num_segments, const oetsort_options *opts, oetsort_stats *stats);
+
+/**
+ * @brief Move os payloads para a ordem final em um único passo: out[i] = in[idx[i]].
+ */
+void oetsort_apply_permutation(void *out, const void *in, const uint32_t idx[], int n, size_t payload_bytes);
+
+/**
+ * @brief Seleciona o kernel de compare-exchange: "auto", "avx512", "avx2" ou "escalar".
+ *
+ * @return int OETSORT_OK ou OETSORT_ERR_KERNEL.
+ */
+int oetsort_set_kernel(const char *name);
+
+/**
+ * @brief Nome do kernel de compare-exchange em uso.
+ */
+const char *oetsort_kernel_name(void);
+
+/**
+ * @brief Indica se a biblioteca foi compilada com os contadores de caminho quente
+ * (OETSORT_WITH_COUNTERS, com make CONTADORES=1). Sem eles a instrumentação não gera
+ * nenhum código.
+ */
+int oetsort_counters_enabled(void);
+
+/**
+ * @brief Contadores da última chamada de oetsort_sort() neste processo, um por thread
+ * (a thread t em out[t]; nos backends sem equipe de threads, apenas out[0]). Nos
+ * backends MPI, cada processo obtém os seus.
+ *
+ * @param out Recebe até 'max' contadores.
+ * @param max Capacidade de 'out'.
+ * @return int O número de threads registradas (pode ser maior que 'max'), ou 0 se a
+ * biblioteca foi compilada sem os contadores.
+ */
+int oetsort_last_counters(oetsort_counters out[], int max);
+
+/**
+ * @brief Encerra as threads do pool persistente do backend OETSORT_PTHREAD_POOL. O pool
+ * é criado na primeira ordenação com esse backend e mantido entre as chamadas; depois
+ * desta função, a próxima ordenação o recria. Uma ordenação em curso é aguardada.
+ */
+void oetsort_pool_shutdown(void);
+
+/**
+ * @brief Liga o rastro por fase: as chamadas seguintes de oetsort_sort() registram, em
+ * cada thread, a computação, a espera e a troca de fronteira das fases amostradas,
+ * além de um evento com a ordenação inteira. Descarta um rastro anterior não gravado.
+ *
+ * @param every Registra uma fase a cada 'every' (0 = automático, cerca de mil fases
+ * amostradas por ordenação).
+ * @param capacity Eventos guardados por thread; além disso, os mais antigos são
+ * descartados (0 = padrão, 65536).
+ * @return int OETSORT_OK ou OETSORT_ERR_ARG.
+ */
+int oetsort_trace_start(int every, int capacity);
+
+/**
+ * @brief Desliga o rastro e grava os eventos em 'path' no formato JSON de eventos do
+ * Chrome (chrome://tracing, ui.perfetto.dev), com um processo por rank e uma linha por
+ * thread. Sem 'global', cada processo grava apenas os seus eventos.
+ *
+ * Com 'global' diferente de zero, os eventos de todos os processos de MPI_COMM_WORLD
+ * são reunidos e gravados pelo rank 0; a chamada é coletiva.
+ *
+ * @return int OETSORT_OK, OETSORT_ERR_ARG, OETSORT_ERR_IO ou OETSORT_ERR_BACKEND
+ * ('global' sem MPI).
+ */
+int oetsort_trace_stop(const char *path, int global);
+
+/**
+ * @brief Identificador desta compilação da biblioteca: hash das fontes, das flags e do
+ * compilador, definido pelo Makefile ("desconhecido" se compilada sem ele).
+ */
+const char *oetsort_build_id(void);
+
+/**
+ * @brief Indica se o backend foi compilado nesta biblioteca.
+ */
+int oetsort_backend_available(oetsort_backend backend);
+
+/**
+ * @brief Nome do backend (ex: "openmp-static"), ou NULL se for inválido.
+ */
+const char *oetsort_backend_name(oetsort_backend backend);
+
+/**
+ * @brief Procura um motor de troca de fronteira pelo nome ("sendrecv", "persistente",
+ * "rma" ou "rma-pscw").
+ *
+ * @return int OETSORT_OK ou OETSORT_ERR_ARG.
+ */
+int oetsort_exchange_from_name(const char *name, oetsort_exchange *exchange);
+
+/**
+ * @brief Nome do motor de troca, ou NULL se for inválido.
+ */
+const char *oetsort_exchange_name(oetsort_exchange exchange);
+
+/**
+ * @brief Procura um tipo de chave pelo nome ("int32", "int64", "float" ou "double").
+ *
+ * @return int OETSORT_OK ou OETSORT_ERR_ARG.
+ */
+int oetsort_key_type_from_name(const char *name, oetsort_key_type *type);
+
+/**
+ * @brief Nome do tipo de chave, ou NULL se for inválido.
+ */
+const char *oetsort_key_type_name(oetsort_key_type type);
+
+/**
+ * @brief Tamanho em bytes de uma chave do tipo, ou 0 se for inválido.
+ */
+size_t oetsort_key_size(oetsort_key_type type);
+
+/**
+ * @brief Verifica se as chaves estão em ordem crescente.
+ *
+ * @return int Retorna 1 se estiverem ordenadas, 0 caso contrário.
+ */
+int oetsort_keys_sorted(const void *keys, int n, oetsort_key_type type);
+
+/**
+ * @brief Calcula a impressão digital do multiconjunto de chaves, em paralelo com OpenMP.
+ *
+ * Com 'global' diferente de zero, 'keys' é o bloco local do processo e a impressão
+ * digital é a do array global, combinada com MPI_Allreduce: todos os processos de
+ * MPI_COMM_WORLD devem fazer a chamada e recebem o mesmo resultado.
+ *
+ * @param num_threads Threads OpenMP (0 = padrão do runtime).
+ * @return int OETSORT_OK, OETSORT_ERR_ARG ou OETSORT_ERR_BACKEND ('global' sem MPI).
+ */
+int oetsort_fingerprint_keys(const void *keys, int n, oetsort_key_type type, int num_threads, int global, oetsort_fingerprint *fp);
+
+/**
+ * @brief Verifica um resultado sem ordenação de referência: as chaves devem estar em
+ * ordem crescente e ter a impressão digital 'expected', calculada sobre a entrada antes
+ * da ordenação. As duas verificações são feitas na mesma passada paralela por blocos.
+ *
+ * Com 'global' diferente de zero, 'keys' é o bloco local e a verificação vale para o
+ * array global (blocos na ordem dos ranks, blocos vazios permitidos); é coletiva como
+ * em oetsort_fingerprint_keys(). Com 'expected' NULL, apenas a ordem é verificada.
+ *
+ * @return int OETSORT_OK, OETSORT_ERR_ARG ou OETSORT_ERR_BACKEND ('global' sem MPI).
+ */
+int oetsort_verify(const void *keys, int n, oetsort_key_type type, int num_threads, int global,
+                   const oetsort_fingerprint *expected, oetsort_verification *result);
+
+/**
+ * @brief Preenche a entrada com os valores padrão (uniforme em [0, 1000), semente 1).
+ */
+void oetsort_default_input(oetsort_input *input);
+
+/**
+ * @brief Gera a fatia [first, first + n) de um array de 'total' chaves do tipo 'type'
+ * com a distribuição e a semente de 'input'.
+ *
+ * O valor de cada posição depende apenas da semente e da posição global, de modo que
+ * o array global é o mesmo qualquer que seja a divisão em fatias (um processo MPI gera
+ * só o seu bloco) ou o número de threads (a geração é paralela com OpenMP). Nas chaves
+ * float e double, a distribuição uniforme inclui uma parte fracionária.
+ *
+ * @return int OETSORT_OK ou OETSORT_ERR_ARG.
+ */
+int oetsort_generate(void *keys, int n, long long first, long long total, oetsort_key_type type, const oetsort_input *input);
+
+/**
+ * @brief Procura uma distribuição pelo nome ("uniforme", "ordenado", "invertido",
+ * "quase-ordenado", "poucos-unicos", "zipf" ou "tubos-de-orgao").
+ *
+ * @return int OETSORT_OK ou OETSORT_ERR_ARG.
+ */
+int oetsort_distribution_from_name(const char *name, oetsort_distribution *dist);
+
+/**
+ * @brief Nome da distribuição, ou NULL se for inválida.
+ */
+const char *oetsort_distribution_name(oetsort_distribution dist);
+
+/**
+ * @brief Imprime as chaves do tipo em uma linha.
+ */
+void oetsort_print_keys(const void *keys, int n, oetsort_key_type type);
+
+#ifdef MPI_VERSION
+/**
+ * @brief Datatype MPI das chaves do tipo (disponível quando mpi.h é incluído antes
+ * deste arquivo e a biblioteca foi compilada com OETSORT_WITH_MPI).
+ */
+MPI_Datatype oetsort_key_mpi_type(oetsort_key_type type);
+#endif
+
+/**
+ * @brief Descrição de um código de erro.
+ */
+const char *oetsort_strerror(int err);
+
+#endif // OETSORT_H
@@ -0,0 +1,262 @@
+#ifndef PARTITION_UTILS_H
+#define PARTITION_UTILS_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <mpi.h>
+#include "csv_utils.h"
+#include "oetsort.h"
+
+/*
+ * Partição ponderada do array entre os processos MPI (--particao e --pesos).
+ *
+ * Nos modos 'fases' e 'sobreposto' os processos andam em passo com os vizinhos, então
+ * cada fase dura o que dura a fase do processo mais lento: em nós heterogêneos, ou com
+ * processos disputando núcleos (run_experiments.sh --oversubscribe), os demais passam o
+ * resto da fase esperando na troca de fronteira. Com pesos, cada processo recebe um
+ * bloco proporcional ao seu peso, para que todos levem o mesmo tempo por fase:
+ *   - calibrada: cada processo mede, ao mesmo tempo que os demais, a sua vazão de fases
+ *     (mediana de PARTITION_CALIB_REPS ordenações seriais de PARTITION_CALIB_N elementos
+ *     com o kernel em uso), e o peso é essa vazão. A mediana, e não o mínimo, para que
+ *     um processo que divide o núcleo com outros não seja medido pela sua melhor fatia
+ *     de tempo;
+ *   - pesos: os pesos vêm de um arquivo texto, um número positivo por linha na ordem dos
+ *     ranks (linhas vazias e iniciadas por '#' são ignoradas).
+ * Todo processo recebe ao menos um elemento. Com blocos de tamanhos diferentes, a
+ * biblioteca completa a ordenação com fases extras até convergir (ver oetsort_sort).
+ *
+ * O relatório da execução mostra, por processo, o bloco, o peso, o tempo de computação
+ * e o de comunicação (que inclui a espera pelos vizinhos), e o desbalanceamento
+ * (maior tempo de computação / média). Com pesos, mostra também o desbalanceamento
+ * previsto para a partição uniforme e para a ponderada (tamanho do bloco / peso).
+ * --salvar-pesos grava os pesos medidos na execução (elementos por segundo de
+ * computação de cada processo), para reequilibrar a próxima execução com --pesos.
+ */
+
+#define PARTITION_CALIB_N 4096
+#define PARTITION_CALIB_REPS 5
+
+// Partição do array entre os processos e o que reportar sobre ela.
+typedef struct {
+    const char *name;       // "uniforme", "calibrada" ou "pesos".
+    double *weights;        // Peso de cada processo; NULL na partição uniforme.
+    int *counts;            // Elementos de cada processo.
+    int *displs;            // Primeiro índice global do bloco de cada processo.
+    int report;             // Imprime e grava o relatório de desbalanceamento.
+    const char *save_path;  // Arquivo para os pesos medidos, ou NULL.
+} partition_plan;
+
+/**
+ * @brief Lê um peso positivo por processo de um arquivo texto.
+ *
+ * @return int 1 se o arquivo tem exatamente 'size' pesos válidos, 0 caso contrário.
+ */
+static inline int partition_read_weights(const char *path, double weights[], int size) {
+    FILE *fp = fopen(path, "r");
+    if (fp == NULL) return 0;
+    char line[256];
+    int count = 0, ok = 1;
+    while (fgets(line, sizeof(line), fp) != NULL) {
+        char *p = line + strspn(line, " \t");
+        if (*p == '#' || *p == '\n' || *p == '\0') continue;
+        double w;
+        if (count >= size || sscanf(p, "%lf", &w) != 1 || !(w > 0.0)) {
+            ok = 0;
+            break;
+        }
+        weights[count++] = w;
+    }
+    fclose(fp);
+    return ok && count == size;
+}
+
+static inline int partition_compare_doubles(const void *a, const void *b) {
+    double x = *(const double *)a;
+    double y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Mede a vazão de fases de cada processo; todos recebem os pesos de todos.
+ *
+ * Os processos medem ao mesmo tempo, para que os que dividem núcleos se vejam mais
+ * lentos como na ordenação.
+ */
+static inline void partition_calibrate(double weights[], const oetsort_input *input) {
+    int *arr = malloc(PARTITION_CALIB_N * sizeof(int));
+    oetsort_options opts;
+    oetsort_default_options(&opts);
+    double times[PARTITION_CALIB_REPS];
+    for (int r = 0; r < PARTITION_CALIB_REPS; r++) {
+        oetsort_generate(arr, PARTITION_CALIB_N, 0, PARTITION_CALIB_N, OETSORT_INT32, input);
+        MPI_Barrier(MPI_COMM_WORLD);
+        double start = MPI_Wtime();
+        oetsort_sort(arr, PARTITION_CALIB_N, &opts, NULL);
+        times[r] = MPI_Wtime() - start;
+    }
+    free(arr);
+    qsort(times, PARTITION_CALIB_REPS, sizeof(double), partition_compare_doubles);
+    double median = times[PARTITION_CALIB_REPS / 2];
+    // Elementos por fase vezes fases, por segundo.
+    double rate = (double)PARTITION_CALIB_N * PARTITION_CALIB_N / (median > 0.0 ? median : 1e-9);
+    MPI_Allgather(&rate, 1, MPI_DOUBLE, weights, 1, MPI_DOUBLE, MPI_COMM_WORLD);
+}
+
+/**
+ * @brief Divide 'n' elementos (n >= size) em blocos proporcionais aos pesos, com ao menos
+ * um elemento por processo e o resto distribuído pelo maior resíduo. Com 'weights' NULL,
+ * é a partição uniforme (os n % size primeiros processos com um elemento a mais).
+ */
+static inline void partition_counts(int n, const double weights[], int size, int counts[], int displs[]) {
+    if (weights == NULL) {
+        for (int i = 0; i < size; i++) {
+            counts[i] = n / size + (i < n % size);
+        }
+    } else {
+        double total = 0.0;
+        for (int i = 0; i < size; i++) total += weights[i];
+        double *residue = malloc(size * sizeof(double));
+        int rest = n - size, assigned = 0;
+        for (int i = 0; i < size; i++) {
+            double share = rest * (weights[i] / total);
+            counts[i] = 1 + (int)share;
+            residue[i] = share - (int)share;
+            assigned += (int)share;
+        }
+        for (; assigned < rest; assigned++) {
+            int best = 0;
+            for (int i = 1; i < size; i++) {
+                if (residue[i] > residue[best]) best = i;
+            }
+            counts[best]++;
+            residue[best] = -1.0;
+        }
+        free(residue);
+    }
+    displs[0] = 0;
+    for (int i = 1; i < size; i++) displs[i] = displs[i - 1] + counts[i - 1];
+}
+
+// Libera o plano; os ponteiros ficam nulos, então liberar de novo não faz nada.
+static inline void partition_plan_free(partition_plan *plan) {
+    free(plan->weights);
+    free(plan->counts);
+    free(plan->displs);
+    plan->weights = NULL;
+    plan->counts = NULL;
+    plan->displs = NULL;
+}
+
+/**
+ * @brief Monta a partição de 'n' elementos em todos os processos: uniforme, calibrada
+ * ou com os pesos de 'weights_path' (lidos no rank 0 e difundidos).
+ *
+ * @param name Valor de --particao ("uniforme" ou "calibrada"), ou NULL.
+ * @param save_path Valor de --salvar-pesos, ou NULL.
+ * @return int 1 em caso de sucesso, 0 se o arquivo de pesos for inválido (em todos os
+ * processos; o plano já vem liberado).
+ */
+static inline int partition_plan_init(partition_plan *plan, const char *name, const char *weights_path, const char *save_path,
+                                      int n, const oetsort_input *input, int rank, int size) {
+    // Sem nenhuma das opções, a partição uniforme de sempre, sem relatório.
+    plan->report = name != NULL || weights_path != NULL || save_path != NULL;
+    plan->save_path = save_path;
+    plan->name = (weights_path != NULL) ? "pesos" : (name != NULL ? name : "uniforme");
+    plan->weights = NULL;
+    plan->counts = malloc(size * sizeof(int));
+    plan->displs = malloc(size * sizeof(int));
+    if (weights_path != NULL) {
+        plan->weights = malloc(size * sizeof(double));
+        int ok = (rank == 0) ? partition_read_weights(weights_path, plan->weights, size) : 0;
+        MPI_Bcast(&ok, 1, MPI_INT, 0, MPI_COMM_WORLD);
+        if (!ok) {
+            partition_plan_free(plan);
+            return 0;
+        }
+        MPI_Bcast(plan->weights, size, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+    } else if (strcmp(plan->name, "calibrada") == 0) {
+        plan->weights = malloc(size * sizeof(double));
+        partition_calibrate(plan->weights, input);
+    }
+    partition_counts(n, plan->weights, size, plan->counts, plan->displs);
+    return 1;
+}
+
+/**
+ * @brief Desbalanceamento previsto de uma partição: maior tempo por fase (bloco / peso)
+ * dividido pela média. 1 é o equilíbrio perfeito.
+ */
+static inline double partition_predicted_imbalance(const int counts[], const double weights[], int size) {
+    double max = 0.0, sum = 0.0;
+    for (int i = 0; i < size; i++) {
+        double t = counts[i] / weights[i];
+        if (t > max) max = t;
+        sum += t;
+    }
+    return (sum > 0.0) ? max / (sum / size) : 1.0;
+}
+
+/**
+ * @brief Reúne os tempos de cada processo no rank 0, imprime o relatório da partição e o
+ * anexa a 'mpi_particao.csv'; grava os pesos medidos em plan->save_path, se não for NULL.
+ * Chamada por todos os processos.
+ */
+static inline void partition_report(const partition_plan *plan, const char *mode, int n, double computation_time, double comm_time,
+                                    double t_parallel, const oetsort_input *input, int rank, int size) {
+    const char *partition = plan->name;
+    const int *counts = plan->counts;
+    const double *weights = plan->weights;
+    double local[2] = {computation_time, comm_time};
+    double *times = (rank == 0) ? malloc(2 * size * sizeof(double)) : NULL;
+    MPI_Gather(local, 2, MPI_DOUBLE, times, 2, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+    if (rank != 0) return;
+
+    double max_comp = 0.0, sum_comp = 0.0, max_comm = 0.0, sum_comm = 0.0;
+    printf("--- Partição (%s) ---\n", partition);
+    printf("Processo  Elementos  Peso          Computação(s)  Comunicação(s)\n");
+    for (int i = 0; i < size; i++) {
+        double comp = times[2 * i], comm = times[2 * i + 1];
+        printf("%-9d %-10d %-13.4g %-14.6f %.6f\n", i, counts[i], weights != NULL ? weights[i] : 1.0, comp, comm);
+        if (comp > max_comp) max_comp = comp;
+        if (comm > max_comm) max_comm = comm;
+        sum_comp += comp;
+        sum_comm += comm;
+    }
+    double measured = (sum_comp > 0.0) ? max_comp / (sum_comp / size) : 1.0;
+    double uniform_predicted = 0.0, predicted = 0.0;
+    if (weights != NULL) {
+        int *uniform = malloc(size * sizeof(int));
+        int *displs = malloc(size * sizeof(int));
+        partition_counts(n, NULL, size, uniform, displs);
+        uniform_predicted = partition_predicted_imbalance(uniform, weights, size);
+        predicted = partition_predicted_imbalance(counts, weights, size);
+        printf("Desbalanceamento previsto (uniforme): %.4f\n", uniform_predicted);
+        printf("Desbalanceamento previsto (%s): %.4f\n", partition, predicted);
+        free(uniform);
+        free(displs);
+    }
+    printf("Desbalanceamento medido (computação máx/média): %.4f\n", measured);
+    printf("Comunicação e espera: máx %.6f s, soma %.6f s\n\n", max_comm, sum_comm);
+    save_partition_result(results_path("mpi_particao.csv", input), n, size, mode, partition, uniform_predicted, predicted,
+                          measured, t_parallel, max_comm, sum_comm);
+
+    if (plan->save_path != NULL) {
+        ensure_dir_exists(plan->save_path);
+        FILE *fp = fopen(plan->save_path, "w");
+        if (fp == NULL) {
+            perror("Falha ao gravar os pesos");
+        } else {
+            fprintf(fp, "# Pesos medidos: elementos por segundo de computação de cada processo (partição %s, n=%d).\n", partition, n);
+            for (int i = 0; i < size; i++) {
+                double comp = times[2 * i];
+                fprintf(fp, "%.6g\n", comp > 0.0 ? counts[i] / comp : 1.0);
+            }
+            fclose(fp);
+            printf("Pesos medidos salvos em '%s'.\n\n", plan->save_path);
+        }
+    }
+    free(times);
+}
+
+#endif // PARTITION_UTILS_H
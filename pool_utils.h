@@ -0,0 +1,251 @@
+#ifndef POOL_UTILS_H
+#define POOL_UTILS_H
+
+// Requer _GNU_SOURCE definido antes dos includes (pthread_setaffinity_np, CPU_SET).
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+/*
+ * Pool persistente de pthreads do backend OETSORT_PTHREAD_POOL.
+ *
+ * Os backends OpenMP abrem uma região paralela a cada ordenação e sincronizam as 'n'
+ * fases na barreira genérica do runtime, que pode pôr as threads para dormir e
+ * acordá-las a cada fase. Aqui as threads são criadas uma única vez (na primeira
+ * ordenação que pede aquele número de threads), fixadas cada uma em uma CPU do processo
+ * e reaproveitadas por todas as ordenações seguintes; a thread chamadora participa
+ * como a thread 0. As fases são sincronizadas por uma barreira centralizada com
+ * inversão de sentido, em espera ativa: o contador e o sentido ficam em linhas de cache
+ * separadas, cada thread chega com um único decremento atômico e espera lendo apenas o
+ * sentido, que a última a chegar inverte. A espera cede o processador a cada
+ * POOL_SPIN_LIMIT voltas; com mais threads na tarefa que CPUs no processo, a cada volta,
+ * pois a thread esperada pode estar fora do processador.
+ *
+ * Entre ordenações, as threads do pool esperam a próxima tarefa em espera ativa por
+ * POOL_IDLE_SPINS voltas (ordenações seguidas não pagam o custo de acordá-las) e depois
+ * dormem em uma variável de condição. As tarefas são serializadas: chamadas simultâneas
+ * de threads diferentes esperam a vez.
+ */
+
+#define POOL_MAX_THREADS 256
+#define POOL_SPIN_LIMIT 1000     // Voltas de espera antes de ceder o processador.
+#define POOL_IDLE_SPINS 200000   // Voltas de espera por uma tarefa antes de dormir.
+#define POOL_JOB_SHIFT 16
+
+// Tarefa executada por cada thread 't' de 'nt'.
+typedef void (*pool_task)(void *arg, int t, int nt);
+
+typedef struct {
+    atomic_int count __attribute__((aligned(64)));  // Threads que ainda não chegaram.
+    atomic_int sense __attribute__((aligned(64)));  // Invertido a cada passagem.
+    int total __attribute__((aligned(64)));
+    int spin_limit;  // Voltas de espera antes de ceder o processador.
+} pool_barrier;
+
+typedef struct {
+    pthread_t threads[POOL_MAX_THREADS];  // threads[t] para t >= 1 (a 0 é a chamadora).
+    int num_threads;                      // Tamanho do pool, contando a chamadora.
+    pthread_mutex_t run_lock;             // Serializa as tarefas.
+    pthread_mutex_t lock;                 // Protege o sono das threads ociosas.
+    pthread_cond_t wake;
+    // Tarefa em curso: número de sequência << POOL_JOB_SHIFT | número de threads (0 =
+    // encerrar). As threads que não participam de uma tarefa podem se atrasar; com o
+    // número de threads na mesma palavra, elas nunca o leem de uma tarefa mais nova.
+    atomic_uint job __attribute__((aligned(64)));
+    atomic_int finished __attribute__((aligned(64)));  // Threads que terminaram a tarefa.
+    pool_task task;
+    void *arg;
+    pool_barrier barrier;
+} pool_state;
+
+static pool_state pool = {
+    .run_lock = PTHREAD_MUTEX_INITIALIZER,
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+    .wake = PTHREAD_COND_INITIALIZER,
+    .num_threads = 1,
+};
+
+// Índice da thread no pool durante uma tarefa (-1 fora dele).
+static __thread int pool_self = -1;
+
+/**
+ * @brief Índice da thread chamadora na equipe em execução: o do pool nas tarefas do
+ * pool, o do OpenMP nas demais (0 fora de regiões paralelas).
+ */
+static inline int pool_thread_num(void) {
+    if (pool_self >= 0) return pool_self;
+#ifdef _OPENMP
+    return omp_get_thread_num();
+#else
+    return 0;
+#endif
+}
+
+static inline void pool_pause(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#endif
+}
+
+/**
+ * @brief Espera todas as threads da tarefa chegarem à barreira.
+ *
+ * @param local_sense Sentido da thread chamadora, começando em 0 a cada tarefa.
+ */
+static inline void pool_barrier_wait(pool_barrier *b, int *local_sense) {
+    int sense = !*local_sense;
+    *local_sense = sense;
+    if (atomic_fetch_sub_explicit(&b->count, 1, memory_order_acq_rel) == 1) {
+        // Última a chegar: prepara a próxima passagem antes de liberar as demais.
+        atomic_store_explicit(&b->count, b->total, memory_order_relaxed);
+        atomic_store_explicit(&b->sense, sense, memory_order_release);
+        return;
+    }
+    int spins = 0;
+    while (atomic_load_explicit(&b->sense, memory_order_acquire) != sense) {
+        pool_pause();
+        if (++spins >= b->spin_limit) {
+            sched_yield();
+            spins = 0;
+        }
+    }
+}
+
+// Laço de cada thread do pool: espera uma nova tarefa, executa a sua parte e avisa.
+// 'p' traz o índice da thread e a última tarefa publicada antes da sua criação.
+static void *pool_worker(void *p) {
+    int t = (int)((uintptr_t)p & 0xffff);
+    unsigned seen = (unsigned)((uintptr_t)p >> 16);
+    for (;;) {
+        unsigned job;
+        int spins = 0;
+        while ((job = atomic_load_explicit(&pool.job, memory_order_acquire)) == seen) {
+            if (++spins < POOL_IDLE_SPINS) {
+                pool_pause();
+                if (spins % POOL_SPIN_LIMIT == 0) sched_yield();
+                continue;
+            }
+            pthread_mutex_lock(&pool.lock);
+            while (atomic_load_explicit(&pool.job, memory_order_acquire) == seen) {
+                pthread_cond_wait(&pool.wake, &pool.lock);
+            }
+            pthread_mutex_unlock(&pool.lock);
+        }
+        seen = job;
+        int nt = (int)(job & ((1u << POOL_JOB_SHIFT) - 1));
+        if (nt == 0) return NULL;
+        if (t < nt) {
+            pool_self = t;
+            pool.task(pool.arg, t, nt);
+            pool_self = -1;
+            atomic_fetch_add_explicit(&pool.finished, 1, memory_order_release);
+        }
+    }
+}
+
+/**
+ * @brief Número de CPUs do conjunto de afinidade do processo (o tamanho padrão do pool).
+ */
+static inline int pool_default_threads(void) {
+    cpu_set_t allowed;
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) return 1;
+    int count = CPU_COUNT(&allowed);
+    return (count > 0) ? count : 1;
+}
+
+// Publica uma tarefa para 'nt' threads (0 = encerrar) e acorda as que dormem.
+static inline void pool_publish(int nt) {
+    unsigned seq = (atomic_load_explicit(&pool.job, memory_order_relaxed) >> POOL_JOB_SHIFT) + 1;
+    pthread_mutex_lock(&pool.lock);
+    atomic_store_explicit(&pool.job, (seq << POOL_JOB_SHIFT) | (unsigned)nt, memory_order_release);
+    pthread_cond_broadcast(&pool.wake);
+    pthread_mutex_unlock(&pool.lock);
+}
+
+/**
+ * @brief Cria as threads que faltam para um pool de 'nt' threads, fixando a thread 't'
+ * na CPU (t mod CPUs) do conjunto de afinidade do processo.
+ *
+ * @return int O tamanho do pool (menor que 'nt' se não for possível criar threads).
+ */
+static inline int pool_grow(int nt) {
+    if (nt > POOL_MAX_THREADS) nt = POOL_MAX_THREADS;
+    cpu_set_t allowed;
+    int cpus[CPU_SETSIZE], num_cpus = 0;
+    if (nt > pool.num_threads && sched_getaffinity(0, sizeof(allowed), &allowed) == 0) {
+        for (int c = 0; c < CPU_SETSIZE; c++) {
+            if (CPU_ISSET(c, &allowed)) cpus[num_cpus++] = c;
+        }
+    }
+    uintptr_t last_job = atomic_load_explicit(&pool.job, memory_order_relaxed);
+    for (int t = pool.num_threads; t < nt; t++) {
+        pthread_attr_t attr;
+        pthread_attr_init(&attr);
+        if (num_cpus > 0) {
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            CPU_SET(cpus[t % num_cpus], &set);
+            pthread_attr_setaffinity_np(&attr, sizeof(set), &set);
+        }
+        int err = pthread_create(&pool.threads[t], &attr, pool_worker, (void *)((last_job << 16) | (uintptr_t)t));
+        pthread_attr_destroy(&attr);
+        if (err != 0) break;
+        pool.num_threads = t + 1;
+    }
+    return (nt < pool.num_threads) ? nt : pool.num_threads;
+}
+
+/**
+ * @brief Executa 'task' em 'nt' threads do pool (a chamadora é a thread 0) e retorna
+ * quando todas terminam.
+ */
+static inline void pool_run(pool_task task, void *arg, int nt) {
+    pthread_mutex_lock(&pool.run_lock);
+    nt = pool_grow(nt < 1 ? 1 : nt);
+    pool.task = task;
+    pool.arg = arg;
+    pool.barrier.total = nt;
+    pool.barrier.spin_limit = (nt > pool_default_threads()) ? 1 : POOL_SPIN_LIMIT;
+    atomic_store_explicit(&pool.barrier.count, nt, memory_order_relaxed);
+    atomic_store_explicit(&pool.barrier.sense, 0, memory_order_relaxed);
+    atomic_store_explicit(&pool.finished, 0, memory_order_relaxed);
+    if (nt > 1) pool_publish(nt);
+
+    int saved = pool_self;
+    pool_self = 0;
+    task(arg, 0, nt);
+    pool_self = saved;
+
+    // As demais threads só avisam depois de sair da última barreira da tarefa, então o
+    // estado da barreira pode ser reiniciado pela próxima.
+    int spins = 0;
+    while (atomic_load_explicit(&pool.finished, memory_order_acquire) < nt - 1) {
+        pool_pause();
+        if (++spins >= pool.barrier.spin_limit) {
+            sched_yield();
+            spins = 0;
+        }
+    }
+    pthread_mutex_unlock(&pool.run_lock);
+}
+
+/**
+ * @brief Encerra e aguarda todas as threads do pool; a próxima tarefa o recria.
+ */
+static inline void pool_shutdown(void) {
+    pthread_mutex_lock(&pool.run_lock);
+    if (pool.num_threads > 1) {
+        pool_publish(0);
+        for (int t = 1; t < pool.num_threads; t++) {
+            pthread_join(pool.threads[t], NULL);
+        }
+        pool.num_threads = 1;
+    }
+    pthread_mutex_unlock(&pool.run_lock);
+}
+
+#endif // POOL_UTILS_H
@@ -55,16 +55,30 @@ def main():
     files_to_process = {
         'serial.csv': ('serial_average.csv', ['Tamanho']),
         'openmp.csv': ('openmp_average.csv', ['Tamanho', 'Threads', 'Schedule']),
-        'mpi.csv': ('mpi_average.csv', ['Tamanho', 'Processos'])
+        'mpi.csv': ('mpi_average.csv', ['Tamanho', 'Processos']),
+        'mpi_distribuido.csv': ('mpi_distribuido_average.csv', ['Tamanho', 'Processos', 'Modo']),
+        'hybrid.csv': ('hybrid_average.csv', ['Tamanho', 'Processos', 'Threads', 'Schedule']),
+        'adaptativo.csv': ('adaptativo_average.csv', ['Versao', 'Tamanho', 'Workers', 'Variante']),
+        'tipos.csv': ('tipos_average.csv', ['Versao', 'Tipo', 'Payload', 'Tamanho', 'Workers']),
+        'segmentos.csv': ('segmentos_average.csv', ['Tamanho', 'Segmentos', 'MinSegmento', 'MaxSegmento', 'Threads', 'Metodo'])
     }
 
+    # As execuções com entradas não uniformes (opção --dist) ficam em um subdiretório
+    # por distribuição (ex: 'data/invertido/'), que é processado da mesma forma.
+    data_dirs = [base_data_dir] + sorted(
+        os.path.join(base_data_dir, name) for name in os.listdir(base_data_dir)
+        if os.path.isdir(os.path.join(base_data_dir, name)))
+
     # Itera sobre o dicionário de configuração para processar cada arquivo.
-    for input_name, (output_name, group_cols) in files_to_process.items():
-        input_file_path = os.path.join(base_data_dir, input_name)
-        output_file_path = os.path.join(base_data_dir, output_name)
-        
-        print(f"\nProcessando '{input_name}'...")
-        process_csv(input_file_path, output_file_path, group_cols)
+    for data_dir in data_dirs:
+        for input_name, (output_name, group_cols) in files_to_process.items():
+            input_file_path = os.path.join(data_dir, input_name)
+            output_file_path = os.path.join(data_dir, output_name)
+            if data_dir != base_data_dir and not os.path.exists(input_file_path):
+                continue
+
+            print(f"\nProcessando '{os.path.relpath(input_file_path, base_data_dir)}'...")
+            process_csv(input_file_path, output_file_path, group_cols)
 
     print("\nProcessamento de todos os arquivos concluído.")
 
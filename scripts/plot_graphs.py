@@ -48,6 +48,8 @@ def gerar_grafico_tempo_execucao():
     media_openmp_static = media_openmp[media_openmp['Schedule'] == 'static']
     media_openmp_dynamic = media_openmp[media_openmp['Schedule'] == 'dynamic']
     media_openmp_guided = media_openmp[media_openmp['Schedule'] == 'guided']
+    media_openmp_neighbor = media_openmp[media_openmp['Schedule'] == 'neighbor']
+    media_openmp_pool = media_openmp[media_openmp['Schedule'] == 'pool']
     
     print("\nDados da execução OpenMP (Média, 8 Threads):")
     print(media_openmp)
@@ -71,6 +73,8 @@ def gerar_grafico_tempo_execucao():
     plt.plot(media_openmp_static['Tamanho'], media_openmp_static['Tempo(s)'], marker='s', linestyle='--', label='OpenMP (static, 8 threads)', markersize=8, linewidth=2.5)
     plt.plot(media_openmp_dynamic['Tamanho'], media_openmp_dynamic['Tempo(s)'], marker='x', linestyle=':', label='OpenMP (dynamic, 8 threads)', markersize=8, linewidth=2.5)
     plt.plot(media_openmp_guided['Tamanho'], media_openmp_guided['Tempo(s)'], marker='d', linestyle='-.', label='OpenMP (guided, 8 threads)', markersize=8, linewidth=2.5)
+    plt.plot(media_openmp_neighbor['Tamanho'], media_openmp_neighbor['Tempo(s)'], marker='v', linestyle='--', label='OpenMP (neighbor, 8 threads)', markersize=8, linewidth=2.5)
+    plt.plot(media_openmp_pool['Tamanho'], media_openmp_pool['Tempo(s)'], marker='P', linestyle=':', label='Pool de pthreads (8 threads)', markersize=8, linewidth=2.5)
     
     plt.plot(media_mpi['Tamanho'], media_mpi['Tempo(s)'], marker='^', linestyle='-', label='MPI (8 processos)', markersize=8, linewidth=2.5)
 
@@ -130,6 +134,8 @@ def gerar_grafico_eficiencia_vs_processos():
     media_openmp_static = media_openmp[media_openmp['Schedule'] == 'static']
     media_openmp_dynamic = media_openmp[media_openmp['Schedule'] == 'dynamic']
     media_openmp_guided = media_openmp[media_openmp['Schedule'] == 'guided']
+    media_openmp_neighbor = media_openmp[media_openmp['Schedule'] == 'neighbor']
+    media_openmp_pool = media_openmp[media_openmp['Schedule'] == 'pool']
     
     print(f"\nDados de Eficiência OpenMP (Média, N={TAMANHO_ENTRADA:,}):")
     print(media_openmp)
@@ -148,6 +154,8 @@ def gerar_grafico_eficiencia_vs_processos():
     plt.plot(media_openmp_static['Threads'], media_openmp_static['Eficiencia'], marker='s', linestyle='--', label='OpenMP (static)', markersize=8, linewidth=2.5)
     plt.plot(media_openmp_dynamic['Threads'], media_openmp_dynamic['Eficiencia'], marker='x', linestyle=':', label='OpenMP (dynamic)', markersize=8, linewidth=2.5)
     plt.plot(media_openmp_guided['Threads'], media_openmp_guided['Eficiencia'], marker='d', linestyle='-.', label='OpenMP (guided)', markersize=8, linewidth=2.5)
+    plt.plot(media_openmp_neighbor['Threads'], media_openmp_neighbor['Eficiencia'], marker='v', linestyle='--', label='OpenMP (neighbor)', markersize=8, linewidth=2.5)
+    plt.plot(media_openmp_pool['Threads'], media_openmp_pool['Eficiencia'], marker='P', linestyle=':', label='Pool de pthreads', markersize=8, linewidth=2.5)
     
     plt.plot(media_mpi['Processos'], media_mpi['Eficiencia'], marker='^', linestyle='-', label='MPI', markersize=8, linewidth=2.5)
 
@@ -203,6 +211,8 @@ def gerar_grafico_speedup_vs_processos():
     media_openmp_static = media_openmp[media_openmp['Schedule'] == 'static']
     media_openmp_dynamic = media_openmp[media_openmp['Schedule'] == 'dynamic']
     media_openmp_guided = media_openmp[media_openmp['Schedule'] == 'guided']
+    media_openmp_neighbor = media_openmp[media_openmp['Schedule'] == 'neighbor']
+    media_openmp_pool = media_openmp[media_openmp['Schedule'] == 'pool']
     
     print(f"\nDados de Speedup OpenMP (Média, N={TAMANHO_ENTRADA:,}):")
     print(media_openmp)
@@ -221,6 +231,8 @@ def gerar_grafico_speedup_vs_processos():
     plt.plot(media_openmp_static['Threads'], media_openmp_static['Speedup'], marker='s', linestyle='--', label='OpenMP (static)', markersize=8, linewidth=2.5)
     plt.plot(media_openmp_dynamic['Threads'], media_openmp_dynamic['Speedup'], marker='x', linestyle=':', label='OpenMP (dynamic)', markersize=8, linewidth=2.5)
     plt.plot(media_openmp_guided['Threads'], media_openmp_guided['Speedup'], marker='d', linestyle='-.', label='OpenMP (guided)', markersize=8, linewidth=2.5)
+    plt.plot(media_openmp_neighbor['Threads'], media_openmp_neighbor['Speedup'], marker='v', linestyle='--', label='OpenMP (neighbor)', markersize=8, linewidth=2.5)
+    plt.plot(media_openmp_pool['Threads'], media_openmp_pool['Speedup'], marker='P', linestyle=':', label='Pool de pthreads', markersize=8, linewidth=2.5)
     
     plt.plot(media_mpi['Processos'], media_mpi['Speedup'], marker='^', linestyle='-', label='MPI', markersize=8, linewidth=2.5)
 
@@ -0,0 +1,547 @@
+#ifndef SIMD_UTILS_H
+#define SIMD_UTILS_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define SIMD_UTILS_X86 1
+#endif
+
+#include "counter_utils.h"
+
+/*
+ * Kernel de compare-exchange das fases do Odd-Even Transposition Sort.
+ *
+ * Uma fase compara pares disjuntos e consecutivos de elementos: (0,1), (2,3), ...
+ * nas fases pares e (1,2), (3,4), ... nas ímpares. Em vez de comparar e chamar
+ * swap() com um desvio condicional (que erra a previsão em metade dos casos com
+ * dados aleatórios), o kernel calcula min/max de cada par sem desvios, usando
+ * instruções SIMD quando disponíveis:
+ *   - AVX-512: 8 pares (16 inteiros) por instrução;
+ *   - AVX2:    4 pares (8 inteiros) por instrução;
+ *   - escalar: versão sem desvios (min/max com operador ternário, que vira cmov).
+ * A versão é escolhida em tempo de execução conforme a CPU, ou forçada pela
+ * opção --kernel dos executáveis.
+ */
+
+// Assinatura do kernel: ordena 'num_pairs' pares consecutivos a partir de 'a'
+// e retorna 1 se algum elemento mudou de posição. Com OETSORT_WITH_COUNTERS
+// (counter_utils.h) retorna o número de pares trocados.
+typedef int (*compare_exchange_fn)(int *a, int num_pairs);
+
+/**
+ * @brief Versão escalar sem desvios do compare-exchange.
+ *
+ * @param a Ponteiro para o primeiro elemento do primeiro par.
+ * @param num_pairs Número de pares consecutivos a processar.
+ * @return int Retorna 1 se houve alguma troca, 0 caso contrário (com os contadores, o
+ * número de pares trocados).
+ */
+static inline int compare_exchange_scalar(int *a, int num_pairs) {
+    int changed = 0;
+    for (int k = 0; k < num_pairs; k++) {
+        int x = a[2 * k];
+        int y = a[2 * k + 1];
+        int lo = (x < y) ? x : y;
+        int hi = (x < y) ? y : x;
+#ifdef OETSORT_WITH_COUNTERS
+        changed += (lo != x);
+#else
+        changed |= (lo != x);
+#endif
+        a[2 * k] = lo;
+        a[2 * k + 1] = hi;
+    }
+    return changed;
+}
+
+#ifdef SIMD_UTILS_X86
+/**
+ * @brief Versão AVX2 do compare-exchange: 4 pares por vetor de 256 bits.
+ *
+ * Cada vetor é comparado com uma cópia em que os vizinhos de cada par foram
+ * trocados de lugar; as posições pares recebem o mínimo e as ímpares o máximo.
+ */
+__attribute__((target("avx2")))
+static int compare_exchange_avx2(int *a, int num_pairs) {
+#ifdef OETSORT_WITH_COUNTERS
+    int swaps = 0;
+#else
+    __m256i diff = _mm256_setzero_si256();
+#endif
+    int k = 0;
+    for (; k + 4 <= num_pairs; k += 4) {
+        __m256i v = _mm256_loadu_si256((__m256i *)(a + 2 * k));
+        __m256i swapped = _mm256_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1));
+        __m256i lo = _mm256_min_epi32(v, swapped);
+        __m256i hi = _mm256_max_epi32(v, swapped);
+        __m256i r = _mm256_blend_epi32(lo, hi, 0xAA); // Lanes ímpares recebem o máximo.
+#ifdef OETSORT_WITH_COUNTERS
+        // Cada par trocado muda as duas lanes do par.
+        swaps += (8 - __builtin_popcount(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(r, v))))) / 2;
+#else
+        diff = _mm256_or_si256(diff, _mm256_xor_si256(r, v));
+#endif
+        _mm256_storeu_si256((__m256i *)(a + 2 * k), r);
+    }
+#ifdef OETSORT_WITH_COUNTERS
+    return swaps + compare_exchange_scalar(a + 2 * k, num_pairs - k);
+#else
+    int changed = !_mm256_testz_si256(diff, diff);
+    return changed | compare_exchange_scalar(a + 2 * k, num_pairs - k);
+#endif
+}
+
+/**
+ * @brief Versão AVX-512 do compare-exchange: 8 pares por vetor de 512 bits.
+ */
+__attribute__((target("avx512f")))
+static int compare_exchange_avx512(int *a, int num_pairs) {
+#ifdef OETSORT_WITH_COUNTERS
+    int swaps = 0;
+#else
+    __m512i diff = _mm512_setzero_si512();
+#endif
+    int k = 0;
+    for (; k + 8 <= num_pairs; k += 8) {
+        __m512i v = _mm512_loadu_si512((void *)(a + 2 * k));
+        __m512i swapped = _mm512_shuffle_epi32(v, _MM_PERM_CDAB);
+        __m512i lo = _mm512_min_epi32(v, swapped);
+        __m512i hi = _mm512_max_epi32(v, swapped);
+        __m512i r = _mm512_mask_blend_epi32(0xAAAA, lo, hi); // Lanes ímpares recebem o máximo.
+#ifdef OETSORT_WITH_COUNTERS
+        swaps += __builtin_popcount(_mm512_cmpneq_epi32_mask(r, v)) / 2;
+#else
+        diff = _mm512_or_si512(diff, _mm512_xor_si512(r, v));
+#endif
+        _mm512_storeu_si512((void *)(a + 2 * k), r);
+    }
+#ifdef OETSORT_WITH_COUNTERS
+    return swaps + compare_exchange_scalar(a + 2 * k, num_pairs - k);
+#else
+    int changed = _mm512_test_epi32_mask(diff, diff) != 0;
+    return changed | compare_exchange_scalar(a + 2 * k, num_pairs - k);
+#endif
+}
+#endif
+
+/*
+ * Kernels de chaves estreitas, para o modo de chaves compactadas (pack_keys).
+ *
+ * Quando o intervalo [mínimo, máximo] das chaves cabe em 8 ou 16 bits, oetsort_sort
+ * ordena cópias deslocadas (chave - mínimo) em uint8_t ou uint16_t. Cada fase move então
+ * 1 ou 2 bytes por elemento em vez de 4, e cada vetor compara 4 ou 2 vezes mais pares:
+ *   - AVX-512 (com AVX-512BW): 32 pares de uint8 ou 16 de uint16 por instrução;
+ *   - AVX2: 16 pares de uint8 ou 8 de uint16 por instrução.
+ * A troca dos vizinhos de cada par é feita por um embaralhamento de bytes, e a mistura
+ * das lanes ímpares (máximo) com as pares (mínimo), por máscara.
+ */
+
+// Assinaturas dos kernels de chaves estreitas (mesmo contrato de compare_exchange_fn).
+typedef int (*compare_exchange_u8_fn)(uint8_t *a, int num_pairs);
+typedef int (*compare_exchange_u16_fn)(uint16_t *a, int num_pairs);
+
+/**
+ * @brief Versão escalar sem desvios do compare-exchange de uint8_t.
+ */
+static inline int compare_exchange_u8_scalar(uint8_t *a, int num_pairs) {
+    int changed = 0;
+    for (int k = 0; k < num_pairs; k++) {
+        uint8_t x = a[2 * k];
+        uint8_t y = a[2 * k + 1];
+        uint8_t lo = (x < y) ? x : y;
+        uint8_t hi = (x < y) ? y : x;
+#ifdef OETSORT_WITH_COUNTERS
+        changed += (lo != x);
+#else
+        changed |= (lo != x);
+#endif
+        a[2 * k] = lo;
+        a[2 * k + 1] = hi;
+    }
+    return changed;
+}
+
+/**
+ * @brief Versão escalar sem desvios do compare-exchange de uint16_t.
+ */
+static inline int compare_exchange_u16_scalar(uint16_t *a, int num_pairs) {
+    int changed = 0;
+    for (int k = 0; k < num_pairs; k++) {
+        uint16_t x = a[2 * k];
+        uint16_t y = a[2 * k + 1];
+        uint16_t lo = (x < y) ? x : y;
+        uint16_t hi = (x < y) ? y : x;
+#ifdef OETSORT_WITH_COUNTERS
+        changed += (lo != x);
+#else
+        changed |= (lo != x);
+#endif
+        a[2 * k] = lo;
+        a[2 * k + 1] = hi;
+    }
+    return changed;
+}
+
+#ifdef SIMD_UTILS_X86
+/**
+ * @brief Versão AVX2 do compare-exchange de uint8_t: 16 pares por vetor de 256 bits.
+ */
+__attribute__((target("avx2")))
+static int compare_exchange_u8_avx2(uint8_t *a, int num_pairs) {
+    // Troca os bytes de cada par; as lanes ímpares (byte alto de cada par) recebem o máximo.
+    const __m256i swap_pairs = _mm256_set_epi8(14, 15, 12, 13, 10, 11, 8, 9, 6, 7, 4, 5, 2, 3, 0, 1,
+                                               14, 15, 12, 13, 10, 11, 8, 9, 6, 7, 4, 5, 2, 3, 0, 1);
+    const __m256i odd_lanes = _mm256_set1_epi16((short)0xFF00);
+#ifdef OETSORT_WITH_COUNTERS
+    int swaps = 0;
+#else
+    __m256i diff = _mm256_setzero_si256();
+#endif
+    int k = 0;
+    for (; k + 16 <= num_pairs; k += 16) {
+        __m256i v = _mm256_loadu_si256((__m256i *)(a + 2 * k));
+        __m256i swapped = _mm256_shuffle_epi8(v, swap_pairs);
+        __m256i lo = _mm256_min_epu8(v, swapped);
+        __m256i hi = _mm256_max_epu8(v, swapped);
+        __m256i r = _mm256_blendv_epi8(lo, hi, odd_lanes);
+#ifdef OETSORT_WITH_COUNTERS
+        swaps += (32 - __builtin_popcount((unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8(r, v)))) / 2;
+#else
+        diff = _mm256_or_si256(diff, _mm256_xor_si256(r, v));
+#endif
+        _mm256_storeu_si256((__m256i *)(a + 2 * k), r);
+    }
+#ifdef OETSORT_WITH_COUNTERS
+    return swaps + compare_exchange_u8_scalar(a + 2 * k, num_pairs - k);
+#else
+    int changed = !_mm256_testz_si256(diff, diff);
+    return changed | compare_exchange_u8_scalar(a + 2 * k, num_pairs - k);
+#endif
+}
+
+/**
+ * @brief Versão AVX2 do compare-exchange de uint16_t: 8 pares por vetor de 256 bits.
+ */
+__attribute__((target("avx2")))
+static int compare_exchange_u16_avx2(uint16_t *a, int num_pairs) {
+    const __m256i swap_pairs = _mm256_set_epi8(13, 12, 15, 14, 9, 8, 11, 10, 5, 4, 7, 6, 1, 0, 3, 2,
+                                               13, 12, 15, 14, 9, 8, 11, 10, 5, 4, 7, 6, 1, 0, 3, 2);
+#ifdef OETSORT_WITH_COUNTERS
+    int swaps = 0;
+#else
+    __m256i diff = _mm256_setzero_si256();
+#endif
+    int k = 0;
+    for (; k + 8 <= num_pairs; k += 8) {
+        __m256i v = _mm256_loadu_si256((__m256i *)(a + 2 * k));
+        __m256i swapped = _mm256_shuffle_epi8(v, swap_pairs);
+        __m256i lo = _mm256_min_epu16(v, swapped);
+        __m256i hi = _mm256_max_epu16(v, swapped);
+        __m256i r = _mm256_blend_epi16(lo, hi, 0xAA); // Lanes ímpares recebem o máximo.
+#ifdef OETSORT_WITH_COUNTERS
+        // Cada par trocado muda 4 bytes da máscara.
+        swaps += (32 - __builtin_popcount((unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi16(r, v)))) / 4;
+#else
+        diff = _mm256_or_si256(diff, _mm256_xor_si256(r, v));
+#endif
+        _mm256_storeu_si256((__m256i *)(a + 2 * k), r);
+    }
+#ifdef OETSORT_WITH_COUNTERS
+    return swaps + compare_exchange_u16_scalar(a + 2 * k, num_pairs - k);
+#else
+    int changed = !_mm256_testz_si256(diff, diff);
+    return changed | compare_exchange_u16_scalar(a + 2 * k, num_pairs - k);
+#endif
+}
+
+/**
+ * @brief Versão AVX-512BW do compare-exchange de uint8_t: 32 pares por vetor de 512 bits.
+ */
+__attribute__((target("avx512f,avx512bw")))
+static int compare_exchange_u8_avx512(uint8_t *a, int num_pairs) {
+    const __m512i swap_pairs = _mm512_broadcast_i32x4(_mm_set_epi8(14, 15, 12, 13, 10, 11, 8, 9, 6, 7, 4, 5, 2, 3, 0, 1));
+    int changed = 0;
+    int k = 0;
+    for (; k + 32 <= num_pairs; k += 32) {
+        __m512i v = _mm512_loadu_si512((void *)(a + 2 * k));
+        __m512i swapped = _mm512_shuffle_epi8(v, swap_pairs);
+        __m512i lo = _mm512_min_epu8(v, swapped);
+        __m512i hi = _mm512_max_epu8(v, swapped);
+        __m512i r = _mm512_mask_blend_epi8(0xAAAAAAAAAAAAAAAAull, lo, hi);
+#ifdef OETSORT_WITH_COUNTERS
+        changed += __builtin_popcountll(_mm512_cmpneq_epi8_mask(r, v)) / 2;
+#else
+        changed |= _mm512_cmpneq_epi8_mask(r, v) != 0;
+#endif
+        _mm512_storeu_si512((void *)(a + 2 * k), r);
+    }
+#ifdef OETSORT_WITH_COUNTERS
+    return changed + compare_exchange_u8_scalar(a + 2 * k, num_pairs - k);
+#else
+    return changed | compare_exchange_u8_scalar(a + 2 * k, num_pairs - k);
+#endif
+}
+
+/**
+ * @brief Versão AVX-512BW do compare-exchange de uint16_t: 16 pares por vetor de 512 bits.
+ */
+__attribute__((target("avx512f,avx512bw")))
+static int compare_exchange_u16_avx512(uint16_t *a, int num_pairs) {
+    const __m512i swap_pairs = _mm512_broadcast_i32x4(_mm_set_epi8(13, 12, 15, 14, 9, 8, 11, 10, 5, 4, 7, 6, 1, 0, 3, 2));
+    int changed = 0;
+    int k = 0;
+    for (; k + 16 <= num_pairs; k += 16) {
+        __m512i v = _mm512_loadu_si512((void *)(a + 2 * k));
+        __m512i swapped = _mm512_shuffle_epi8(v, swap_pairs);
+        __m512i lo = _mm512_min_epu16(v, swapped);
+        __m512i hi = _mm512_max_epu16(v, swapped);
+        __m512i r = _mm512_mask_blend_epi16(0xAAAAAAAAu, lo, hi);
+#ifdef OETSORT_WITH_COUNTERS
+        changed += __builtin_popcount(_mm512_cmpneq_epi16_mask(r, v)) / 2;
+#else
+        changed |= _mm512_cmpneq_epi16_mask(r, v) != 0;
+#endif
+        _mm512_storeu_si512((void *)(a + 2 * k), r);
+    }
+#ifdef OETSORT_WITH_COUNTERS
+    return changed + compare_exchange_u16_scalar(a + 2 * k, num_pairs - k);
+#else
+    return changed | compare_exchange_u16_scalar(a + 2 * k, num_pairs - k);
+#endif
+}
+#endif
+
+/*
+ * Kernels de lanes, para lotes de segmentos pequenos (oetsort_sort_segments).
+ *
+ * SEGMENT_LANES segmentos são ordenados ao mesmo tempo em layout transposto: a linha i
+ * de 'rows' contém o elemento i de cada segmento, um por lane. O compare-exchange do
+ * par (i, i+1) passa a ser um min/max vertical entre duas linhas inteiras, sem nenhum
+ * embaralhamento, e cada lane executa o Odd-Even Transposition Sort do seu segmento.
+ */
+
+// Segmentos ordenados juntos: um por lane de 32 bits de um vetor AVX-512 (dois vetores AVX2).
+#define SEGMENT_LANES 16
+
+// Assinatura do kernel de lanes: ordena as 'len' linhas de 'rows' (len fases completas).
+typedef void (*lanes_sort_fn)(int *rows, int len);
+
+/**
+ * @brief Versão escalar sem desvios do kernel de lanes.
+ */
+static inline void lanes_sort_scalar(int *rows, int len) {
+    for (int phase = 0; phase < len; phase++) {
+        for (int i = phase % 2; i + 1 < len; i += 2) {
+            int *a = rows + i * SEGMENT_LANES;
+            int *b = a + SEGMENT_LANES;
+            for (int l = 0; l < SEGMENT_LANES; l++) {
+                int x = a[l];
+                int y = b[l];
+                a[l] = (x < y) ? x : y;
+                b[l] = (x < y) ? y : x;
+            }
+        }
+    }
+}
+
+#ifdef SIMD_UTILS_X86
+/**
+ * @brief Versão AVX2 do kernel de lanes: cada linha ocupa dois vetores de 256 bits.
+ */
+__attribute__((target("avx2")))
+static void lanes_sort_avx2(int *rows, int len) {
+    for (int phase = 0; phase < len; phase++) {
+        for (int i = phase % 2; i + 1 < len; i += 2) {
+            int *a = rows + i * SEGMENT_LANES;
+            int *b = a + SEGMENT_LANES;
+            for (int h = 0; h < SEGMENT_LANES; h += 8) {
+                __m256i x = _mm256_loadu_si256((__m256i *)(a + h));
+                __m256i y = _mm256_loadu_si256((__m256i *)(b + h));
+                _mm256_storeu_si256((__m256i *)(a + h), _mm256_min_epi32(x, y));
+                _mm256_storeu_si256((__m256i *)(b + h), _mm256_max_epi32(x, y));
+            }
+        }
+    }
+}
+
+/**
+ * @brief Versão AVX-512 do kernel de lanes: cada linha é um vetor de 512 bits.
+ */
+__attribute__((target("avx512f")))
+static void lanes_sort_avx512(int *rows, int len) {
+    for (int phase = 0; phase < len; phase++) {
+        for (int i = phase % 2; i + 1 < len; i += 2) {
+            int *a = rows + i * SEGMENT_LANES;
+            int *b = a + SEGMENT_LANES;
+            __m512i x = _mm512_loadu_si512((void *)a);
+            __m512i y = _mm512_loadu_si512((void *)b);
+            _mm512_storeu_si512((void *)a, _mm512_min_epi32(x, y));
+            _mm512_storeu_si512((void *)b, _mm512_max_epi32(x, y));
+        }
+    }
+}
+#endif
+
+// Kernel em uso e seu nome. Resolvidos antes da main por init_compare_exchange().
+// Os kernels de lanes e de chaves estreitas acompanham o de compare-exchange (mesmo
+// conjunto de instruções; sem AVX-512BW, os de chaves estreitas do kernel avx512 são os AVX2).
+static compare_exchange_fn compare_exchange_impl = compare_exchange_scalar;
+static lanes_sort_fn lanes_sort_impl = lanes_sort_scalar;
+static compare_exchange_u8_fn compare_exchange_u8_impl = compare_exchange_u8_scalar;
+static compare_exchange_u16_fn compare_exchange_u16_impl = compare_exchange_u16_scalar;
+static const char *compare_exchange_name = "escalar";
+
+/**
+ * @brief Seleciona o kernel de compare-exchange.
+ *
+ * @param name "auto" (melhor suportado pela CPU), "avx512", "avx2" ou "escalar".
+ * @return int Retorna 1 em caso de sucesso, 0 se o nome for inválido ou a CPU não suportar o kernel.
+ */
+static inline int set_compare_exchange_kernel(const char *name) {
+#ifdef SIMD_UTILS_X86
+    int has_avx512 = __builtin_cpu_supports("avx512f");
+    int has_avx2 = __builtin_cpu_supports("avx2");
+    if (strcmp(name, "auto") == 0) {
+        name = has_avx512 ? "avx512" : (has_avx2 ? "avx2" : "escalar");
+    }
+    if (strcmp(name, "avx512") == 0 && has_avx512) {
+        compare_exchange_impl = compare_exchange_avx512;
+        lanes_sort_impl = lanes_sort_avx512;
+        int has_avx512bw = __builtin_cpu_supports("avx512bw");
+        compare_exchange_u8_impl = has_avx512bw ? compare_exchange_u8_avx512 : compare_exchange_u8_avx2;
+        compare_exchange_u16_impl = has_avx512bw ? compare_exchange_u16_avx512 : compare_exchange_u16_avx2;
+        compare_exchange_name = "avx512";
+        return 1;
+    }
+    if (strcmp(name, "avx2") == 0 && has_avx2) {
+        compare_exchange_impl = compare_exchange_avx2;
+        lanes_sort_impl = lanes_sort_avx2;
+        compare_exchange_u8_impl = compare_exchange_u8_avx2;
+        compare_exchange_u16_impl = compare_exchange_u16_avx2;
+        compare_exchange_name = "avx2";
+        return 1;
+    }
+#else
+    if (strcmp(name, "auto") == 0) name = "escalar";
+#endif
+    if (strcmp(name, "escalar") == 0) {
+        compare_exchange_impl = compare_exchange_scalar;
+        lanes_sort_impl = lanes_sort_scalar;
+        compare_exchange_u8_impl = compare_exchange_u8_scalar;
+        compare_exchange_u16_impl = compare_exchange_u16_scalar;
+        compare_exchange_name = "escalar";
+        return 1;
+    }
+    return 0;
+}
+
+// Despacho automático: escolhe o melhor kernel suportado antes da execução da main.
+__attribute__((constructor))
+static void init_compare_exchange(void) {
+    set_compare_exchange_kernel("auto");
+}
+
+/**
+ * @brief Ordena 'num_pairs' pares consecutivos a partir de 'a' com o kernel selecionado.
+ *
+ * @return int Retorna 1 se houve alguma troca, 0 caso contrário.
+ */
+static inline int compare_exchange_pairs(int *a, int num_pairs) {
+    if (num_pairs <= 0) return 0;
+#ifdef OETSORT_WITH_COUNTERS
+    int swaps = compare_exchange_impl(a, num_pairs);
+    COUNTERS_ADD_SWAPS(swaps);
+    return swaps != 0;
+#else
+    return compare_exchange_impl(a, num_pairs);
+#endif
+}
+
+/**
+ * @brief Ordena 'num_pairs' pares consecutivos de uint8_t com o kernel de chaves estreitas.
+ *
+ * @return int Retorna 1 se houve alguma troca, 0 caso contrário.
+ */
+static inline int compare_exchange_pairs_u8(uint8_t *a, int num_pairs) {
+    if (num_pairs <= 0) return 0;
+#ifdef OETSORT_WITH_COUNTERS
+    int swaps = compare_exchange_u8_impl(a, num_pairs);
+    COUNTERS_ADD_SWAPS(swaps);
+    return swaps != 0;
+#else
+    return compare_exchange_u8_impl(a, num_pairs);
+#endif
+}
+
+/**
+ * @brief Ordena 'num_pairs' pares consecutivos de uint16_t com o kernel de chaves estreitas.
+ *
+ * @return int Retorna 1 se houve alguma troca, 0 caso contrário.
+ */
+static inline int compare_exchange_pairs_u16(uint16_t *a, int num_pairs) {
+    if (num_pairs <= 0) return 0;
+#ifdef OETSORT_WITH_COUNTERS
+    int swaps = compare_exchange_u16_impl(a, num_pairs);
+    COUNTERS_ADD_SWAPS(swaps);
+    return swaps != 0;
+#else
+    return compare_exchange_u16_impl(a, num_pairs);
+#endif
+}
+
+/**
+ * @brief Executa os pares (j, j+1) de uma fase cujo índice esquerdo j está em [from, to).
+ * Nas fases pares j é par e nas ímpares j é ímpar.
+ *
+ * @param arr O array.
+ * @param n O número de elementos do array.
+ * @param phase A fase (apenas a paridade importa).
+ * @param from Primeiro índice esquerdo considerado.
+ * @param to Limite (exclusivo) dos índices esquerdos.
+ * @return int Retorna 1 se houve alguma troca, 0 caso contrário.
+ */
+static inline int phase_range_odd_even(int arr[], int n, int phase, int from, int to) {
+    if (from < 0) from = 0;
+    if (to > n - 1) to = n - 1; // O último par válido começa em n-2.
+    if ((from % 2) != (phase % 2)) from++;
+    if (from >= to) return 0;
+    return compare_exchange_pairs(arr + from, (to - from + 1) / 2);
+}
+
+/**
+ * @brief Executa uma fase completa (par ou ímpar) sobre todo o array.
+ *
+ * @return int Retorna 1 se houve alguma troca, 0 caso contrário.
+ */
+static inline int phase_odd_even(int arr[], int n, int phase) {
+    return phase_range_odd_even(arr, n, phase, 0, n);
+}
+
+// Número de pares por bloco quando uma fase é dividida entre threads (OpenMP).
+// Blocos de 64 pares (512 bytes) mantêm o kernel vetorizado e ainda dão
+// granularidade suficiente para os agendamentos dynamic e guided.
+#define PHASE_BLOCK_PAIRS 64
+
+/**
+ * @brief Número de blocos de PHASE_BLOCK_PAIRS pares que cobrem uma fase de um array de n elementos.
+ */
+static inline int phase_num_blocks(int n) {
+    return (n / 2 + PHASE_BLOCK_PAIRS - 1) / PHASE_BLOCK_PAIRS;
+}
+
+/**
+ * @brief Executa o bloco 'block' de uma fase: os pares de índice k em
+ * [block * PHASE_BLOCK_PAIRS, (block + 1) * PHASE_BLOCK_PAIRS) da fase.
+ *
+ * @return int Retorna 1 se houve alguma troca, 0 caso contrário.
+ */
+static inline int phase_block_odd_even(int arr[], int n, int phase, int block) {
+    int from = (phase % 2) + 2 * block * PHASE_BLOCK_PAIRS;
+    return phase_range_odd_even(arr, n, phase, from, from + 2 * PHASE_BLOCK_PAIRS);
+}
+
+#endif // SIMD_UTILS_H
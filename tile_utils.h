@@ -0,0 +1,62 @@
+#ifndef TILE_UTILS_H
+#define TILE_UTILS_H
+
+#include "simd_utils.h"
+
+/*
+ * Ladrilhamento temporal (tiling) das fases do Odd-Even Transposition Sort.
+ *
+ * Em vez de varrer o array inteiro a cada fase, o array é dividido em tiles de
+ * 'tile' elementos e são aplicadas 'depth' = tile/2 fases consecutivas a cada
+ * tile enquanto ele está na cache. Um par (j, j+1) da fase t depende apenas dos
+ * pares (j-1, j) e (j+1, j+2) da fase t-1, o que permite dividir cada bloco de
+ * 'depth' fases em dois passos:
+ *
+ *   1. Trapézio: em cada tile [lo, hi), a fase relativa t processa apenas os pares
+ *      com índice esquerdo em [lo + t, hi - 1 - t). Esses pares dependem somente de
+ *      pares do próprio trapézio, então os tiles são independentes entre si.
+ *   2. Triângulo de fronteira: em cada fronteira r entre dois tiles, a fase
+ *      relativa t processa os pares restantes, com índice esquerdo em [r - 1 - t, r + t).
+ *      Com depth <= tile/2, os triângulos de fronteiras distintas não se sobrepõem.
+ *
+ * As bordas do array (índices 0 e n) não têm vizinhos, então os tiles das pontas
+ * se estendem até elas. Cada par de cada fase é processado exatamente uma vez e
+ * depois de todos os pares dos quais depende, portanto o resultado é idêntico ao
+ * da execução fase a fase.
+ */
+
+/**
+ * @brief Passo 1: aplica as fases [p0, p0 + depth) aos pares do trapézio do tile [lo, hi).
+ *
+ * @param arr O array.
+ * @param n O número de elementos do array.
+ * @param lo Início do tile (inclusivo).
+ * @param hi Fim do tile (exclusivo).
+ * @param p0 Primeira fase do bloco.
+ * @param depth Número de fases do bloco (no máximo metade do tamanho do tile).
+ */
+static inline void tile_trapezoid(int arr[], int n, int lo, int hi, int p0, int depth) {
+    for (int t = 0; t < depth; t++) {
+        int from = (lo == 0) ? 0 : lo + t;
+        int to = (hi == n) ? n : hi - 1 - t;
+        phase_range_odd_even(arr, n, p0 + t, from, to);
+    }
+}
+
+/**
+ * @brief Passo 2: aplica as fases [p0, p0 + depth) aos pares do triângulo da fronteira r.
+ * Deve ser chamado depois do trapézio dos dois tiles vizinhos à fronteira.
+ *
+ * @param arr O array.
+ * @param n O número de elementos do array.
+ * @param r Índice da fronteira (primeiro elemento do tile da direita).
+ * @param p0 Primeira fase do bloco.
+ * @param depth Número de fases do bloco.
+ */
+static inline void tile_boundary(int arr[], int n, int r, int p0, int depth) {
+    for (int t = 0; t < depth; t++) {
+        phase_range_odd_even(arr, n, p0 + t, r - 1 - t, r + t);
+    }
+}
+
+#endif // TILE_UTILS_H
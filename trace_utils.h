@@ -0,0 +1,241 @@
+#ifndef TRACE_UTILS_H
+#define TRACE_UTILS_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "pool_utils.h"
+
+/*
+ * Rastro por fase das ordenações (oetsort_trace_start / oetsort_trace_stop).
+ *
+ * Com o rastro ligado, os backends registram, nas fases amostradas, o intervalo de
+ * cada etapa da fase em cada thread: computação ("fase"), espera em barreira, pelas
+ * vizinhas ou na redução da parada antecipada ("espera") e troca de fronteira com o
+ * processo vizinho ("troca"). Cada chamada de oetsort_sort registra também um evento
+ * com a ordenação inteira. No fim, os eventos de todas as threads (e, no MPI, de todos
+ * os processos) viram um arquivo JSON no formato de eventos do Chrome, aberto em
+ * chrome://tracing ou em ui.perfetto.dev, com um processo por rank e uma linha por
+ * thread.
+ *
+ * Cada thread escreve apenas no seu próprio buffer circular (sem travas nem
+ * atômicos); com o buffer cheio, os eventos mais antigos são sobrescritos e contados
+ * como descartados. O custo é limitado pela amostragem: só uma fase a cada
+ * 'trace_every' é registrada (com 0, o intervalo é escolhido a cada ordenação para
+ * amostrar cerca de TRACE_AUTO_PHASES fases), e nas demais fases resta apenas o teste
+ * de trace_begin. Com o rastro desligado, esse teste é o único custo.
+ *
+ * Os tempos vêm de CLOCK_MONOTONIC, comum a todos os processos de uma mesma máquina;
+ * com processos em máquinas diferentes, as linhas de processos distintos podem ficar
+ * deslocadas entre si.
+ */
+
+#define TRACE_MAX_THREADS 256
+#define TRACE_DEFAULT_CAPACITY 65536 // Eventos por thread.
+#define TRACE_AUTO_PHASES 1000       // Fases amostradas por ordenação com intervalo automático.
+
+// Tipos de evento.
+enum {
+    TRACE_COMPUTE,     // Computação de uma fase (ou de um bloco de fases).
+    TRACE_WAIT,        // Espera em barreira, pelas vizinhas ou em uma redução.
+    TRACE_EXCHANGE,    // Troca com o processo vizinho (inclui a espera por ele).
+    TRACE_LOCAL_SORT,  // Ordenação local inicial do modo MPI 'blocos'.
+    TRACE_SORT,        // Uma chamada de oetsort_sort inteira ('phase' é o backend).
+    TRACE_NUM_TYPES
+};
+
+typedef struct {
+    double start;
+    double end;
+    int phase;   // Primeira fase do evento.
+    int phases;  // Fases cobertas (blocos de fases do ladrilhamento, pares da versão adaptativa).
+    int type;
+    int tid;     // Thread que registrou o evento.
+} trace_event;
+
+typedef struct {
+    trace_event *events;  // Alocado pela própria thread no primeiro evento.
+    long long count;      // Eventos já registrados (a posição é count % capacity).
+} __attribute__((aligned(64))) trace_ring;
+
+static trace_ring trace_rings[TRACE_MAX_THREADS];
+static int trace_active = 0;
+static int trace_requested_every = 0;  // Intervalo pedido (0 = automático).
+static int trace_every = 0;            // Intervalo da ordenação em curso (0 = desligado).
+static int trace_capacity = TRACE_DEFAULT_CAPACITY;
+
+// Trecho em andamento de uma fase amostrada; start < 0 se a fase não é amostrada.
+typedef struct {
+    int phase;
+    int phases;
+    double start;
+} trace_span;
+
+static inline double trace_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/**
+ * @brief Define o intervalo de amostragem de uma ordenação com 'total_phases' fases.
+ */
+static inline void trace_set_phases(int total_phases) {
+    if (!trace_active) {
+        trace_every = 0;
+        return;
+    }
+    trace_every = trace_requested_every;
+    if (trace_every == 0) {
+        trace_every = (total_phases + TRACE_AUTO_PHASES - 1) / TRACE_AUTO_PHASES;
+        if (trace_every < 1) trace_every = 1;
+    }
+}
+
+/**
+ * @brief Anexa um evento ao buffer da thread chamadora.
+ */
+static inline void trace_record(int type, int phase, int phases, double start, double end) {
+    int t = pool_thread_num();
+    if (t >= TRACE_MAX_THREADS) return;
+    trace_ring *r = &trace_rings[t];
+    if (r->events == NULL) {
+        r->events = malloc((size_t)trace_capacity * sizeof(trace_event));
+        if (r->events == NULL) return;
+    }
+    trace_event *e = &r->events[r->count % trace_capacity];
+    e->start = start;
+    e->end = end;
+    e->phase = phase;
+    e->phases = phases;
+    e->type = type;
+    e->tid = t;
+    r->count++;
+}
+
+/**
+ * @brief Abre um trecho para as fases [phase, phase + phases); ele é amostrado se o
+ * intervalo contém um múltiplo de trace_every.
+ */
+static inline trace_span trace_begin_range(int phase, int phases) {
+    trace_span s = {phase, phases, -1.0};
+    if (trace_every > 0) {
+        int next = (phase + trace_every - 1) / trace_every * trace_every;
+        if (next < phase + phases) s.start = trace_now();
+    }
+    return s;
+}
+
+static inline trace_span trace_begin(int phase) {
+    return trace_begin_range(phase, 1);
+}
+
+/**
+ * @brief Registra a etapa 'type' do início do trecho até agora e recomeça o trecho,
+ * para que as etapas seguintes da mesma fase fiquem encadeadas.
+ */
+static inline void trace_step(trace_span *s, int type) {
+    if (s->start < 0) return;
+    double now = trace_now();
+    trace_record(type, s->phase, s->phases, s->start, now);
+    s->start = now;
+}
+
+/**
+ * @brief Liga o rastro, descartando eventos de um rastro anterior.
+ */
+static inline void trace_start(int every, int capacity) {
+    for (int t = 0; t < TRACE_MAX_THREADS; t++) {
+        free(trace_rings[t].events);
+        trace_rings[t].events = NULL;
+        trace_rings[t].count = 0;
+    }
+    trace_requested_every = every;
+    trace_capacity = (capacity > 0) ? capacity : TRACE_DEFAULT_CAPACITY;
+    trace_every = 0;
+    trace_active = 1;
+}
+
+/**
+ * @brief Desliga o rastro e copia os eventos de todas as threads, de cada thread do
+ * mais antigo para o mais recente, para um único array (liberado pelo chamador). Os
+ * buffers são liberados.
+ *
+ * @param dropped Recebe o número de eventos sobrescritos nos buffers cheios.
+ * @return long long O número de eventos em '*out'.
+ */
+static inline long long trace_collect(trace_event **out, long long *dropped) {
+    long long total = 0;
+    *dropped = 0;
+    for (int t = 0; t < TRACE_MAX_THREADS; t++) {
+        long long c = trace_rings[t].count;
+        total += (c < trace_capacity) ? c : trace_capacity;
+        if (c > trace_capacity) *dropped += c - trace_capacity;
+    }
+    trace_event *events = malloc((size_t)(total > 0 ? total : 1) * sizeof(trace_event));
+    long long k = 0;
+    for (int t = 0; t < TRACE_MAX_THREADS; t++) {
+        trace_ring *r = &trace_rings[t];
+        long long first = (r->count > trace_capacity) ? r->count - trace_capacity : 0;
+        for (long long i = first; i < r->count; i++) {
+            events[k++] = r->events[i % trace_capacity];
+        }
+        free(r->events);
+        r->events = NULL;
+        r->count = 0;
+    }
+    trace_active = 0;
+    trace_every = 0;
+    *out = events;
+    return total;
+}
+
+/**
+ * @brief Grava eventos no formato JSON de eventos do Chrome.
+ *
+ * @param events Os eventos; 'procs[i]' é o processo (pid) de 'events[i]'.
+ * @param backend_names Nome de cada backend, para os eventos TRACE_SORT.
+ * @param dropped Eventos descartados em todos os processos.
+ */
+static inline void trace_write_json(FILE *fp, const trace_event events[], const int procs[], long long count, int num_procs,
+                                    const char *const backend_names[], long long dropped) {
+    static const char *names[TRACE_NUM_TYPES] = {"fase", "espera", "troca", "ordenacao local", NULL};
+    static const char *categories[TRACE_NUM_TYPES] = {"computacao", "espera", "comunicacao", "computacao", "ordenacao"};
+
+    // Tempos em microssegundos a partir do primeiro evento.
+    double origin = 0.0;
+    for (long long i = 0; i < count; i++) {
+        if (i == 0 || events[i].start < origin) origin = events[i].start;
+    }
+
+    fprintf(fp, "{\"displayTimeUnit\": \"ns\", \"metadata\": {\"eventos_descartados\": %lld}, \"traceEvents\": [", dropped);
+    int first = 1;
+    for (int p = 0; p < num_procs; p++) {
+        fprintf(fp, "%s\n{\"name\": \"process_name\", \"ph\": \"M\", \"pid\": %d, \"args\": {\"name\": \"processo %d\"}}", first ? "" : ",", p, p);
+        first = 0;
+    }
+    // Nome de cada linha (processo, thread). Os eventos de uma mesma thread de um mesmo
+    // processo são consecutivos (trace_collect), então basta comparar com o anterior.
+    for (long long i = 0; i < count; i++) {
+        if (i > 0 && procs[i - 1] == procs[i] && events[i - 1].tid == events[i].tid) continue;
+        fprintf(fp, ",\n{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": %d, \"tid\": %d, \"args\": {\"name\": \"thread %d\"}}",
+                procs[i], events[i].tid, events[i].tid);
+    }
+    for (long long i = 0; i < count; i++) {
+        const trace_event *e = &events[i];
+        double ts = (e->start - origin) * 1e6;
+        double dur = (e->end - e->start) * 1e6;
+        if (e->type == TRACE_SORT) {
+            fprintf(fp, ",\n{\"name\": \"%s\", \"cat\": \"%s\", \"ph\": \"X\", \"ts\": %.3f, \"dur\": %.3f, \"pid\": %d, \"tid\": %d}",
+                    backend_names[e->phase], categories[e->type], ts, dur, procs[i], e->tid);
+        } else {
+            fprintf(fp, ",\n{\"name\": \"%s\", \"cat\": \"%s\", \"ph\": \"X\", \"ts\": %.3f, \"dur\": %.3f, \"pid\": %d, \"tid\": %d, "
+                        "\"args\": {\"fase\": %d, \"fases\": %d}}",
+                    names[e->type], categories[e->type], ts, dur, procs[i], e->tid, e->phase, e->phases);
+        }
+    }
+    fprintf(fp, "\n]}\n");
+}
+
+#endif // TRACE_UTILS_H
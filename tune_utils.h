@@ -0,0 +1,233 @@
+#ifndef TUNE_UTILS_H
+#define TUNE_UTILS_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <omp.h>
+#include "csv_utils.h"
+#include "oetsort.h"
+
+/*
+ * Autoajuste da versão OpenMP (--autoajuste).
+ *
+ * A melhor configuração depende da máquina e do tamanho: com poucos elementos por
+ * thread, o custo das barreiras domina e um schedule ruim (dynamic com pedaços de um
+ * bloco) fica mais lento que a versão serial. A busca mede, sobre a própria entrada,
+ * cada combinação de número de threads (potências de 2 até o máximo pedido), backend
+ * (static, dynamic, guided, neighbor, pool de pthreads e tiled, ou serial com uma
+ * thread), tamanho do pedaço do schedule e tamanho do tile, e fica com a mais rápida
+ * que ordenou corretamente.
+ *
+ * O vencedor é gravado em um cache em disco (TUNE_CACHE_PATH), com uma linha por
+ * chave: modelo da CPU, número de CPUs, faixa de tamanho (floor(log2(n))) e máximo de
+ * threads da busca. Execuções seguintes com a mesma chave usam a configuração do cache
+ * sem nenhuma busca. Se houver mais de uma linha para a mesma chave, vale a última.
+ */
+
+#define TUNE_CACHE_PATH "data/autoajuste.csv"
+#define TUNE_MODEL_LEN 128
+#define TUNE_MAX_CANDIDATES 512
+
+typedef struct {
+    char cpu[TUNE_MODEL_LEN]; // Modelo da CPU (/proc/cpuinfo), sem vírgulas.
+    int cores;                // CPUs disponíveis para o processo.
+    int bucket;               // Faixa de tamanho: n em [2^bucket, 2^(bucket+1)).
+    int max_threads;          // Maior número de threads considerado na busca.
+} tune_key;
+
+typedef struct {
+    oetsort_backend backend;
+    int num_threads;
+    int chunk;    // Blocos de fase por pedaço do schedule (0 = padrão).
+    int tile;     // Backends com ladrilhamento.
+    double time;  // Tempo medido na busca.
+} tune_config;
+
+// Tamanhos de pedaço e de tile testados.
+static const int tune_chunks[] = {0, 1, 4, 16, 64};
+static const int tune_tiles[] = {1024, 4096, 16384};
+
+/**
+ * @brief Preenche a chave do cache para um array de 'n' elementos nesta máquina.
+ */
+static inline void tune_key_init(tune_key *key, int n, int max_threads) {
+    strcpy(key->cpu, "desconhecido");
+    FILE *fp = fopen("/proc/cpuinfo", "r");
+    if (fp != NULL) {
+        char line[512];
+        while (fgets(line, sizeof(line), fp) != NULL) {
+            if (strncmp(line, "model name", 10) != 0) continue;
+            const char *value = strchr(line, ':');
+            if (value == NULL) break;
+            value++;
+            while (*value == ' ') value++;
+            snprintf(key->cpu, sizeof(key->cpu), "%s", value);
+            key->cpu[strcspn(key->cpu, "\n")] = '\0';
+            break;
+        }
+        fclose(fp);
+    }
+    // As vírgulas separariam colunas no CSV.
+    for (char *c = key->cpu; *c; c++) {
+        if (*c == ',') *c = ' ';
+    }
+    key->cores = omp_get_num_procs();
+    key->bucket = 0;
+    while (key->bucket < 30 && (1 << (key->bucket + 1)) <= n) key->bucket++;
+    key->max_threads = max_threads;
+}
+
+/**
+ * @brief Descreve a configuração em uma linha ("openmp-dynamic, 4 threads, chunk 16").
+ */
+static inline void tune_describe(const tune_config *cfg, char *out, size_t size) {
+    int len = snprintf(out, size, "%s, %d thread%s", oetsort_backend_name(cfg->backend), cfg->num_threads, cfg->num_threads > 1 ? "s" : "");
+    if (cfg->chunk > 0) len += snprintf(out + len, size - len, ", chunk %d", cfg->chunk);
+    if (cfg->tile > 0) snprintf(out + len, size - len, ", tile %d", cfg->tile);
+}
+
+/**
+ * @brief Procura a chave no cache.
+ *
+ * @return int 1 se encontrou (a configuração vai para 'cfg'), 0 caso contrário.
+ */
+static inline int tune_cache_lookup(const char *path, const tune_key *key, tune_config *cfg) {
+    FILE *fp = fopen(path, "r");
+    if (fp == NULL) return 0;
+    char line[512];
+    int found = 0;
+    while (fgets(line, sizeof(line), fp) != NULL) {
+        char cpu[TUNE_MODEL_LEN], backend[32];
+        int cores, bucket, max_threads;
+        tune_config c;
+        // CPU,Nucleos,FaixaTamanho,MaxThreads,Backend,Threads,Chunk,Tile,Tempo(s)
+        if (sscanf(line, "%127[^,],%d,%d,%d,%31[^,],%d,%d,%d,%lf", cpu, &cores, &bucket, &max_threads,
+                   backend, &c.num_threads, &c.chunk, &c.tile, &c.time) != 9) {
+            continue; // Cabeçalho ou linha inválida.
+        }
+        if (strcmp(cpu, key->cpu) != 0 || cores != key->cores || bucket != key->bucket || max_threads != key->max_threads) continue;
+        for (int b = 0; b < OETSORT_NUM_BACKENDS; b++) {
+            if (strcmp(backend, oetsort_backend_name((oetsort_backend)b)) == 0 && oetsort_backend_available((oetsort_backend)b)) {
+                c.backend = (oetsort_backend)b;
+                *cfg = c;
+                found = 1;
+            }
+        }
+    }
+    fclose(fp);
+    return found;
+}
+
+/**
+ * @brief Anexa o vencedor de uma busca ao cache.
+ */
+static inline void tune_cache_store(const char *path, const tune_key *key, const tune_config *cfg) {
+    ensure_dir_exists(path);
+    int needs_header = !file_exists(path);
+    FILE *fp = fopen(path, "a");
+    if (fp == NULL) {
+        perror("Falha ao abrir o cache de autoajuste");
+        return;
+    }
+    if (needs_header) {
+        fprintf(fp, "CPU,Nucleos,FaixaTamanho,MaxThreads,Backend,Threads,Chunk,Tile,Tempo(s)\n");
+    }
+    fprintf(fp, "%s,%d,%d,%d,%s,%d,%d,%d,%.6f\n", key->cpu, key->cores, key->bucket, key->max_threads,
+            oetsort_backend_name(cfg->backend), cfg->num_threads, cfg->chunk, cfg->tile, cfg->time);
+    fclose(fp);
+}
+
+/**
+ * @brief Lista as configurações a testar para 'n' elementos e até 'max_threads' threads.
+ *
+ * Com uma thread são testados apenas os backends seriais (o vencedor nunca é pior que a
+ * versão serial). Pedaços maiores que o número de blocos de uma fase e tiles maiores
+ * que o array são descartados.
+ *
+ * @return int O número de configurações em 'out'.
+ */
+static inline int tune_candidates(int n, int max_threads, tune_config out[]) {
+    int count = 0;
+    if (max_threads < 1) max_threads = 1;
+    int num_blocks = (n / 2 + 63) / 64; // Blocos de 64 pares por fase (PHASE_BLOCK_PAIRS).
+    int num_chunks = (int)(sizeof(tune_chunks) / sizeof(tune_chunks[0]));
+    int num_tiles = (int)(sizeof(tune_tiles) / sizeof(tune_tiles[0]));
+    for (int t = 1; ; t *= 2) {
+        if (t > max_threads) t = max_threads; // O máximo pedido é sempre testado.
+        oetsort_backend tiled = (t == 1) ? OETSORT_SERIAL_TILED : OETSORT_OPENMP_TILED;
+        if (t == 1) {
+            out[count++] = (tune_config){OETSORT_SERIAL, 1, 0, 0, 0.0};
+        } else {
+            static const oetsort_backend scheduled[] = {OETSORT_OPENMP_STATIC, OETSORT_OPENMP_DYNAMIC, OETSORT_OPENMP_GUIDED};
+            for (int s = 0; s < 3; s++) {
+                for (int c = 0; c < num_chunks; c++) {
+                    // Para dynamic e guided o pedaço padrão já é 1.
+                    if (tune_chunks[c] > num_blocks || (s > 0 && tune_chunks[c] == 1)) continue;
+                    if (count < TUNE_MAX_CANDIDATES) out[count++] = (tune_config){scheduled[s], t, tune_chunks[c], 0, 0.0};
+                }
+            }
+            if (count < TUNE_MAX_CANDIDATES) out[count++] = (tune_config){OETSORT_OPENMP_NEIGHBOR, t, 0, 0, 0.0};
+            if (count < TUNE_MAX_CANDIDATES) out[count++] = (tune_config){OETSORT_PTHREAD_POOL, t, 0, 0, 0.0};
+        }
+        for (int k = 0; k < num_tiles; k++) {
+            if (tune_tiles[k] <= n && count < TUNE_MAX_CANDIDATES) out[count++] = (tune_config){tiled, t, 0, tune_tiles[k], 0.0};
+        }
+        if (t == max_threads) break;
+    }
+    return count;
+}
+
+/**
+ * @brief Opções da biblioteca correspondentes à configuração.
+ */
+static inline void tune_options(const tune_config *cfg, oetsort_options *opts) {
+    oetsort_default_options(opts);
+    opts->backend = cfg->backend;
+    opts->num_threads = cfg->num_threads;
+    opts->chunk = cfg->chunk;
+    opts->tile = cfg->tile;
+}
+
+/**
+ * @brief Ordena 'work' (cópia de 'base') com a configuração e mede o tempo.
+ *
+ * @return int 1 se o resultado estiver ordenado e com os mesmos elementos da entrada.
+ */
+static inline int tune_run(const tune_config *cfg, const int base[], int work[], int n, const oetsort_fingerprint *expected, double *time_taken) {
+    oetsort_options opts;
+    tune_options(cfg, &opts);
+    memcpy(work, base, (size_t)n * sizeof(int));
+    double start = omp_get_wtime();
+    int err = oetsort_sort(work, n, &opts, NULL);
+    *time_taken = omp_get_wtime() - start;
+    oetsort_verification v;
+    oetsort_verify(work, n, OETSORT_INT32, cfg->num_threads, 0, expected, &v);
+    return err == OETSORT_OK && v.sorted && v.same_keys;
+}
+
+/**
+ * @brief Mede todas as configurações de tune_candidates sobre 'base', imprimindo cada
+ * uma, e devolve em 'best' a mais rápida com resultado correto.
+ *
+ * @return int 1 se alguma configuração ordenou corretamente.
+ */
+static inline int tune_search(const int base[], int work[], int n, int max_threads, const oetsort_fingerprint *expected, tune_config *best) {
+    tune_config *candidates = malloc(TUNE_MAX_CANDIDATES * sizeof(tune_config));
+    int count = tune_candidates(n, max_threads, candidates);
+    int found = 0;
+    char label[96];
+    for (int i = 0; i < count; i++) {
+        int ok = tune_run(&candidates[i], base, work, n, expected, &candidates[i].time);
+        tune_describe(&candidates[i], label, sizeof(label));
+        printf("  %-45s %.6f s%s\n", label, candidates[i].time, ok ? "" : " (resultado incorreto, descartado)");
+        if (ok && (!found || candidates[i].time < best->time)) {
+            *best = candidates[i];
+            found = 1;
+        }
+    }
+    free(candidates);
+    return found;
+}
+
+#endif // TUNE_UTILS_H
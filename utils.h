@@ -3,7 +3,9 @@
 
 #include <stdio.h>
 #include <stdlib.h>
-#include <time.h>
+#include <string.h>
+#include <stdint.h>
+#include "oetsort.h" // Para oetsort_input em read_input_options
 
 /**
  * @brief Imprime os elementos de um array de inteiros.
@@ -18,22 +20,6 @@ void print_array(int arr[], int n) {
     printf("\n");
 }
 
-/**
- * @brief Preenche um array com números inteiros aleatórios.
- * 
- * @param arr O array a ser preenchido.
- * @param n O número de elementos no array.
- * @param max_val O valor máximo (exclusive) para os números aleatórios.
- */
-void generate_random_array(int arr[], int n, int max_val) {
-    // Usa o tempo atual como semente para o gerador de números aleatórios,
-    // garantindo que os números sejam diferentes a cada execução.
-    srand(time(NULL)); 
-    for (int i = 0; i < n; i++) {
-        arr[i] = rand() % max_val;
-    }
-}
-
 /**
  * @brief Verifica se um array de inteiros está ordenado em ordem crescente.
  * 
@@ -50,4 +36,189 @@ int is_sorted(int arr[], int n) {
     return 1; // Nenhum par fora de ordem foi encontrado.
 }
 
+/**
+ * @brief Verifica um resultado com oetsort_verify (ordem e impressão digital da entrada,
+ * em paralelo) e imprime as duas linhas da verificação.
+ *
+ * @param indent Prefixo das linhas impressas (ex: "  ").
+ * @param arr O array ordenado.
+ * @param n O número de elementos no array.
+ * @param expected Impressão digital da entrada, calculada antes da ordenação.
+ * @return int Retorna 1 se o array estiver ordenado e for uma permutação da entrada.
+ */
+int report_verification(const char *indent, const int arr[], int n, const oetsort_fingerprint *expected) {
+    oetsort_verification v;
+    oetsort_verify(arr, n, OETSORT_INT32, 0, 0, expected, &v);
+    printf("%sArray está ordenado: %s\n", indent, v.sorted ? "Sim" : "Não");
+    printf("%sMesmos elementos da entrada: %s\n", indent, v.same_keys ? "Sim" : "Não");
+    return v.sorted && v.same_keys;
+}
+
+/**
+ * @brief Verifica chaves de qualquer tipo com oetsort_verify: ordenadas e com a
+ * impressão digital da entrada.
+ *
+ * @return int Retorna 1 se as chaves estiverem ordenadas e forem uma permutação da entrada.
+ */
+int verify_keys(const void *keys, int n, oetsort_key_type type, const oetsort_fingerprint *expected) {
+    oetsort_verification v;
+    oetsort_verify(keys, n, type, 0, 0, expected, &v);
+    return v.sorted && v.same_keys;
+}
+
+/**
+ * @brief Função de comparação de inteiros no formato exigido pelo qsort.
+ * 
+ * @param a Ponteiro para o primeiro inteiro.
+ * @param b Ponteiro para o segundo inteiro.
+ * @return int Negativo, zero ou positivo conforme a for menor, igual ou maior que b.
+ */
+int compare_ints(const void *a, const void *b) {
+    int x = *(const int *)a;
+    int y = *(const int *)b;
+    return (x > y) - (x < y); // Evita o overflow de 'x - y'.
+}
+
+/**
+ * @brief Conta os argumentos posicionais da linha de comando (os que não começam com "--").
+ * 
+ * @param argc Número de argumentos recebido pela main.
+ * @param argv Vetor de argumentos recebido pela main.
+ * @return int O número de argumentos posicionais, incluindo o nome do programa.
+ */
+int count_positional_args(int argc, char *argv[]) {
+    int count = 0;
+    for (int i = 0; i < argc; i++) {
+        if (strncmp(argv[i], "--", 2) != 0) count++;
+    }
+    return count;
+}
+
+/**
+ * @brief Procura uma opção no formato --nome=valor entre os argumentos da linha de comando.
+ * 
+ * @param argc Número de argumentos recebido pela main.
+ * @param argv Vetor de argumentos recebido pela main.
+ * @param name O nome da opção, sem o prefixo "--" (ex: "modo").
+ * @param default_val Valor devolvido quando a opção não foi informada.
+ * @return const char* O valor da opção, ou 'default_val' se ela não estiver presente.
+ */
+const char *get_option(int argc, char *argv[], const char *name, const char *default_val) {
+    size_t len = strlen(name);
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--", 2) == 0 && strncmp(argv[i] + 2, name, len) == 0 && argv[i][2 + len] == '=') {
+            return argv[i] + 3 + len;
+        }
+    }
+    return default_val;
+}
+
+/**
+ * @brief Verifica se uma opção sem valor (ex: --adaptativo) foi passada na linha de comando.
+ * 
+ * @param argc Número de argumentos recebido pela main.
+ * @param argv Vetor de argumentos recebido pela main.
+ * @param name O nome da opção, sem o prefixo "--".
+ * @return int Retorna 1 se a opção estiver presente, 0 caso contrário.
+ */
+int has_flag(int argc, char *argv[], const char *name) {
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--", 2) == 0 && strcmp(argv[i] + 2, name) == 0) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Lê as opções de geração da entrada: --dist=nome (ver oetsort_distribution_from_name),
+ * --semente=S, --deslocamentos=K (quase-ordenado), --unicos=U (poucos-unicos) e
+ * --zipf=s (expoente da distribuição de Zipf). As opções ausentes mantêm os valores de
+ * oetsort_default_input.
+ * 
+ * @param argc Número de argumentos recebido pela main.
+ * @param argv Vetor de argumentos recebido pela main.
+ * @param input A descrição da entrada a preencher.
+ * @return int Retorna 1 se as opções forem válidas, 0 caso contrário.
+ */
+int read_input_options(int argc, char *argv[], oetsort_input *input) {
+    oetsort_default_input(input);
+    if (oetsort_distribution_from_name(get_option(argc, argv, "dist", "uniforme"), &input->dist) != OETSORT_OK) return 0;
+    input->seed = strtoull(get_option(argc, argv, "semente", "1"), NULL, 10);
+    input->displacements = atoll(get_option(argc, argv, "deslocamentos", "0"));
+    input->unique = atoi(get_option(argc, argv, "unicos", "16"));
+    input->zipf_s = atof(get_option(argc, argv, "zipf", "1.0"));
+    return input->displacements >= 0 && input->unique >= 1 && input->zipf_s > 0.0;
+}
+
+/**
+ * @brief Monta o caminho do CSV de resultados: "data/<arquivo>" para a entrada uniforme
+ * (a dos experimentos) e "data/<distribuição>/<arquivo>" para as demais, para que
+ * entradas diferentes não se misturem nas médias.
+ * 
+ * @param file O nome do arquivo CSV (ex: "serial.csv").
+ * @param input A descrição da entrada gerada.
+ * @return const char* O caminho, válido até a próxima chamada.
+ */
+const char *results_path(const char *file, const oetsort_input *input) {
+    static char path[256];
+    if (input->dist == OETSORT_DIST_UNIFORM) {
+        snprintf(path, sizeof(path), "data/%s", file);
+    } else {
+        snprintf(path, sizeof(path), "data/%s/%s", oetsort_distribution_name(input->dist), file);
+    }
+    return path;
+}
+
+/**
+ * @brief Inicializa os índices dos registros com 0, 1, ..., n-1.
+ * 
+ * @param idx O array de índices.
+ * @param n O número de registros.
+ */
+void init_record_indices(uint32_t idx[], int n) {
+    for (int i = 0; i < n; i++) idx[i] = (uint32_t)i;
+}
+
+/**
+ * @brief Preenche o payload de cada registro. Os primeiros bytes guardam o índice
+ * original do registro (usado em verify_records) e o restante é preenchido com um padrão.
+ * 
+ * @param payload Array de n registros de 'payload_bytes' bytes (payload_bytes >= 4).
+ * @param n O número de registros.
+ * @param payload_bytes Bytes de payload por registro.
+ */
+void fill_payload(void *payload, int n, size_t payload_bytes) {
+    for (int i = 0; i < n; i++) {
+        unsigned char *p = (unsigned char *)payload + (size_t)i * payload_bytes;
+        uint32_t id = (uint32_t)i;
+        memcpy(p, &id, sizeof(id));
+        memset(p + sizeof(id), i & 0xFF, payload_bytes - sizeof(id));
+    }
+}
+
+/**
+ * @brief Verifica se cada registro ordenado carrega a chave e o payload do registro original.
+ * 
+ * @param keys Chaves ordenadas.
+ * @param original_keys Chaves na ordem original.
+ * @param key_size Tamanho de cada chave em bytes.
+ * @param payload Payloads já permutados para a ordem final.
+ * @param idx Índices originais dos registros ordenados.
+ * @param n O número de registros.
+ * @param payload_bytes Bytes de payload por registro.
+ * @return int Retorna 1 se todos os registros estiverem íntegros, 0 caso contrário.
+ */
+int verify_records(const void *keys, const void *original_keys, size_t key_size,
+                   const void *payload, const uint32_t idx[], int n, size_t payload_bytes) {
+    for (int i = 0; i < n; i++) {
+        uint32_t id;
+        memcpy(&id, (const unsigned char *)payload + (size_t)i * payload_bytes, sizeof(id));
+        if (id != idx[i]) return 0;
+        if (memcmp((const unsigned char *)keys + (size_t)i * key_size,
+                   (const unsigned char *)original_keys + (size_t)id * key_size, key_size) != 0) return 0;
+    }
+    return 1;
+}
+
 #endif // UTILS_H
\ No newline at end of file